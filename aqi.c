@@ -18,10 +18,16 @@
  */
 
 #include "aqi.h"
+#include <limits.h>
 #include <math.h>
 #include <stddef.h>
 
+#ifdef AQI_THREADS
+#include <unistd.h>
+#endif
+
 #ifndef AQI_EXTERN_TXT
+AQI_DATA
 const char *AUSTRALIA_AQI_TXT[6] =
 {
   "Very Good",
@@ -31,6 +37,7 @@ const char *AUSTRALIA_AQI_TXT[6] =
   "Very Poor",
   "Hazardous",
 };
+AQI_DATA
 const char *CANADA_AQHI_TXT[4] =
 {
   "Low",
@@ -38,6 +45,7 @@ const char *CANADA_AQHI_TXT[4] =
   "High",
   "Very High",
 };
+AQI_DATA
 const char *CHINA_AQI_TXT[6] =
 {
   "Excellent",
@@ -47,6 +55,7 @@ const char *CHINA_AQI_TXT[6] =
   "Heavily Polluted",
   "Severely Polluted",
 };
+AQI_DATA
 const char *EUROPEAN_UNION_CAQI_TXT[5] =
 {
   "Very Low",
@@ -55,6 +64,7 @@ const char *EUROPEAN_UNION_CAQI_TXT[5] =
   "High",
   "Very High",
 };
+AQI_DATA
 const char *HONG_KONG_AQHI_TXT[5] =
 {
   "Low",
@@ -63,6 +73,7 @@ const char *HONG_KONG_AQHI_TXT[5] =
   "Very High",
   "Hazardous",
 };
+AQI_DATA
 const char *INDIA_AQI_TXT[6] =
 {
   "Good",
@@ -72,6 +83,7 @@ const char *INDIA_AQI_TXT[6] =
   "Very Poor",
   "Severe",
 };
+AQI_DATA
 const char *SINGAPORE_PSI_TXT[5] =
 {
   "Good",
@@ -80,6 +92,7 @@ const char *SINGAPORE_PSI_TXT[5] =
   "Very Unhealthy",
   "Hazardous",
 };
+AQI_DATA
 const char *SOUTH_KOREA_CAI_TXT[4] =
 {
   "Good",
@@ -87,6 +100,7 @@ const char *SOUTH_KOREA_CAI_TXT[4] =
   "Unhealthy",
   "Very Unhealthy",
 };
+AQI_DATA
 const char *UNITED_KINGDOM_DAQI_TXT[4] =
 {
   "Low",
@@ -94,6 +108,7 @@ const char *UNITED_KINGDOM_DAQI_TXT[4] =
   "High",
   "Very High",
 };
+AQI_DATA
 const char *UNITED_STATES_AQI_TXT[6] =
 {
   "Good",
@@ -116,20 +131,25 @@ extern const char *UNITED_KINGDOM_DAQI_TXT[4];
 extern const char *UNITED_STATES_AQI_TXT[6];
 #endif // AQI_EXTERN_TXT
 
+AQI_API
 int max(int a, int b) { return a >= b ? a : b; }
+AQI_API
 int min(int a, int b) { return a <= b ? a : b; }
 
+AQI_API
 float truncate_float(float val, int decimal_places)
 {
   int n = pow(10, decimal_places);
   return floorf(val * n) / n;
 } // end truncate_float
 
+AQI_API
 int compute_nepm_aqi(float std, float c)
 {
   return (int)round(c / std * 100);
 } // end compute_nepm_aqi
 
+AQI_API
 int compute_piecewise_aqi(float i_lo, float i_hi,
                           float c_lo, float c_hi, float c)
 {
@@ -138,11 +158,497 @@ int compute_piecewise_aqi(float i_lo, float i_hi,
                              * (c - c_lo) + i_lo)));
 } // end compute_piecewise_aqi
 
+/* Maximum number of bands in a breakpoint table.
+ */
+#define AQI_MAX_BANDS 7
+
+/* Breakpoints of a piecewise linear sub-index.
+ *
+ * Bands are sorted in ascending order. A concentration c falls into the first
+ * band b for which c <= c_max[b] (or c < c_max[b] if 'inclusive' is 0), and is
+ * interpolated between (c_lo[b], i_lo[b]) and (c_hi[b], i_hi[b]). The
+ * thresholds are kept in double precision so that the comparison matches the
+ * published breakpoints exactly.
+ *
+ * Concentrations above the last band are off the scale and evaluate to 'over'.
+ */
+typedef struct {
+  int    num_bands;
+  int    inclusive;
+  int    over;
+  double c_max[AQI_MAX_BANDS];
+  float  i_lo[AQI_MAX_BANDS];
+  float  i_hi[AQI_MAX_BANDS];
+  float  c_lo[AQI_MAX_BANDS];
+  float  c_hi[AQI_MAX_BANDS];
+} breakpoint_table_t;
+
+/* Returns the index of the band concentration c falls into, or num_bands if c
+ * is off the scale (or NaN).
+ *
+ * Counts the thresholds below c instead of walking an if/else chain, so the
+ * search is free of data dependent branches.
+ */
+static int breakpoint_band(const breakpoint_table_t *t, float c)
+{
+  int band = 0;
+  if (t->inclusive)
+  {
+    for (int b = 0; b < t->num_bands; ++b)
+    {
+      band += !(c <= t->c_max[b]);
+    }
+  }
+  else
+  {
+    for (int b = 0; b < t->num_bands; ++b)
+    {
+      band += !(c < t->c_max[b]);
+    }
+  }
+  return band;
+} // end breakpoint_band
+
+/* Returns the sub-index of concentration c, or t->over if c is off the scale.
+ */
+static int breakpoint_aqi(const breakpoint_table_t *t, float c)
+{
+  int b = breakpoint_band(t, c);
+  if (b >= t->num_bands)
+  {
+    return t->over;
+  }
+  return compute_piecewise_aqi(t->i_lo[b], t->i_hi[b],
+                               t->c_lo[b], t->c_hi[b], c);
+} // end breakpoint_aqi
+
+/* Writes the sub-index of concentrations c[0..len-1] to aqi[0..len-1].
+ * Equivalent to calling breakpoint_aqi() on each concentration.
+ */
+static void breakpoint_aqi_column_scalar(const breakpoint_table_t *t, int len,
+                                         const float *c, int *aqi)
+{
+  for (int j = 0; j < len; ++j)
+  {
+    aqi[j] = breakpoint_aqi(t, c[j]);
+  }
+} // end breakpoint_aqi_column_scalar
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AQI_X86_KERNELS
+#include <immintrin.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Thresholds of a breakpoint table converted to single precision, for kernels
+ * that compare float concentrations without widening them to double.
+ *
+ * For a float c, c <= d holds exactly when c <= the largest float not above d,
+ * and c < d holds exactly when c < the smallest float not below d. The band
+ * parameters are pre-computed per band in the same order of operations as
+ * compute_piecewise_aqi(), so kernels produce identical results. Entries past
+ * the last band pad the arrays to the width of the widest permute.
+ */
+#define AQI_KERNEL_LANES 16
+
+typedef struct {
+  float c_max[AQI_KERNEL_LANES];
+  float i_lo[AQI_KERNEL_LANES];
+  float i_hi[AQI_KERNEL_LANES];
+  float c_lo[AQI_KERNEL_LANES];
+  float slope[AQI_KERNEL_LANES];
+} breakpoint_kernel_t;
+
+static void breakpoint_kernel_init(const breakpoint_table_t *t,
+                                   breakpoint_kernel_t *k)
+{
+  for (int b = 0; b < AQI_KERNEL_LANES; ++b)
+  {
+    if (b < t->num_bands)
+    {
+      float f = (float) t->c_max[b];
+      if (t->inclusive && f > t->c_max[b])
+      {
+        f = nextafterf(f, -INFINITY);
+      }
+      else if (!t->inclusive && f < t->c_max[b])
+      {
+        f = nextafterf(f, INFINITY);
+      }
+      k->c_max[b] = f;
+      k->i_lo[b]  = t->i_lo[b];
+      k->i_hi[b]  = t->i_hi[b];
+      k->c_lo[b]  = t->c_lo[b];
+      k->slope[b] = ((float)(t->i_hi[b] - t->i_lo[b]))
+                    / ((float)(t->c_hi[b] - t->c_lo[b]));
+    }
+    else
+    {
+      // off the scale, the kernels substitute t->over
+      k->c_max[b] = INFINITY;
+      k->i_lo[b]  = 0;
+      k->i_hi[b]  = 0;
+      k->c_lo[b]  = 0;
+      k->slope[b] = 0;
+    }
+  }
+} // end breakpoint_kernel_init
+
+/* SSE4.2 kernel, evaluates 4 concentrations per iteration. Without a lane
+ * permute, the band parameters are selected by blending in those of each band
+ * x lies above, which picks the same band as counting thresholds.
+ */
+__attribute__((target("sse4.2")))
+static void breakpoint_aqi_column_sse42(const breakpoint_table_t *t, int len,
+                                        const float *c, int *aqi)
+{
+  breakpoint_kernel_t k;
+  breakpoint_kernel_init(t, &k);
+
+  const __m128 sign   = _mm_set1_ps(-0.f);
+  const __m128 half   = _mm_set1_ps(0.5f);
+  const __m128 one    = _mm_set1_ps(1.f);
+  const __m128i over  = _mm_set1_epi32(t->over);
+
+  int j = 0;
+  for (; j + 4 <= len; j += 4)
+  {
+    __m128 x = _mm_loadu_ps(c + j);
+
+    // parameters of the last band whose lower threshold is below x
+    __m128 b_lo  = _mm_set1_ps(k.i_lo[0]);
+    __m128 b_hi  = _mm_set1_ps(k.i_hi[0]);
+    __m128 c_lo  = _mm_set1_ps(k.c_lo[0]);
+    __m128 slope = _mm_set1_ps(k.slope[0]);
+    __m128 above = _mm_setzero_ps();
+    for (int b = 0; b < t->num_bands; ++b)
+    {
+      above = t->inclusive ? _mm_cmpnle_ps(x, _mm_set1_ps(k.c_max[b]))
+                           : _mm_cmpnlt_ps(x, _mm_set1_ps(k.c_max[b]));
+      b_lo  = _mm_blendv_ps(b_lo,  _mm_set1_ps(k.i_lo[b + 1]),  above);
+      b_hi  = _mm_blendv_ps(b_hi,  _mm_set1_ps(k.i_hi[b + 1]),  above);
+      c_lo  = _mm_blendv_ps(c_lo,  _mm_set1_ps(k.c_lo[b + 1]),  above);
+      slope = _mm_blendv_ps(slope, _mm_set1_ps(k.slope[b + 1]), above);
+    }
+
+    // interpolate, round half away from zero, then clamp to [i_lo, i_hi]
+    __m128 v = _mm_add_ps(_mm_mul_ps(slope, _mm_sub_ps(x, c_lo)), b_lo);
+    __m128 r = _mm_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m128 frac = _mm_andnot_ps(sign, _mm_sub_ps(v, r));
+    __m128 step = _mm_and_ps(_mm_cmpge_ps(frac, half),
+                             _mm_or_ps(one, _mm_and_ps(sign, v)));
+    r = _mm_add_ps(r, step);
+    r = _mm_min_ps(b_hi, _mm_max_ps(b_lo, r));
+
+    // 'above' is set for the last band only when x is off the scale
+    __m128i sub = _mm_cvttps_epi32(r);
+    sub = _mm_blendv_epi8(sub, over, _mm_castps_si128(above));
+    _mm_storeu_si128((__m128i *)(aqi + j), sub);
+  }
+  breakpoint_aqi_column_scalar(t, len - j, c + j, aqi + j);
+} // end breakpoint_aqi_column_sse42
+
+/* AVX2 kernel, evaluates 8 concentrations per iteration.
+ */
+__attribute__((target("avx2")))
+static void breakpoint_aqi_column_avx2(const breakpoint_table_t *t, int len,
+                                       const float *c, int *aqi)
+{
+  breakpoint_kernel_t k;
+  breakpoint_kernel_init(t, &k);
+
+  const __m256 i_lo   = _mm256_loadu_ps(k.i_lo);
+  const __m256 i_hi   = _mm256_loadu_ps(k.i_hi);
+  const __m256 c_lo   = _mm256_loadu_ps(k.c_lo);
+  const __m256 slope  = _mm256_loadu_ps(k.slope);
+  const __m256 sign   = _mm256_set1_ps(-0.f);
+  const __m256 half   = _mm256_set1_ps(0.5f);
+  const __m256 one    = _mm256_set1_ps(1.f);
+  const __m256i nb    = _mm256_set1_epi32(t->num_bands);
+  const __m256i over  = _mm256_set1_epi32(t->over);
+
+  int j = 0;
+  for (; j + 8 <= len; j += 8)
+  {
+    __m256 x = _mm256_loadu_ps(c + j);
+
+    // band = number of thresholds below x
+    __m256i band = _mm256_setzero_si256();
+    for (int b = 0; b < t->num_bands; ++b)
+    {
+      __m256 above = t->inclusive
+                     ? _mm256_cmp_ps(x, _mm256_set1_ps(k.c_max[b]), _CMP_NLE_UQ)
+                     : _mm256_cmp_ps(x, _mm256_set1_ps(k.c_max[b]), _CMP_NLT_UQ);
+      band = _mm256_sub_epi32(band, _mm256_castps_si256(above));
+    }
+
+    // interpolate, round half away from zero, then clamp to [i_lo, i_hi]
+    __m256 b_lo = _mm256_permutevar8x32_ps(i_lo, band);
+    __m256 b_hi = _mm256_permutevar8x32_ps(i_hi, band);
+    __m256 v = _mm256_add_ps(
+                 _mm256_mul_ps(_mm256_permutevar8x32_ps(slope, band),
+                               _mm256_sub_ps(x, _mm256_permutevar8x32_ps(c_lo,
+                                                                         band))),
+                 b_lo);
+    __m256 r = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256 frac = _mm256_andnot_ps(sign, _mm256_sub_ps(v, r));
+    __m256 step = _mm256_and_ps(_mm256_cmp_ps(frac, half, _CMP_GE_OQ),
+                                _mm256_or_ps(one, _mm256_and_ps(sign, v)));
+    r = _mm256_add_ps(r, step);
+    r = _mm256_min_ps(b_hi, _mm256_max_ps(b_lo, r));
+
+    __m256i sub = _mm256_cvttps_epi32(r);
+    __m256i off = _mm256_cmpeq_epi32(band, nb);
+    sub = _mm256_blendv_epi8(sub, over, off);
+    _mm256_storeu_si256((__m256i *)(aqi + j), sub);
+  }
+  breakpoint_aqi_column_scalar(t, len - j, c + j, aqi + j);
+} // end breakpoint_aqi_column_avx2
+
+/* AVX-512 kernel, evaluates 16 concentrations per iteration. Contraction into
+ * fused multiply-add is disabled so results match the scalar path.
+ */
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void breakpoint_aqi_column_avx512(const breakpoint_table_t *t, int len,
+                                         const float *c, int *aqi)
+{
+  breakpoint_kernel_t k;
+  breakpoint_kernel_init(t, &k);
+
+  const __m512 i_lo   = _mm512_loadu_ps(k.i_lo);
+  const __m512 i_hi   = _mm512_loadu_ps(k.i_hi);
+  const __m512 c_lo   = _mm512_loadu_ps(k.c_lo);
+  const __m512 slope  = _mm512_loadu_ps(k.slope);
+  const __m512 half   = _mm512_set1_ps(0.5f);
+  const __m512i one   = _mm512_set1_epi32(1);
+  const __m512i over  = _mm512_set1_epi32(t->over);
+  const __m512i nb    = _mm512_set1_epi32(t->num_bands);
+  const __m512i sign  = _mm512_set1_epi32((int)0x80000000u);
+  const __m512i f_one = _mm512_set1_epi32(0x3f800000);
+
+  int j = 0;
+  for (; j + 16 <= len; j += 16)
+  {
+    __m512 x = _mm512_loadu_ps(c + j);
+
+    // band = number of thresholds below x
+    __m512i band = _mm512_setzero_si512();
+    for (int b = 0; b < t->num_bands; ++b)
+    {
+      __mmask16 above = t->inclusive
+                        ? _mm512_cmp_ps_mask(x, _mm512_set1_ps(k.c_max[b]),
+                                             _CMP_NLE_UQ)
+                        : _mm512_cmp_ps_mask(x, _mm512_set1_ps(k.c_max[b]),
+                                             _CMP_NLT_UQ);
+      band = _mm512_mask_add_epi32(band, above, band, one);
+    }
+
+    // interpolate, round half away from zero, then clamp to [i_lo, i_hi]
+    __m512 b_lo = _mm512_permutexvar_ps(band, i_lo);
+    __m512 b_hi = _mm512_permutexvar_ps(band, i_hi);
+    __m512 v = _mm512_add_ps(
+                 _mm512_mul_ps(_mm512_permutexvar_ps(band, slope),
+                               _mm512_sub_ps(x, _mm512_permutexvar_ps(band,
+                                                                      c_lo))),
+                 b_lo);
+    __m512 r = _mm512_roundscale_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m512 frac = _mm512_abs_ps(_mm512_sub_ps(v, r));
+    __mmask16 up = _mm512_cmp_ps_mask(frac, half, _CMP_GE_OQ);
+    __m512i step = _mm512_or_si512(f_one, _mm512_and_si512(
+                                            sign, _mm512_castps_si512(v)));
+    r = _mm512_mask_add_ps(r, up, r, _mm512_castsi512_ps(step));
+    r = _mm512_min_ps(b_hi, _mm512_max_ps(b_lo, r));
+
+    __m512i sub = _mm512_cvttps_epi32(r);
+    __mmask16 off = _mm512_cmpeq_epi32_mask(band, nb);
+    sub = _mm512_mask_mov_epi32(sub, off, over);
+    _mm512_storeu_si512((void *)(aqi + j), sub);
+  }
+  breakpoint_aqi_column_scalar(t, len - j, c + j, aqi + j);
+} // end breakpoint_aqi_column_avx512
+#endif // x86
+
+/* Instruction sets of the vector kernels, from least to most capable.
+ */
+typedef enum {
+  AQI_ISA_SCALAR,
+  AQI_ISA_SSE4_2,
+  AQI_ISA_AVX2,
+  AQI_ISA_AVX512,
+  NUM_AQI_ISAS
+} aqi_isa_t;
+
+/* Names of the instruction sets, as accepted by AQI_FORCE_ISA. Organized in
+ * the same order as aqi_isa_t enums.
+ */
+static const char *AQI_ISA_NAMES[NUM_AQI_ISAS] = {
+  "scalar",
+  "sse4.2",
+  "avx2",
+  "avx512",
+};
+
+/* Instruction set of the kernels in use, chosen once when the library is
+ * loaded.
+ */
+static aqi_isa_t kernel_isa = AQI_ISA_SCALAR;
+
+#ifdef AQI_X86_KERNELS
+/* Selects the widest instruction set the CPU supports, or the one named by the
+ * AQI_FORCE_ISA environment variable if the CPU supports it.
+ */
+__attribute__((constructor))
+static void kernel_isa_init(void)
+{
+  __builtin_cpu_init();
+  aqi_isa_t best = AQI_ISA_SCALAR;
+  if (__builtin_cpu_supports("sse4.2"))
+  {
+    best = AQI_ISA_SSE4_2;
+  }
+  if (__builtin_cpu_supports("avx2"))
+  {
+    best = AQI_ISA_AVX2;
+  }
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    best = AQI_ISA_AVX512;
+  }
+  kernel_isa = best;
+
+  const char *force = getenv("AQI_FORCE_ISA");
+  for (int isa = 0; force != NULL && isa <= (int) best; ++isa)
+  {
+    if (strcmp(force, AQI_ISA_NAMES[isa]) == 0)
+    {
+      kernel_isa = (aqi_isa_t) isa;
+    }
+  }
+} // end kernel_isa_init
+#endif
+
+AQI_API
+const char *aqi_isa(void)
+{
+  return AQI_ISA_NAMES[kernel_isa];
+} // end aqi_isa
+
+/* Writes the sub-index of concentrations c[0..len-1] to aqi[0..len-1], using
+ * the kernel of the selected instruction set.
+ */
+static void breakpoint_aqi_column(const breakpoint_table_t *t, int len,
+                                  const float *c, int *aqi)
+{
+  switch (kernel_isa)
+  {
+#ifdef AQI_X86_KERNELS
+    case AQI_ISA_AVX512:
+      breakpoint_aqi_column_avx512(t, len, c, aqi);
+      return;
+    case AQI_ISA_AVX2:
+      breakpoint_aqi_column_avx2(t, len, c, aqi);
+      return;
+    case AQI_ISA_SSE4_2:
+      breakpoint_aqi_column_sse42(t, len, c, aqi);
+      return;
+#endif
+    default:
+      breakpoint_aqi_column_scalar(t, len, c, aqi);
+      return;
+  }
+} // end breakpoint_aqi_column
+
+/* Largest |x| accepted by fast_expf().
+ */
+#define AQI_FAST_EXP_MAX_ARG 10.f
+
+/* Bound on the relative error of fast_expf((float) k * c) against exp(k * c),
+ * for |k * c| <= AQI_FAST_EXP_MAX_ARG. Covers fast_expf() itself (8.3e-8,
+ * checked against exp() for every float in [-10, 10]) plus the rounding of k
+ * and k * c to single precision (10 * 2^-23).
+ */
+#define AQI_FAST_EXP_REL_ERR 1.5e-6f
+
+/* Single precision e^x for |x| <= AQI_FAST_EXP_MAX_ARG.
+ *
+ * x = n * ln(2) + r with |r| <= ln(2) / 2, where ln(2) is split in two so that
+ * r is exact, and e^r is a degree 7 polynomial (Cephes expf).
+ *
+ * The AQHI scales use it through canada_aqhi_fast() and hong_kong_aqhi_fast(),
+ * which only return a result when it is further than the worst case error
+ * from a rounding or band boundary, so the libm result is never changed.
+ */
+static inline float fast_expf(float x)
+{
+  // round to nearest, biased so the conversion truncates a positive value
+  int   n = (int)(x * 1.44269504f + 16.5f) - 16;
+  float r = x - (float) n * 0.693359375f;
+  r = r - (float) n * -2.12194440e-4f;
+
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * r * r + r + 1.f;
+
+  // scale by 2^n
+  union { int32_t i; float f; } s;
+  s.i = (n + 127) << 23;
+  return p * s.f;
+} // end fast_expf
+
+/* Returns floor(v) for |v| < 2^31.
+ */
+static inline float floor_small(float v)
+{
+  float f = (float)(int) v;
+  return f > v ? f - 1 : f;
+} // end floor_small
+
+/* Exponential e^(k * c) of one pollutant of an AQHI scale.
+ *
+ * The fast_expf() value is computed up front and exp() only on request, at
+ * most once, so results that share a pollutant (the AQHI and the per-pollutant
+ * sub-indices of the *_detail functions) share its exponentials.
+ */
+typedef struct {
+  double k;
+  float  c;
+  float  y;         // (float) k * c
+  int    fast_ok;   // |y| <= AQI_FAST_EXP_MAX_ARG
+  float  fast;      // fast_expf(y), if fast_ok
+  int    exact_ok;
+  double exact;     // exp(k * c), if exact_ok
+} aqhi_exp_t;
+
+static inline void aqhi_exp_init(aqhi_exp_t *e, double k, float c)
+{
+  e->k = k;
+  e->c = c;
+  e->y = (float) k * c;
+  e->fast_ok = fabsf(e->y) <= AQI_FAST_EXP_MAX_ARG;
+  e->fast = e->fast_ok ? fast_expf(e->y) : 0;
+  e->exact_ok = 0;
+} // end aqhi_exp_init
+
+static inline double aqhi_exp_exact(aqhi_exp_t *e)
+{
+  if (!e->exact_ok)
+  {
+    e->exact = exp(e->k * e->c);
+    e->exact_ok = 1;
+  }
+  return e->exact;
+} // end aqhi_exp_exact
+
 /* Australia (AQI)
  *
  * References:
  *   https://www.environment.nsw.gov.au/topics/air/understanding-air-quality-data/air-quality-categories/history-of-air-quality-reporting/about-the-air-quality-index
  */
+AQI_API
 int australia_aqi(float co_8h,  float no2_1h,   float o3_1h, float o3_4h,
                   float so2_1h, float pm10_24h, float pm2_5_24h)
 {
@@ -175,12 +681,87 @@ int australia_aqi(float co_8h,  float no2_1h,   float o3_1h, float o3_4h,
  * References:
  *   https://en.wikipedia.org/wiki/Air_Quality_Health_Index_(Canada)
  */
+#define CANADA_AQHI_K_O3    0.000273533 // 0.000537 * 1ppb/1.9632 μg/m^3 = 0.000273533
+#define CANADA_AQHI_K_NO2   0.000462904 // 0.000871 * 1ppb/1.8816 μg/m^3 = 0.000462904
+#define CANADA_AQHI_K_PM2_5 0.000487
+
+/* Bound on the error of the AQHI computed by canada_aqhi_fast_exps(), per unit
+ * of the sum of its three exponentials. Twice the worst case, which also
+ * covers the single precision arithmetic around them.
+ */
+#define CANADA_AQHI_FAST_MARGIN (2 * (1000 / 10.4f) * AQI_FAST_EXP_REL_ERR)
+
+static int canada_aqhi_exact_exps(double e_o3, double e_no2, double e_pm2_5)
+{
+  return max(1, (int)round((1000 / 10.4) * ((e_o3 - 1) + (e_no2 - 1)
+                                            + (e_pm2_5 - 1))));
+} // end canada_aqhi_exact_exps
+
+/* Returns the AQHI from fast_expf() exponentials, or 0 if the result is too
+ * close to a rounding boundary to be sure it matches canada_aqhi_exact_exps().
+ */
+static int canada_aqhi_fast_exps(float e_o3, float e_no2, float e_pm2_5)
+{
+  float v = (1000 / 10.4f) * ((e_o3 - 1) + (e_no2 - 1) + (e_pm2_5 - 1));
+
+  float whole = floor_small(v);
+  if (fabsf(v - whole - 0.5f) <= CANADA_AQHI_FAST_MARGIN
+                                 * (e_o3 + e_no2 + e_pm2_5))
+  {
+    return 0;
+  }
+  return max(1, (int) whole + (v - whole > 0.5f));
+} // end canada_aqhi_fast_exps
+
+/* Returns the AQHI of three exponentials, from their fast_expf() values unless
+ * those cannot decide it.
+ */
+static int canada_aqhi_exps(aqhi_exp_t *o3, aqhi_exp_t *no2, aqhi_exp_t *pm2_5)
+{
+  if (o3->fast_ok && no2->fast_ok && pm2_5->fast_ok)
+  {
+    int aqhi = canada_aqhi_fast_exps(o3->fast, no2->fast, pm2_5->fast);
+    if (aqhi)
+    {
+      return aqhi;
+    }
+  }
+  return canada_aqhi_exact_exps(aqhi_exp_exact(o3), aqhi_exp_exact(no2),
+                                aqhi_exp_exact(pm2_5));
+} // end canada_aqhi_exps
+
+static int canada_aqhi_exact(float no2_3h, float o3_3h, float pm2_5_3h)
+{
+  return canada_aqhi_exact_exps(exp(CANADA_AQHI_K_O3 * o3_3h),
+                                exp(CANADA_AQHI_K_NO2 * no2_3h),
+                                exp(CANADA_AQHI_K_PM2_5 * pm2_5_3h));
+} // end canada_aqhi_exact
+
+/* Returns the AQHI using fast_expf(), or 0 if the result is too close to a
+ * rounding boundary (or an argument is out of range) to be sure it matches
+ * canada_aqhi_exact().
+ */
+static int canada_aqhi_fast(float no2_3h, float o3_3h, float pm2_5_3h)
+{
+  aqhi_exp_t o3, no2, pm2_5;
+  aqhi_exp_init(&o3,    CANADA_AQHI_K_O3,    o3_3h);
+  aqhi_exp_init(&no2,   CANADA_AQHI_K_NO2,   no2_3h);
+  aqhi_exp_init(&pm2_5, CANADA_AQHI_K_PM2_5, pm2_5_3h);
+  if (!(o3.fast_ok && no2.fast_ok && pm2_5.fast_ok))
+  {
+    return 0;
+  }
+  return canada_aqhi_fast_exps(o3.fast, no2.fast, pm2_5.fast);
+} // end canada_aqhi_fast
+
+AQI_API
 int canada_aqhi(float no2_3h, float o3_3h, float pm2_5_3h)
 {
-  return max(1, (int)round(
-                    (1000 / 10.4) * ((exp(0.000273533 * o3_3h) - 1)    // 0.000537 * 1ppb/1.9632 μg/m^3 = 0.000273533
-                                     + (exp(0.000462904 * no2_3h) - 1) // 0.000871 * 1ppb/1.8816 μg/m^3 = 0.000462904
-                                     + (exp(0.000487 * pm2_5_3h) - 1))));
+  aqhi_exp_t o3, no2, pm2_5;
+  aqhi_exp_init(&o3,    CANADA_AQHI_K_O3,    o3_3h);
+  aqhi_exp_init(&no2,   CANADA_AQHI_K_NO2,   no2_3h);
+  aqhi_exp_init(&pm2_5, CANADA_AQHI_K_PM2_5, pm2_5_3h);
+  return canada_aqhi_exps(&o3, &no2, &pm2_5);
 } // end canada_aqhi
 
 /* China (AQI)
@@ -190,2672 +771,5650 @@ int canada_aqhi(float no2_3h, float o3_3h, float pm2_5_3h)
  *   https://en.wikipedia.org/wiki/Air_quality_index#Mainland_China
  *   https://datadrivenlab.org/air-quality-2/chinas-new-air-quality-index-how-does-it-measure-up/
  */
+static const breakpoint_table_t CHINA_AQI_CO_1H = {
+  7, 1, 501,
+  /* c_max */ {   5000,  10000,  35000,  60000,  90000, 120000, 150000 },
+  /* i_lo  */ {      0,     51,    101,    151,    201,    301,    401 },
+  /* i_hi  */ {     50,    100,    150,    200,    300,    400,    500 },
+  /* c_lo  */ {      0,   5000,  10000,  35000,  60000,  90000, 120000 },
+  /* c_hi  */ {   5000,  10000,  35000,  60000,  90000, 120000, 150000 },
+};
+
+static const breakpoint_table_t CHINA_AQI_CO_24H = {
+  7, 1, 501,
+  /* c_max */ {  2000,  4000, 14000, 24000, 36000, 48000, 60000 },
+  /* i_lo  */ {     0,    51,   101,   151,   201,   301,   401 },
+  /* i_hi  */ {    50,   100,   150,   200,   300,   400,   500 },
+  /* c_lo  */ {     0,  2000,  4000, 14000, 24000, 36000, 48000 },
+  /* c_hi  */ {  2000,  4000, 14000, 24000, 36000, 48000, 60000 },
+};
+
+static const breakpoint_table_t CHINA_AQI_NO2_1H = {
+  7, 1, 501,
+  /* c_max */ {  100,  200,  700, 1200, 2340, 3090, 3840 },
+  /* i_lo  */ {    0,   51,  101,  151,  201,  301,  401 },
+  /* i_hi  */ {   50,  100,  150,  200,  300,  400,  500 },
+  /* c_lo  */ {    0,  100,  200,  700, 1200, 2340, 3090 },
+  /* c_hi  */ {  100,  200,  700, 1200, 2340, 3090, 3840 },
+};
+
+static const breakpoint_table_t CHINA_AQI_NO2_24H = {
+  7, 1, 501,
+  /* c_max */ {  40,  80, 180, 280, 565, 750, 940 },
+  /* i_lo  */ {   0,  51, 101, 151, 201, 301, 401 },
+  /* i_hi  */ {  50, 100, 150, 200, 300, 400, 500 },
+  /* c_lo  */ {   0,  40,  80, 180, 280, 565, 750 },
+  /* c_hi  */ {  40,  80, 180, 280, 565, 750, 940 },
+};
+
+static const breakpoint_table_t CHINA_AQI_O3_1H = {
+  7, 1, 501,
+  /* c_max */ {  160,  200,  300,  400,  800, 1000, 1200 },
+  /* i_lo  */ {    0,   51,  101,  151,  201,  301,  401 },
+  /* i_hi  */ {   50,  100,  150,  200,  300,  400,  500 },
+  /* c_lo  */ {    0,  160,  200,  300,  400,  800, 1000 },
+  /* c_hi  */ {  160,  200,  300,  400,  800, 1000, 1200 },
+};
+
+static const breakpoint_table_t CHINA_AQI_O3_8H = {
+  5, 1, 501,
+  /* c_max */ {   100,   160,   215,   265,   800 },
+  /* i_lo  */ {     0,    51,   101,   151,   201 },
+  /* i_hi  */ {    50,   100,   150,   200,   300 },
+  /* c_lo  */ {     0,   100,   160,   215,   265 },
+  /* c_hi  */ {   100,   160,   215,   265,   800 },
+};
+
+static const breakpoint_table_t CHINA_AQI_SO2_1H = {
+  4, 1, 501,
+  /* c_max */ {   150,   500,   650,   800 },
+  /* i_lo  */ {     0,    51,   101,   151 },
+  /* i_hi  */ {    50,   100,   150,   200 },
+  /* c_lo  */ {     0,   150,   500,   650 },
+  /* c_hi  */ {   150,   500,   650,   800 },
+};
+
+static const breakpoint_table_t CHINA_AQI_SO2_24H = {
+  7, 1, 501,
+  /* c_max */ {   50,  150,  475,  800, 1600, 2100, 2620 },
+  /* i_lo  */ {    0,   51,  101,  151,  201,  301,  401 },
+  /* i_hi  */ {   50,  100,  150,  200,  300,  400,  500 },
+  /* c_lo  */ {    0,   50,  150,  475,  800, 1600, 2100 },
+  /* c_hi  */ {   50,  150,  475,  800, 1600, 2100, 2620 },
+};
+
+static const breakpoint_table_t CHINA_AQI_PM10_24H = {
+  7, 1, 501,
+  /* c_max */ {  50, 150, 250, 350, 420, 500, 600 },
+  /* i_lo  */ {   0,  51, 101, 151, 201, 301, 401 },
+  /* i_hi  */ {  50, 100, 150, 200, 300, 400, 500 },
+  /* c_lo  */ {   0,  50, 150, 250, 350, 420, 500 },
+  /* c_hi  */ {  50, 150, 250, 350, 420, 500, 600 },
+};
+
+static const breakpoint_table_t CHINA_AQI_PM2_5_24H = {
+  7, 1, 501,
+  /* c_max */ {  35,  75, 115, 150, 250, 350, 500 },
+  /* i_lo  */ {   0,  51, 101, 151, 201, 301, 401 },
+  /* i_hi  */ {  50, 100, 150, 200, 300, 400, 500 },
+  /* c_lo  */ {   0,  35,  75, 115, 150, 250, 350 },
+  /* c_hi  */ {  35,  75, 115, 150, 250, 350, 500 },
+};
+
+AQI_API
 int china_aqi(float co_1h, float co_24h, float no2_1h, float no2_24h,
               float o3_1h, float o3_8h,  float so2_1h, float so2_24h,
               float pm10_24h, float pm2_5_24h)
 {
   int aqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
 
   // co    μg/m^3, Carbon Monoxide (CO)
   // 1mg/m^3 = 1000 μg/m^3
-  if (co_1h <= 5000)
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_CO_1H, co_1h));
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_CO_24H, co_24h));
+
+  // no2   μg/m^3, Nitrogen Dioxide (NO2)
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_NO2_1H, no2_1h));
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_NO2_24H, no2_24h));
+
+  // o3    μg/m^3, Ozone (O3)
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_O3_1H, o3_1h));
+
+  // If 8 hour average of o3 is > 800 μg/m^3 don't calculate it.
+  if (o3_8h <= 800)
   {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 5000;
+    aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_O3_8H, o3_8h));
   }
-  else if (co_1h <= 10000)
+
+  // so2   μg/m^3, Sulfur Dioxide (SO2)
+  // If 1 hour average of so2 is > 800 μg/m^3 don't calculate it.
+  if (so2_1h <= 800)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 5000;
-    c_hi = 10000;
+    aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_SO2_1H, so2_1h));
   }
-  else if (co_1h <= 35000)
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_SO2_24H, so2_24h));
+
+  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_PM10_24H, pm10_24h));
+
+  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+  aqi = max(aqi, breakpoint_aqi(&CHINA_AQI_PM2_5_24H, pm2_5_24h));
+
+  return aqi;
+} // end china_aqi
+
+/* European Union (CAQI)
+ *
+ * References:
+ *   http://airqualitynow.eu/about_indices_definition.php
+ *   https://en.wikipedia.org/wiki/Air_quality_index#CAQI
+ */
+static const breakpoint_table_t EUROPEAN_UNION_CAQI_NO2_1H = {
+  4, 1, 101,
+  /* c_max */ {  50, 100, 200, 400 },
+  /* i_lo  */ {   0,  26,  51,  76 },
+  /* i_hi  */ {  25,  50,  75, 100 },
+  /* c_lo  */ {   0,  50, 100, 200 },
+  /* c_hi  */ {  50, 100, 200, 400 },
+};
+
+static const breakpoint_table_t EUROPEAN_UNION_CAQI_O3_1H = {
+  4, 1, 101,
+  /* c_max */ {  60, 120, 180, 240 },
+  /* i_lo  */ {   0,  25,  51,  76 },
+  /* i_hi  */ {  25,  50,  75, 100 },
+  /* c_lo  */ {   0,  60, 120, 180 },
+  /* c_hi  */ {  60, 120, 180, 240 },
+};
+
+static const breakpoint_table_t EUROPEAN_UNION_CAQI_PM10_1H = {
+  4, 1, 101,
+  /* c_max */ {  25,  50,  90, 180 },
+  /* i_lo  */ {   0,  26,  51,  76 },
+  /* i_hi  */ {  25,  50,  75, 100 },
+  /* c_lo  */ {   0,  25,  50,  90 },
+  /* c_hi  */ {  25,  50,  90, 180 },
+};
+
+static const breakpoint_table_t EUROPEAN_UNION_CAQI_PM2_5_1H = {
+  4, 1, 101,
+  /* c_max */ {  15,  30,  55, 110 },
+  /* i_lo  */ {   0,  26,  51,  76 },
+  /* i_hi  */ {  25,  50,  75, 100 },
+  /* c_lo  */ {   0,  15,  30,  55 },
+  /* c_hi  */ {  15,  30,  55, 110 },
+};
+
+AQI_API
+int european_union_caqi(float no2_1h, float o3_1h, float pm10_1h, float pm2_5_1h)
+{
+  int caqi = 0;
+
+  // no2   μg/m^3, Nitrogen Dioxide (NO2)
+  caqi = max(caqi, breakpoint_aqi(&EUROPEAN_UNION_CAQI_NO2_1H, no2_1h));
+
+  // o3    μg/m^3, Ground-Level Ozone (O3)
+  caqi = max(caqi, breakpoint_aqi(&EUROPEAN_UNION_CAQI_O3_1H, o3_1h));
+
+  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+  caqi = max(caqi, breakpoint_aqi(&EUROPEAN_UNION_CAQI_PM10_1H, pm10_1h));
+
+  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+  caqi = max(caqi, breakpoint_aqi(&EUROPEAN_UNION_CAQI_PM2_5_1H, pm2_5_1h));
+
+  return caqi;
+} // end european_union_caqi
+
+/* Hong Kong (AQHI)
+ *
+ * References:
+ *   https://www.aqhi.gov.hk/en/what-is-aqhi/faqs.html
+ *   https://aqicn.org/faq/2015-06-03/overview-of-hong-kongs-air-quality-health-index/
+ */
+#define HONG_KONG_AQHI_K_NO2   0.0004462559
+#define HONG_KONG_AQHI_K_SO2   0.0001393235
+#define HONG_KONG_AQHI_K_O3    0.0005116328
+#define HONG_KONG_AQHI_K_PM10  0.0002821751
+#define HONG_KONG_AQHI_K_PM2_5 0.0002180567
+
+/* Upper bounds of the added risk (AR) for AQHI 1 to 10. */
+static const float HONG_KONG_AQHI_AR_UPPER[10] = {
+  1.88f, 3.76f, 5.64f, 7.52f, 9.41f, 11.29f, 12.91f, 15.07f, 17.22f, 19.37f
+};
+
+/* Bound on the error of the AR computed by hong_kong_aqhi_fast_exps(), per
+ * unit of the sum of its exponentials. Twice the worst case, which also covers
+ * the single precision arithmetic around them.
+ */
+#define HONG_KONG_AQHI_FAST_MARGIN (2 * 100 * AQI_FAST_EXP_REL_ERR)
+
+static int hong_kong_aqhi_exact_exps(double e_no2,  double e_so2,
+                                     double e_o3,   double e_pm10,
+                                     double e_pm2_5)
+{
+  float ar = ((e_no2 - 1) * 100) + ((e_so2 - 1) * 100) + ((e_o3 - 1) * 100) + fmax(((e_pm10 - 1) * 100), ((e_pm2_5 - 1) * 100));
+  if (ar <= 1.88)
   {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 10000;
-    c_hi = 35000;
+    return 1;
   }
-  else if (co_1h <= 60000)
+  else if (ar <= 3.76)
   {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 35000;
-    c_hi = 60000;
+    return 2;
   }
-  else if (co_1h <= 90000)
+  else if (ar <= 5.64)
   {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 60000;
-    c_hi = 90000;
+    return 3;
   }
-  else if (co_1h <= 120000)
+  else if (ar <= 7.52)
   {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 90000;
-    c_hi = 120000;
+    return 4;
   }
-  else if (co_1h <= 150000)
+  else if (ar <= 9.41)
   {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 120000;
-    c_hi = 150000;
+    return 5;
   }
-  else
+  else if (ar <= 11.29)
   {
-    // index > 500
-    return 501;
+    return 6;
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_1h));
-
-  if (co_24h <= 2000)
+  else if (ar <= 12.91)
   {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 2000;
+    return 7;
   }
-  else if (co_24h <= 4000)
+  else if (ar <= 15.07)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 2000;
-    c_hi = 4000;
+    return 8;
   }
-  else if (co_24h <= 14000)
+  else if (ar <= 17.22)
   {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 4000;
-    c_hi = 14000;
+    return 9;
   }
-  else if (co_24h <= 24000)
+  else if (ar <= 19.37)
   {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 14000;
-    c_hi = 24000;
+    return 10;
   }
-  else if (co_24h <= 36000)
+  else
   {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 24000;
-    c_hi = 36000;
-  }
-  else if (co_24h <= 48000)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 36000;
-    c_hi = 48000;
-  }
-  else if (co_24h <= 60000)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 48000;
-    c_hi = 60000;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_24h));
-
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_1h <= 100)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 100;
-  }
-  else if (no2_1h <= 200)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 100;
-    c_hi = 200;
-  }
-  else if (no2_1h <= 700)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 200;
-    c_hi = 700;
-  }
-  else if (no2_1h <= 1200)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 700;
-    c_hi = 1200;
-  }
-  else if (no2_1h <= 2340)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 1200;
-    c_hi = 2340;
-  }
-  else if (no2_1h <= 3090)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 2340;
-    c_hi = 3090;
-  }
-  else if (no2_1h <= 3840)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 3090;
-    c_hi = 3840;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
-
-  if (no2_24h <= 40)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 40;
-  }
-  else if (no2_24h <= 80)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 40;
-    c_hi = 80;
-  }
-  else if (no2_24h <= 180)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 80;
-    c_hi = 180;
-  }
-  else if (no2_24h <= 280)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 180;
-    c_hi = 280;
-  }
-  else if (no2_24h <= 565)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 280;
-    c_hi = 565;
-  }
-  else if (no2_24h <= 750)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 565;
-    c_hi = 750;
-  }
-  else if (no2_24h <= 940)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 750;
-    c_hi = 940;
-  }
-  else
-  {
-    // index > 500
-    return 501;
+    // index > 10
+    return 11;
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_24h));
+} // end hong_kong_aqhi_exact_exps
 
-  // o3    μg/m^3, Ozone (O3)
-  if (o3_1h <= 160)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 160;
-  }
-  else if (o3_1h <= 200)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 160;
-    c_hi = 200;
-  }
-  else if (o3_1h <= 300)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 200;
-    c_hi = 300;
-  }
-  else if (o3_1h <= 400)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 300;
-    c_hi = 400;
-  }
-  else if (o3_1h <= 800)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 400;
-    c_hi = 800;
-  }
-  else if (o3_1h <= 1000)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 800;
-    c_hi = 1000;
-  }
-  else if (o3_1h <= 1200)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 1000;
-    c_hi = 1200;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
+/* Returns the AQHI from fast_expf() exponentials, or 0 if the AR is too close
+ * to a band boundary to be sure it matches hong_kong_aqhi_exact_exps().
+ */
+static int hong_kong_aqhi_fast_exps(float e_no2,  float e_so2, float e_o3,
+                                    float e_pm10, float e_pm2_5)
+{
+  float ar_pm10  = (e_pm10 - 1) * 100;
+  float ar_pm2_5 = (e_pm2_5 - 1) * 100;
+  float ar = ((e_no2 - 1) * 100) + ((e_so2 - 1) * 100) + ((e_o3 - 1) * 100)
+             + (ar_pm10 > ar_pm2_5 ? ar_pm10 : ar_pm2_5);
+  float margin = HONG_KONG_AQHI_FAST_MARGIN
+                 * (e_no2 + e_so2 + e_o3 + e_pm10 + e_pm2_5);
 
-  // If 8 hour average of o3 is > 800 μg/m^3 don't calculate it.
-  if (o3_8h <= 800)
+  int aqhi = 1;
+  for (int b = 0; b < 10; ++b)
   {
-    if (o3_8h <= 100)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 100;
-    }
-    else if (o3_8h <= 160)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 100;
-      c_hi = 160;
-    }
-    else if (o3_8h <= 215)
+    if (fabsf(ar - HONG_KONG_AQHI_AR_UPPER[b]) <= margin)
     {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 160;
-      c_hi = 215;
+      return 0;
     }
-    else if (o3_8h <= 265)
-    {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 215;
-      c_hi = 265;
-    }
-    else
-    {
-      // 265 < o3_8h <= 800
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 265;
-      c_hi = 800;
-    }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
+    aqhi += ar > HONG_KONG_AQHI_AR_UPPER[b];
   }
+  return aqhi;
+} // end hong_kong_aqhi_fast_exps
 
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  // If 1 hour average of so2 is > 800 μg/m^3 don't calculate it.
-  if (so2_1h <= 800)
+/* Returns the AQHI of five exponentials, from their fast_expf() values unless
+ * those cannot decide it.
+ */
+static int hong_kong_aqhi_exps(aqhi_exp_t *no2,  aqhi_exp_t *so2,
+                               aqhi_exp_t *o3,   aqhi_exp_t *pm10,
+                               aqhi_exp_t *pm2_5)
+{
+  if (no2->fast_ok && so2->fast_ok && o3->fast_ok && pm10->fast_ok
+      && pm2_5->fast_ok)
   {
-    if (so2_1h <= 150)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 150;
-    }
-    else if (so2_1h <= 500)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 150;
-      c_hi = 500;
-    }
-    else if (so2_1h <= 650)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 500;
-      c_hi = 650;
-    }
-    else
+    int aqhi = hong_kong_aqhi_fast_exps(no2->fast, so2->fast, o3->fast,
+                                        pm10->fast, pm2_5->fast);
+    if (aqhi)
     {
-      // 650 < so2_1h <= 800
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 650;
-      c_hi = 800;
+      return aqhi;
     }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_1h));
   }
+  return hong_kong_aqhi_exact_exps(aqhi_exp_exact(no2), aqhi_exp_exact(so2),
+                                   aqhi_exp_exact(o3), aqhi_exp_exact(pm10),
+                                   aqhi_exp_exact(pm2_5));
+} // end hong_kong_aqhi_exps
 
-  if (so2_24h <= 50)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (so2_24h <= 150)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 50;
-    c_hi = 150;
-  }
-  else if (so2_24h <= 475)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 150;
-    c_hi = 475;
-  }
-  else if (so2_24h <= 800)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 475;
-    c_hi = 800;
-  }
-  else if (so2_24h <= 1600)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 800;
-    c_hi = 1600;
-  }
-  else if (so2_24h <= 2100)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1600;
-    c_hi = 2100;
-  }
-  else if (so2_24h <= 2620)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 2100;
-    c_hi = 2620;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
+static int hong_kong_aqhi_exact(float no2_3h,  float o3_3h, float so2_3h,
+                                float pm10_3h, float pm2_5_3h)
+{
+  return hong_kong_aqhi_exact_exps(exp(HONG_KONG_AQHI_K_NO2 * no2_3h),
+                                   exp(HONG_KONG_AQHI_K_SO2 * so2_3h),
+                                   exp(HONG_KONG_AQHI_K_O3 * o3_3h),
+                                   exp(HONG_KONG_AQHI_K_PM10 * pm10_3h),
+                                   exp(HONG_KONG_AQHI_K_PM2_5 * pm2_5_3h));
+} // end hong_kong_aqhi_exact
 
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h <= 50)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (pm10_24h <= 150)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 50;
-    c_hi = 150;
-  }
-  else if (pm10_24h <= 250)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 150;
-    c_hi = 250;
-  }
-  else if (pm10_24h <= 350)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 250;
-    c_hi = 350;
-  }
-  else if (pm10_24h <= 420)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 350;
-    c_hi = 420;
-  }
-  else if (pm10_24h <= 500)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 420;
-    c_hi = 500;
-  }
-  else if (pm10_24h <= 600)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 500;
-    c_hi = 600;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
+/* Initializes the exponentials of the five Hong Kong AQHI pollutants.
+ */
+static void hong_kong_aqhi_exp_init(aqhi_exp_t *no2,  aqhi_exp_t *so2,
+                                    aqhi_exp_t *o3,   aqhi_exp_t *pm10,
+                                    aqhi_exp_t *pm2_5,
+                                    float no2_3h,  float o3_3h, float so2_3h,
+                                    float pm10_3h, float pm2_5_3h)
+{
+  aqhi_exp_init(no2,   HONG_KONG_AQHI_K_NO2,   no2_3h);
+  aqhi_exp_init(so2,   HONG_KONG_AQHI_K_SO2,   so2_3h);
+  aqhi_exp_init(o3,    HONG_KONG_AQHI_K_O3,    o3_3h);
+  aqhi_exp_init(pm10,  HONG_KONG_AQHI_K_PM10,  pm10_3h);
+  aqhi_exp_init(pm2_5, HONG_KONG_AQHI_K_PM2_5, pm2_5_3h);
+} // end hong_kong_aqhi_exp_init
 
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h <= 35)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 35;
-  }
-  else if (pm2_5_24h <= 75)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 35;
-    c_hi = 75;
-  }
-  else if (pm2_5_24h <= 115)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 75;
-    c_hi = 115;
-  }
-  else if (pm2_5_24h <= 150)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 115;
-    c_hi = 150;
-  }
-  else if (pm2_5_24h <= 250)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 150;
-    c_hi = 250;
-  }
-  else if (pm2_5_24h <= 350)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 250;
-    c_hi = 350;
-  }
-  else if (pm2_5_24h <= 500)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 350;
-    c_hi = 500;
-  }
-  else
+/* Returns the AQHI using fast_expf(), or 0 if the AR is too close to a band
+ * boundary (or an argument is out of range) to be sure it matches
+ * hong_kong_aqhi_exact().
+ */
+static int hong_kong_aqhi_fast(float no2_3h,  float o3_3h, float so2_3h,
+                               float pm10_3h, float pm2_5_3h)
+{
+  aqhi_exp_t no2, so2, o3, pm10, pm2_5;
+  hong_kong_aqhi_exp_init(&no2, &so2, &o3, &pm10, &pm2_5,
+                          no2_3h, o3_3h, so2_3h, pm10_3h, pm2_5_3h);
+  if (!(no2.fast_ok && so2.fast_ok && o3.fast_ok && pm10.fast_ok
+        && pm2_5.fast_ok))
   {
-    // index > 500
-    return 501;
+    return 0;
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
+  return hong_kong_aqhi_fast_exps(no2.fast, so2.fast, o3.fast, pm10.fast,
+                                  pm2_5.fast);
+} // end hong_kong_aqhi_fast
 
-  return aqi;
-} // end china_aqi
+AQI_API
+int hong_kong_aqhi(float no2_3h,  float o3_3h, float so2_3h,
+                   float pm10_3h, float pm2_5_3h)
+{
+  aqhi_exp_t no2, so2, o3, pm10, pm2_5;
+  hong_kong_aqhi_exp_init(&no2, &so2, &o3, &pm10, &pm2_5,
+                          no2_3h, o3_3h, so2_3h, pm10_3h, pm2_5_3h);
+  return hong_kong_aqhi_exps(&no2, &so2, &o3, &pm10, &pm2_5);
+} // end hong_kong_aqhi
 
-/* European Union (CAQI)
+/* India (AQI)
  *
  * References:
- *   http://airqualitynow.eu/about_indices_definition.php
- *   https://en.wikipedia.org/wiki/Air_quality_index#CAQI
+ *   https://www.aqi.in/blog/aqi/
+ *   https://www.pranaair.com/blog/what-is-air-quality-index-aqi-and-its-calculation/
  */
-int european_union_caqi(float no2_1h, float o3_1h, float pm10_1h, float pm2_5_1h)
+static const breakpoint_table_t INDIA_AQI_CO_8H = {
+  5, 0, 401,
+  /* c_max */ {  1050,  2050, 10050, 17050, 34050 },
+  /* i_lo  */ {     0,    51,   101,   201,   301 },
+  /* i_hi  */ {    50,   100,   200,   300,   400 },
+  /* c_lo  */ {     0,  1100,  2100, 10100, 17100 },
+  /* c_hi  */ {  1000,  2000, 10000, 17000, 34000 },
+};
+
+static const breakpoint_table_t INDIA_AQI_NH3_24H = {
+  5, 0, 401,
+  /* c_max */ {  200.5,  400.5,  800.5, 1200.5, 1800.5 },
+  /* i_lo  */ {      0,     51,    101,    201,    301 },
+  /* i_hi  */ {     50,    100,    200,    300,    400 },
+  /* c_lo  */ {      0,    201,    401,    801,   1201 },
+  /* c_hi  */ {    200,    400,    800,   1200,   1800 },
+};
+
+static const breakpoint_table_t INDIA_AQI_NO2_24H = {
+  5, 0, 401,
+  /* c_max */ {  40.5,  80.5, 180.5, 280.5, 400.5 },
+  /* i_lo  */ {     0,    51,   101,   201,   301 },
+  /* i_hi  */ {    50,   100,   200,   300,   400 },
+  /* c_lo  */ {     0,    41,    81,   181,   281 },
+  /* c_hi  */ {    40,    80,   180,   280,   400 },
+};
+
+static const breakpoint_table_t INDIA_AQI_O3_8H = {
+  5, 0, 401,
+  /* c_max */ {  50.5, 100.5, 168.5, 208.5, 748.5 },
+  /* i_lo  */ {     0,    51,   101,   201,   301 },
+  /* i_hi  */ {    50,   100,   200,   300,   400 },
+  /* c_lo  */ {     0,    51,   101,   169,   209 },
+  /* c_hi  */ {    50,   100,   168,   208,   748 },
+};
+
+static const breakpoint_table_t INDIA_AQI_PB_24H = {
+  5, 0, 401,
+  /* c_max */ { 0.55, 1.05, 2.05, 3.05, 3.55 },
+  /* i_lo  */ {    0,   51,  101,  201,  301 },
+  /* i_hi  */ {   50,  100,  200,  300,  400 },
+  /* c_lo  */ {    0,  0.6,  1.1,  2.1,  3.1 },
+  /* c_hi  */ {  0.5,  1.0,  2.0,  3.0,  3.5 },
+};
+
+static const breakpoint_table_t INDIA_AQI_SO2_24H = {
+  5, 0, 401,
+  /* c_max */ {   40.5,   80.5,  380.5,  800.5, 1600.5 },
+  /* i_lo  */ {      0,     51,    101,    201,    301 },
+  /* i_hi  */ {     50,    100,    200,    300,    400 },
+  /* c_lo  */ {      0,     41,     81,    381,    801 },
+  /* c_hi  */ {     40,     80,    380,    800,   1600 },
+};
+
+static const breakpoint_table_t INDIA_AQI_PM10_24H = {
+  5, 0, 401,
+  /* c_max */ {  50.5, 100.5, 250.5, 350.5, 430.5 },
+  /* i_lo  */ {     0,    51,   101,   201,   301 },
+  /* i_hi  */ {    50,   100,   200,   300,   400 },
+  /* c_lo  */ {     0,    51,   101,   251,   351 },
+  /* c_hi  */ {    50,   100,   250,   350,   430 },
+};
+
+static const breakpoint_table_t INDIA_AQI_PM2_5_24H = {
+  5, 0, 401,
+  /* c_max */ {  30.5,  60.5,  90.5, 120.5, 250.5 },
+  /* i_lo  */ {     0,    51,   101,   201,   301 },
+  /* i_hi  */ {    50,   100,   200,   300,   400 },
+  /* c_lo  */ {     0,    31,    61,    91,   121 },
+  /* c_hi  */ {    30,    60,    90,   120,   250 },
+};
+
+AQI_API
+int india_aqi(float co_8h,  float nh3_24h, float no2_24h,  float o3_8h,
+              float pb_24h, float so2_24h, float pm10_24h, float pm2_5_24h)
 {
-  int caqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
+  int aqi = 0;
+
+  // co    μg/m^3, Carbon Monoxide (CO)
+  // 1mg/m^3 = 1000 μg/m^3
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_CO_8H, co_8h));
+
+  // nh3   μg/m^3, Ammonia (NH3)
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_NH3_24H, nh3_24h));
 
   // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_1h <= 50)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (no2_1h <= 100)
-  {
-    i_lo = 26;
-    i_hi = 50;
-    c_lo = 50;
-    c_hi = 100;
-  }
-  else if (no2_1h <= 200)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 100;
-    c_hi = 200;
-  }
-  else if (no2_1h <= 400)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 200;
-    c_hi = 400;
-  }
-  else
-  {
-    // index > 100
-    return 101;
-  }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_NO2_24H, no2_24h));
 
-  // o3    μg/m^3, Ground-Level Ozone (O3)
-  if (o3_1h <= 60)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 60;
-  }
-  else if (o3_1h <= 120)
-  {
-    i_lo = 25;
-    i_hi = 50;
-    c_lo = 60;
-    c_hi = 120;
-  }
-  else if (o3_1h <= 180)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 120;
-    c_hi = 180;
-  }
-  else if (o3_1h <= 240)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 180;
-    c_hi = 240;
-  }
-  else
-  {
-    // index > 100
-    return 101;
-  }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
+  // o3    μg/m^3, Ozone (O3)
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_O3_8H, o3_8h));
+
+  // pb    μg/m^3, Lead (Pb)
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_PB_24H, pb_24h));
+
+  // so2   μg/m^3, Sulfur Dioxide (SO2)
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_SO2_24H, so2_24h));
 
   // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_1h <= 25)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 25;
-  }
-  else if (pm10_1h <= 50)
-  {
-    i_lo = 26;
-    i_hi = 50;
-    c_lo = 25;
-    c_hi = 50;
-  }
-  else if (pm10_1h <= 90)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 50;
-    c_hi = 90;
-  }
-  else if (pm10_1h <= 180)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 90;
-    c_hi = 180;
-  }
-  else
-  {
-    // index > 100
-    return 101;
-  }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_1h));
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_PM10_24H, pm10_24h));
 
   // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_1h <= 15)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 15;
-  }
-  else if (pm2_5_1h <= 30)
-  {
-    i_lo = 26;
-    i_hi = 50;
-    c_lo = 15;
-    c_hi = 30;
-  }
-  else if (pm2_5_1h <= 55)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 30;
-    c_hi = 55;
-  }
-  else if (pm2_5_1h <= 110)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 55;
-    c_hi = 110;
-  }
-  else
-  {
-    // index > 100
-    return 101;
-  }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_1h));
+  aqi = max(aqi, breakpoint_aqi(&INDIA_AQI_PM2_5_24H, pm2_5_24h));
 
-  return caqi;
-} // end european_union_caqi
+  return aqi;
+} // end india_aqi
 
-/* Hong Kong (AQHI)
+/* Singapore (PSI)
  *
  * References:
- *   https://www.aqhi.gov.hk/en/what-is-aqhi/faqs.html
- *   https://aqicn.org/faq/2015-06-03/overview-of-hong-kongs-air-quality-health-index/
+ *   https://www.haze.gov.sg/
+ *   http://www.haze.gov.sg/docs/default-source/faq/computation-of-the-pollutant-standards-index-%28psi%29.pdf
  */
-int hong_kong_aqhi(float no2_3h,  float o3_3h, float so2_3h,
-                   float pm10_3h, float pm2_5_3h)
-{
-  float ar = ((exp(0.0004462559 * no2_3h) - 1) * 100) + ((exp(0.0001393235 * so2_3h) - 1) * 100) + ((exp(0.0005116328 * o3_3h) - 1) * 100) + fmax(((exp(0.0002821751 * pm10_3h) - 1) * 100), ((exp(0.0002180567 * pm2_5_3h) - 1) * 100));
-  if (ar <= 1.88)
-  {
-    return 1;
-  }
-  else if (ar <= 3.76)
-  {
-    return 2;
-  }
-  else if (ar <= 5.64)
-  {
-    return 3;
-  }
-  else if (ar <= 7.52)
-  {
-    return 4;
-  }
-  else if (ar <= 9.41)
-  {
-    return 5;
-  }
-  else if (ar <= 11.29)
-  {
-    return 6;
-  }
-  else if (ar <= 12.91)
-  {
-    return 7;
-  }
-  else if (ar <= 15.07)
-  {
-    return 8;
-  }
-  else if (ar <= 17.22)
-  {
-    return 9;
-  }
-  else if (ar <= 19.37)
-  {
-    return 10;
-  }
-  else
+static const breakpoint_table_t SINGAPORE_PSI_CO_8H = {
+  6, 0, 501,
+  /* c_max */ {  5050, 10050, 17050, 34050, 46050, 57550 },
+  /* i_lo  */ {     0,    51,   101,   201,   301,   401 },
+  /* i_hi  */ {    50,   100,   200,   300,   400,   500 },
+  /* c_lo  */ {     0,  5100, 10100, 17100, 34100, 46100 },
+  /* c_hi  */ {  5000, 10000, 17000, 34000, 46000, 57500 },
+};
+
+static const breakpoint_table_t SINGAPORE_PSI_NO2_1H = {
+  3, 0, 501,
+  /* c_max */ { 2260.5, 3000.5, 3750.5 },
+  /* i_lo  */ {    201,    301,    401 },
+  /* i_hi  */ {    300,    400,    500 },
+  /* c_lo  */ {   1131,   2261,   3001 },
+  /* c_hi  */ {   2260,   3000,   3750 },
+};
+
+static const breakpoint_table_t SINGAPORE_PSI_O3 = {
+  6, 0, 501,
+  /* c_max */ {  118.5,  157.5,  235.5,  785.5,  980.5, 1180.5 },
+  /* i_lo  */ {      0,     51,    101,    201,    301,    401 },
+  /* i_hi  */ {     50,    100,    200,    300,    400,    500 },
+  /* c_lo  */ {      0,    119,    158,    236,    786,    981 },
+  /* c_hi  */ {    118,    157,    235,    785,    980,   1180 },
+};
+
+static const breakpoint_table_t SINGAPORE_PSI_SO2_24H = {
+  6, 0, 501,
+  /* c_max */ {   80.5,  365.5,  800.5, 1600.5, 2100.5, 2620.5 },
+  /* i_lo  */ {      0,     51,    101,    201,    301,    401 },
+  /* i_hi  */ {     50,    100,    200,    300,    400,    500 },
+  /* c_lo  */ {      0,     81,    366,    801,   1601,   2101 },
+  /* c_hi  */ {     80,    365,    800,   1600,   2100,   2620 },
+};
+
+static const breakpoint_table_t SINGAPORE_PSI_PM10_24H = {
+  6, 0, 501,
+  /* c_max */ {  50.5, 150.5, 350.5, 420.5, 500.5, 600.5 },
+  /* i_lo  */ {     0,    51,   101,   201,   301,   401 },
+  /* i_hi  */ {    50,   100,   200,   300,   400,   500 },
+  /* c_lo  */ {     0,    51,   151,   351,   421,   501 },
+  /* c_hi  */ {    50,   150,   350,   420,   500,   600 },
+};
+
+static const breakpoint_table_t SINGAPORE_PSI_PM2_5_24H = {
+  6, 0, 501,
+  /* c_max */ {  12.5,  55.5, 150.5, 250.5, 350.5, 500.5 },
+  /* i_lo  */ {     0,    51,   101,   201,   301,   401 },
+  /* i_hi  */ {    50,   100,   200,   300,   400,   500 },
+  /* c_lo  */ {     0,    13,    56,   151,   251,   351 },
+  /* c_hi  */ {    12,    55,   150,   250,   350,   500 },
+};
+
+/* Sub-index of NO2 given its breakpoint sub-index 'sub'. NO2 is only
+ * calculated if >= 1130 μg/m^3.
+ */
+static inline int singapore_psi_no2(float no2_1h, int sub)
+{
+  if (!(no2_1h >= 1129.5))
   {
-    // index > 10
-    return 11;
+    return 0;
   }
-} // end hong_kong_aqhi
+  return no2_1h < 1130.5 ? 200 : sub;
+} // end singapore_psi_no2
 
-/* India (AQI)
- *
- * References:
- *   https://www.aqi.in/blog/aqi/
- *   https://www.pranaair.com/blog/what-is-air-quality-index-aqi-and-its-calculation/
+/* Returns the o3 concentration the PSI uses. When the 8 hour o3 concentration
+ * is > 785 μg/m^3, the PSI sub-index is calculated using the 1 hour
+ * concentration. Below 785 μg/m^3 both share the same breakpoints.
  */
-int india_aqi(float co_8h,  float nh3_24h, float no2_24h,  float o3_8h,
-              float pb_24h, float so2_24h, float pm10_24h, float pm2_5_24h)
+static inline float singapore_psi_o3(float o3_1h, float o3_8h)
 {
-  int aqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
+  return o3_8h <= 785 ? o3_8h : o3_1h;
+} // end singapore_psi_o3
+
+AQI_API
+int singapore_psi(float co_8h,   float no2_1h,   float o3_1h, float o3_8h,
+                  float so2_24h, float pm10_24h, float pm2_5_24h)
+{
+  int psi = 0;
 
   // co    μg/m^3, Carbon Monoxide (CO)
   // 1mg/m^3 = 1000 μg/m^3
-  if (co_8h < 1050)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 1000;
-  }
-  else if (co_8h < 2050)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 1100;
-    c_hi = 2000;
-  }
-  else if (co_8h < 10050)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 2100;
-    c_hi = 10000;
-  }
-  else if (co_8h < 17050)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 10100;
-    c_hi = 17000;
-  }
-  else if (co_8h < 34050)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 17100;
-    c_hi = 34000;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_8h));
-
-  // nh3   μg/m^3, Ammonia (NH3)
-  if (nh3_24h < 200.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 200;
-  }
-  else if (nh3_24h < 400.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 201;
-    c_hi = 400;
-  }
-  else if (nh3_24h < 800.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 401;
-    c_hi = 800;
-  }
-  else if (nh3_24h < 1200.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 801;
-    c_hi = 1200;
-  }
-  else if (nh3_24h < 1800.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1201;
-    c_hi = 1800;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, nh3_24h));
+  psi = max(psi, breakpoint_aqi(&SINGAPORE_PSI_CO_8H, co_8h));
 
   // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_24h < 40.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 40;
-  }
-  else if (no2_24h < 80.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 41;
-    c_hi = 80;
-  }
-  else if (no2_24h < 180.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 81;
-    c_hi = 180;
-  }
-  else if (no2_24h < 280.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 181;
-    c_hi = 280;
-  }
-  else if (no2_24h < 400.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 281;
-    c_hi = 400;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_24h));
+  int no2 = breakpoint_aqi(&SINGAPORE_PSI_NO2_1H, no2_1h);
+  psi = max(psi, singapore_psi_no2(no2_1h, no2));
 
   // o3    μg/m^3, Ozone (O3)
-  if (o3_8h < 50.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (o3_8h < 100.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 51;
-    c_hi = 100;
-  }
-  else if (o3_8h < 168.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 101;
-    c_hi = 168;
-  }
-  else if (o3_8h < 208.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 169;
-    c_hi = 208;
-  }
-  else if (o3_8h < 748.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 209;
-    c_hi = 748;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
+  psi = max(psi, breakpoint_aqi(&SINGAPORE_PSI_O3,
+                                singapore_psi_o3(o3_1h, o3_8h)));
 
-  // pb    μg/m^3, Lead (Pb)
-  if (pb_24h < 0.55)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 0.5;
-  }
-  else if (pb_24h < 1.05)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 0.6;
-    c_hi = 1.0;
-  }
-  else if (pb_24h < 2.05)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 1.1;
-    c_hi = 2.0;
-  }
-  else if (pb_24h < 3.05)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 2.1;
-    c_hi = 3.0;
-  }
-  else if (pb_24h < 3.55)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 3.1;
-    c_hi = 3.5;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pb_24h));
+  // so2   μg/m^3, Sulfur Dioxide (SO2)
+  psi = max(psi, breakpoint_aqi(&SINGAPORE_PSI_SO2_24H, so2_24h));
+
+  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+  psi = max(psi, breakpoint_aqi(&SINGAPORE_PSI_PM10_24H, pm10_24h));
+
+  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+  psi = max(psi, breakpoint_aqi(&SINGAPORE_PSI_PM2_5_24H, pm2_5_24h));
+
+  return psi;
+} // end singapore_psi
+
+/* South Korea (CAI)
+ *
+ * References:
+ *   https://www.airkorea.or.kr/eng/khaiInfo?pMENU_NO=166
+ */
+static const breakpoint_table_t SOUTH_KOREA_CAI_CO_1H = {
+  4, 0, 501,
+  /* c_max */ {  2348.48, 10367.68, 17241.28, 57337.28 },
+  /* i_lo  */ {        0,       51,      101,      251 },
+  /* i_hi  */ {       50,      100,      250,      500 },
+  /* c_lo  */ {        0,  2405.76, 10424.96, 17298.56 },
+  /* c_hi  */ {   2291.2,  10310.4,    17184,    57280 },
+};
+
+static const breakpoint_table_t SOUTH_KOREA_CAI_NO2_1H = {
+  4, 0, 501,
+  /* c_max */ {  57.3888, 113.8368, 377.2608, 3772.608 },
+  /* i_lo  */ {        0,       51,      101,      251 },
+  /* i_hi  */ {       50,      100,      250,      500 },
+  /* c_lo  */ {        0,  58.3296, 114.7776, 378.2016 },
+  /* c_hi  */ {   56.448,  112.896,   376.32,   3763.2 },
+};
+
+static const breakpoint_table_t SOUTH_KOREA_CAI_O3_1H = {
+  4, 0, 501,
+  /* c_max */ {   59.8776,  177.6696,  295.4616, 1178.9016 },
+  /* i_lo  */ {         0,        51,       101,       251 },
+  /* i_hi  */ {        50,       100,       250,       500 },
+  /* c_lo  */ {         0,   60.8592,  178.6512,  296.4432 },
+  /* c_hi  */ {    58.896,   176.688,    294.48,   1177.92 },
+};
+
+static const breakpoint_table_t SOUTH_KOREA_CAI_SO2_1H = {
+  4, 0, 501,
+  /* c_max */ {  173.7252,  427.9572,   1271.16, 8478.6372 },
+  /* i_lo  */ {         0,        51,       101,       251 },
+  /* i_hi  */ {        50,       100,       250,       500 },
+  /* c_lo  */ {         0,  177.9624,  432.1944, 1279.6344 },
+  /* c_hi  */ {   169.488,    423.72,   1271.16,    8474.4 },
+};
+
+static const breakpoint_table_t SOUTH_KOREA_CAI_PM10_24H = {
+  4, 0, 501,
+  /* c_max */ {  30.5,  80.5, 150.5, 600.5 },
+  /* i_lo  */ {     0,    51,   101,   251 },
+  /* i_hi  */ {    50,   100,   250,   500 },
+  /* c_lo  */ {     0,    31,    81,   151 },
+  /* c_hi  */ {    30,    80,   150,   600 },
+};
+
+static const breakpoint_table_t SOUTH_KOREA_CAI_PM2_5_24H = {
+  4, 0, 501,
+  /* c_max */ {  15.5,  35.5,  75.5, 500.5 },
+  /* i_lo  */ {     0,    51,   101,   251 },
+  /* i_hi  */ {    50,   100,   250,   500 },
+  /* c_lo  */ {     0,    16,    36,    76 },
+  /* c_hi  */ {    15,    35,    75,   500 },
+};
+
+AQI_API
+int south_korea_cai(float co_1h,  float no2_1h,   float o3_1h,
+                    float so2_1h, float pm10_24h, float pm2_5_24h)
+{
+  int cai = 0;
+
+  // co    μg/m^3, Carbon Monoxide (CO)
+  // 1ppm * 1000ppb/1ppm * 1.1456 μg/m^3/ppb = 1145.6 μg/m^3
+  cai = max(cai, breakpoint_aqi(&SOUTH_KOREA_CAI_CO_1H, co_1h));
+
+  // no2   μg/m^3, Nitrogen Dioxide (NO2)
+  // 1ppm * 1000ppb/1ppm * 1.8816 μg/m^3/ppb = 1881.6 μg/m^3
+  cai = max(cai, breakpoint_aqi(&SOUTH_KOREA_CAI_NO2_1H, no2_1h));
+
+  // o3    μg/m^3, Ozone (O3)
+  // 1ppm * 1000ppb/1ppm * 1.9632 μg/m^3/ppb = 1963.2 μg/m^3
+  cai = max(cai, breakpoint_aqi(&SOUTH_KOREA_CAI_O3_1H, o3_1h));
 
   // so2   μg/m^3, Sulfur Dioxide (SO2)
-  if (so2_24h < 40.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 40;
-  }
-  else if (so2_24h < 80.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 41;
-    c_hi = 80;
-  }
-  else if (so2_24h < 380.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 81;
-    c_hi = 380;
-  }
-  else if (so2_24h < 800.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 381;
-    c_hi = 800;
-  }
-  else if (so2_24h < 1600.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 801;
-    c_hi = 1600;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
+  // 1ppm * 1000ppb/1ppm * 8.4744 μg/m^3/ppb = 8474.4 μg/m^3
+  cai = max(cai, breakpoint_aqi(&SOUTH_KOREA_CAI_SO2_1H, so2_1h));
 
   // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h < 50.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (pm10_24h < 100.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 51;
-    c_hi = 100;
-  }
-  else if (pm10_24h < 250.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 101;
-    c_hi = 250;
-  }
-  else if (pm10_24h < 350.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 251;
-    c_hi = 350;
-  }
-  else if (pm10_24h < 430.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 351;
-    c_hi = 430;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
+  cai = max(cai, breakpoint_aqi(&SOUTH_KOREA_CAI_PM10_24H, pm10_24h));
+
+  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+  cai = max(cai, breakpoint_aqi(&SOUTH_KOREA_CAI_PM2_5_24H, pm2_5_24h));
+
+  return cai;
+} // end south_korea_cai
+
+/* United Kingdom (DAQI)
+ *
+ * References:
+ *   https://uk-air.defra.gov.uk/air-pollution/daqi?view=more-info
+ *   https://en.wikipedia.org/wiki/Air_quality_index#United_Kingdom
+ *   https://uk-air.defra.gov.uk/library/reports?report_id=750
+ *
+ * DAQI of every concentration rounded to the nearest integer (μg/m^3). The
+ * last entry of each table covers everything above it. The tables are
+ * generated from the lowest concentration of each DAQI below by
+ * test/uk_daqi_lut_test.c -g, which otherwise checks them.
+ *
+ *   DAQI       1    2    3    4    5    6    7    8    9   10
+ *   no2_1h     0   68  135  201  268  335  401  468  535  601
+ *   o3_8h      0   34   67  101  121  141  161  188  214  241
+ *   so2_15min  0   89  178  267  355  444  533  711  888 1065
+ *   pm10_24h   0   17   34   51   59   67   76   84   92  101
+ *   pm2_5_24h  0   12   24   36   42   48   54   59   65   71
+ */
+// no2 (μg/m^3)
+static const uint8_t UNITED_KINGDOM_DAQI_NO2_1H_LUT[602] = {
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9, 10,
+};
+
+// o3 (μg/m^3)
+static const uint8_t UNITED_KINGDOM_DAQI_O3_8H_LUT[242] = {
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9, 10,
+};
+
+// so2 (μg/m^3)
+static const uint8_t UNITED_KINGDOM_DAQI_SO2_15MIN_LUT[1066] = {
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+   4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+   5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  7,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+   8,  8,  8,  8,  8,  8,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+   9,  9,  9, 10,
+};
+
+// pm10 (μg/m^3)
+static const uint8_t UNITED_KINGDOM_DAQI_PM10_24H_LUT[102] = {
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,
+   2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  3,  3,
+   3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  4,  4,  4,
+   4,  4,  4,  4,  4,  5,  5,  5,  5,  5,  5,  5,  5,  6,  6,  6,  6,  6,
+   6,  6,  6,  6,  7,  7,  7,  7,  7,  7,  7,  7,  8,  8,  8,  8,  8,  8,
+   8,  8,  9,  9,  9,  9,  9,  9,  9,  9,  9, 10,
+};
+
+// pm2_5 (μg/m^3)
+static const uint8_t UNITED_KINGDOM_DAQI_PM2_5_24H_LUT[72] = {
+   1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,  2,  2,  2,  2,
+   2,  2,  2,  2,  2,  2,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+   4,  4,  4,  4,  4,  4,  5,  5,  5,  5,  5,  5,  6,  6,  6,  6,  6,  6,
+   7,  7,  7,  7,  7,  8,  8,  8,  8,  8,  8,  9,  9,  9,  9,  9,  9, 10,
+};
+
+/* Returns the index of concentration c into a lookup table of length len,
+ * that is c rounded to the nearest integer (halves up) and clamped to
+ * [0, len - 1]. NaN maps to 0.
+ */
+static inline int united_kingdom_daqi_index(float c, int len)
+{
+  float r = c + 0.5f; // exact below 2^22, larger values are clamped anyway
+  return r >= len - 1 ? len - 1 : r > 0 ? (int) r : 0;
+} // end united_kingdom_daqi_index
+
+#define UNITED_KINGDOM_DAQI_LOOKUP(lut, c) \
+  (lut)[united_kingdom_daqi_index((c), sizeof(lut) / sizeof((lut)[0]))]
+
+AQI_API
+int united_kingdom_daqi(float no2_1h,   float o3_8h, float so2_15min,
+                        float pm10_24h, float pm2_5_24h)
+{
+  // Pollutant averages are rounded to nearest integer
+  int daqi = 1;
+  daqi = max(daqi, UNITED_KINGDOM_DAQI_LOOKUP(UNITED_KINGDOM_DAQI_NO2_1H_LUT,
+                                              no2_1h));
+  daqi = max(daqi, UNITED_KINGDOM_DAQI_LOOKUP(UNITED_KINGDOM_DAQI_O3_8H_LUT,
+                                              o3_8h));
+  daqi = max(daqi, UNITED_KINGDOM_DAQI_LOOKUP(UNITED_KINGDOM_DAQI_SO2_15MIN_LUT,
+                                              so2_15min));
+  daqi = max(daqi, UNITED_KINGDOM_DAQI_LOOKUP(UNITED_KINGDOM_DAQI_PM10_24H_LUT,
+                                              pm10_24h));
+  daqi = max(daqi, UNITED_KINGDOM_DAQI_LOOKUP(UNITED_KINGDOM_DAQI_PM2_5_24H_LUT,
+                                              pm2_5_24h));
+  return daqi;
+} // end united_kingdom_daqi
+
+/* United States (AQI)
+ *
+ * References:
+ *   https://www.epa.gov/outdoor-air-quality-data/how-aqi-calculated
+ *   https://www.airnow.gov/sites/default/files/2020-05/aqi-technical-assistance-document-sept2018.pdf
+ *   https://en.wikipedia.org/wiki/Air_quality_index#United_States
+ */
+static const breakpoint_table_t UNITED_STATES_AQI_CO_8H = {
+  7, 1, 501,
+  /* c_max */ {  4.4,  9.4, 12.4, 15.4, 30.4, 40.4, 50.4 },
+  /* i_lo  */ {    0,   51,  101,  151,  201,  301,  401 },
+  /* i_hi  */ {   50,  100,  150,  200,  300,  400,  500 },
+  /* c_lo  */ {    0,  4.5,  9.5, 12.5, 15.5, 30.5, 40.5 },
+  /* c_hi  */ {  4.4,  9.4, 12.4, 15.4, 30.4, 40.4, 50.4 },
+};
+
+static const breakpoint_table_t UNITED_STATES_AQI_NO2_1H = {
+  7, 1, 501,
+  /* c_max */ {   53,  100,  360,  649, 1249, 1649, 2049 },
+  /* i_lo  */ {    0,   51,  101,  151,  201,  301,  401 },
+  /* i_hi  */ {   50,  100,  150,  200,  300,  400,  500 },
+  /* c_lo  */ {    0,   54,  101,  361,  350, 1250, 1650 },
+  /* c_hi  */ {   53,  100,  360,  649, 1249, 1649, 2049 },
+};
+
+static const breakpoint_table_t UNITED_STATES_AQI_O3_1H = {
+  5, 1, 501,
+  /* c_max */ { 0.164, 0.204, 0.404,  1649,  2049 },
+  /* i_lo  */ {   101,   151,   201,   301,   401 },
+  /* i_hi  */ {   150,   200,   300,   400,   500 },
+  /* c_lo  */ { 0.125, 0.165, 0.205,  1250,  1650 },
+  /* c_hi  */ { 0.164, 0.204, 0.404,  1649,  2049 },
+};
+
+static const breakpoint_table_t UNITED_STATES_AQI_O3_8H = {
+  5, 1, 501,
+  /* c_max */ { 0.054, 0.070, 0.085, 0.105, 0.200 },
+  /* i_lo  */ {     0,    51,   101,   151,   201 },
+  /* i_hi  */ {    50,   100,   150,   200,   300 },
+  /* c_lo  */ {     0, 0.055, 0.071, 0.086, 0.106 },
+  /* c_hi  */ { 0.054, 0.070, 0.085, 0.105, 0.200 },
+};
+
+static const breakpoint_table_t UNITED_STATES_AQI_SO2 = {
+  7, 1, 501,
+  /* c_max */ {   35,   75,  185,  304,  604,  804, 1004 },
+  /* i_lo  */ {    0,   51,  101,  151,  201,  301,  401 },
+  /* i_hi  */ {   50,  100,  150,  200,  300,  400,  500 },
+  /* c_lo  */ {    0,   36,   76,  186,  305,  605,  805 },
+  /* c_hi  */ {   35,   75,  185,  304,  604,  804, 1004 },
+};
+
+static const breakpoint_table_t UNITED_STATES_AQI_PM10_24H = {
+  7, 1, 501,
+  /* c_max */ {  54, 154, 254, 354, 424, 504, 604 },
+  /* i_lo  */ {   0,  51, 101, 151, 201, 301, 401 },
+  /* i_hi  */ {  50, 100, 150, 200, 300, 400, 500 },
+  /* c_lo  */ {   0,  55, 155, 255, 355, 425, 505 },
+  /* c_hi  */ {  54, 154, 254, 354, 424, 504, 604 },
+};
+
+static const breakpoint_table_t UNITED_STATES_AQI_PM2_5_24H = {
+  7, 1, 501,
+  /* c_max */ {  12.0,  35.4,  55.4, 150.4, 250.4, 350.4, 500.4 },
+  /* i_lo  */ {     0,    51,   101,   151,   201,   301,   401 },
+  /* i_hi  */ {    50,   100,   150,   200,   300,   400,   500 },
+  /* c_lo  */ {     0,  12.1,  35.5,  55.5, 150.5, 250.5, 350.5 },
+  /* c_hi  */ {  12.0,  35.4,  55.4, 150.4, 250.4, 350.4, 500.4 },
+};
+
+/* Sub-index of every truncated concentration, generated from the tables above
+ * with breakpoint_aqi(), see united_states_aqi(). Indexed in units of the last
+ * decimal place kept by the truncation. Regenerate them with
+ * test/us_aqi_lut_test.c -g, which otherwise checks them.
+ */
+// co (0.1 ppm), the last entry covers everything above
+static const uint16_t UNITED_STATES_AQI_CO_8H_LUT[506] = {
+    0,   1,   2,   3,   5,   6,   7,   8,   9,  10,  11,  13,  14,  15,  16,  17,
+   18,  19,  20,  22,  23,  24,  25,  26,  27,  28,  30,  31,  32,  33,  34,  35,
+   36,  38,  39,  40,  41,  42,  43,  44,  45,  47,  48,  49,  51,  51,  52,  53,
+   54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,
+   70,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,  84,  85,
+   86,  87,  88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,  99, 100, 101,
+  103, 104, 106, 108, 109, 111, 113, 115, 116, 118, 120, 121, 123, 125, 126, 128,
+  130, 131, 133, 135, 136, 138, 140, 142, 143, 145, 147, 148, 150, 151, 153, 154,
+  156, 158, 159, 161, 163, 165, 166, 168, 170, 171, 173, 175, 176, 178, 180, 181,
+  183, 185, 186, 188, 190, 192, 193, 195, 197, 198, 200, 201, 202, 202, 203, 204,
+  204, 205, 206, 206, 207, 208, 208, 209, 210, 210, 211, 212, 212, 213, 214, 214,
+  215, 216, 216, 217, 218, 218, 219, 220, 220, 221, 222, 222, 223, 224, 224, 225,
+  226, 226, 227, 228, 228, 229, 230, 230, 231, 232, 232, 233, 234, 234, 235, 236,
+  236, 237, 238, 238, 239, 240, 240, 241, 242, 242, 243, 244, 244, 245, 246, 246,
+  247, 248, 248, 249, 250, 250, 251, 251, 252, 253, 253, 254, 255, 255, 256, 257,
+  257, 258, 259, 259, 260, 261, 261, 262, 263, 263, 264, 265, 265, 266, 267, 267,
+  268, 269, 269, 270, 271, 271, 272, 273, 273, 274, 275, 275, 276, 277, 277, 278,
+  279, 279, 280, 281, 281, 282, 283, 283, 284, 285, 285, 286, 287, 287, 288, 289,
+  289, 290, 291, 291, 292, 293, 293, 294, 295, 295, 296, 297, 297, 298, 299, 299,
+  300, 301, 302, 303, 304, 305, 306, 307, 308, 309, 310, 311, 312, 313, 314, 315,
+  316, 317, 318, 319, 320, 321, 322, 323, 324, 325, 326, 327, 328, 329, 330, 331,
+  332, 333, 334, 335, 336, 337, 338, 339, 340, 341, 342, 343, 344, 345, 346, 347,
+  348, 349, 350, 351, 352, 353, 354, 355, 356, 357, 358, 359, 360, 361, 362, 363,
+  364, 365, 366, 367, 368, 369, 370, 371, 372, 373, 374, 375, 376, 377, 378, 379,
+  380, 381, 382, 383, 384, 385, 386, 387, 388, 389, 390, 391, 392, 393, 394, 395,
+  396, 397, 398, 399, 401, 401, 402, 403, 404, 405, 406, 407, 408, 409, 410, 411,
+  412, 413, 414, 415, 416, 417, 418, 419, 420, 421, 422, 423, 424, 425, 426, 427,
+  428, 429, 430, 431, 432, 433, 434, 435, 436, 437, 438, 439, 440, 441, 442, 443,
+  444, 445, 446, 447, 448, 449, 450, 451, 452, 453, 454, 455, 456, 457, 458, 459,
+  460, 461, 462, 463, 464, 465, 466, 467, 468, 469, 470, 471, 472, 473, 474, 475,
+  476, 477, 478, 479, 480, 481, 482, 483, 484, 485, 486, 487, 488, 489, 490, 491,
+  492, 493, 494, 495, 496, 497, 498, 499, 501, 501,
+};
+
+// no2 (ppb), the last entry covers everything above
+static const uint16_t UNITED_STATES_AQI_NO2_1H_LUT[2051] = {
+    0,   1,   2,   3,   4,   5,   6,   7,   8,   8,   9,  10,  11,  12,  13,  14,
+   15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  25,  26,  27,  28,  29,
+   30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  42,  43,  44,
+   45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  60,  61,
+   62,  63,  64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  76,  77,  78,
+   79,  80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  93,  94,  95,
+   96,  97,  98,  99, 100, 101, 101, 101, 102, 102, 102, 102, 102, 103, 103, 103,
+  103, 103, 103, 104, 104, 104, 104, 104, 105, 105, 105, 105, 105, 106, 106, 106,
+  106, 106, 106, 107, 107, 107, 107, 107, 108, 108, 108, 108, 108, 109, 109, 109,
+  109, 109, 110, 110, 110, 110, 110, 110, 111, 111, 111, 111, 111, 112, 112, 112,
+  112, 112, 113, 113, 113, 113, 113, 113, 114, 114, 114, 114, 114, 115, 115, 115,
+  115, 115, 116, 116, 116, 116, 116, 117, 117, 117, 117, 117, 117, 118, 118, 118,
+  118, 118, 119, 119, 119, 119, 119, 120, 120, 120, 120, 120, 120, 121, 121, 121,
+  121, 121, 122, 122, 122, 122, 122, 123, 123, 123, 123, 123, 124, 124, 124, 124,
+  124, 124, 125, 125, 125, 125, 125, 126, 126, 126, 126, 126, 127, 127, 127, 127,
+  127, 127, 128, 128, 128, 128, 128, 129, 129, 129, 129, 129, 130, 130, 130, 130,
+  130, 131, 131, 131, 131, 131, 131, 132, 132, 132, 132, 132, 133, 133, 133, 133,
+  133, 134, 134, 134, 134, 134, 134, 135, 135, 135, 135, 135, 136, 136, 136, 136,
+  136, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138, 139, 139, 139, 139,
+  139, 140, 140, 140, 140, 140, 141, 141, 141, 141, 141, 141, 142, 142, 142, 142,
+  142, 143, 143, 143, 143, 143, 144, 144, 144, 144, 144, 145, 145, 145, 145, 145,
+  145, 146, 146, 146, 146, 146, 147, 147, 147, 147, 147, 148, 148, 148, 148, 148,
+  148, 149, 149, 149, 149, 149, 150, 150, 150, 151, 151, 151, 152, 152, 152, 152,
+  152, 152, 153, 153, 153, 153, 153, 153, 154, 154, 154, 154, 154, 154, 155, 155,
+  155, 155, 155, 155, 156, 156, 156, 156, 156, 156, 157, 157, 157, 157, 157, 157,
+  158, 158, 158, 158, 158, 158, 159, 159, 159, 159, 159, 160, 160, 160, 160, 160,
+  160, 161, 161, 161, 161, 161, 161, 162, 162, 162, 162, 162, 162, 163, 163, 163,
+  163, 163, 163, 164, 164, 164, 164, 164, 164, 165, 165, 165, 165, 165, 165, 166,
+  166, 166, 166, 166, 166, 167, 167, 167, 167, 167, 168, 168, 168, 168, 168, 168,
+  169, 169, 169, 169, 169, 169, 170, 170, 170, 170, 170, 170, 171, 171, 171, 171,
+  171, 171, 172, 172, 172, 172, 172, 172, 173, 173, 173, 173, 173, 173, 174, 174,
+  174, 174, 174, 174, 175, 175, 175, 175, 175, 176, 176, 176, 176, 176, 176, 177,
+  177, 177, 177, 177, 177, 178, 178, 178, 178, 178, 178, 179, 179, 179, 179, 179,
+  179, 180, 180, 180, 180, 180, 180, 181, 181, 181, 181, 181, 181, 182, 182, 182,
+  182, 182, 182, 183, 183, 183, 183, 183, 183, 184, 184, 184, 184, 184, 185, 185,
+  185, 185, 185, 185, 186, 186, 186, 186, 186, 186, 187, 187, 187, 187, 187, 187,
+  188, 188, 188, 188, 188, 188, 189, 189, 189, 189, 189, 189, 190, 190, 190, 190,
+  190, 190, 191, 191, 191, 191, 191, 191, 192, 192, 192, 192, 192, 193, 193, 193,
+  193, 193, 193, 194, 194, 194, 194, 194, 194, 195, 195, 195, 195, 195, 195, 196,
+  196, 196, 196, 196, 196, 197, 197, 197, 197, 197, 197, 198, 198, 198, 198, 198,
+  198, 199, 199, 199, 199, 199, 199, 200, 200, 200, 234, 234, 234, 234, 234, 235,
+  235, 235, 235, 235, 235, 235, 235, 235, 236, 236, 236, 236, 236, 236, 236, 236,
+  236, 237, 237, 237, 237, 237, 237, 237, 237, 237, 238, 238, 238, 238, 238, 238,
+  238, 238, 238, 239, 239, 239, 239, 239, 239, 239, 239, 239, 240, 240, 240, 240,
+  240, 240, 240, 240, 240, 241, 241, 241, 241, 241, 241, 241, 241, 241, 242, 242,
+  242, 242, 242, 242, 242, 242, 242, 243, 243, 243, 243, 243, 243, 243, 243, 243,
+  244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 245, 245, 245, 245, 245, 245,
+  245, 245, 245, 246, 246, 246, 246, 246, 246, 246, 246, 246, 247, 247, 247, 247,
+  247, 247, 247, 247, 247, 248, 248, 248, 248, 248, 248, 248, 248, 248, 249, 249,
+  249, 249, 249, 249, 249, 249, 249, 250, 250, 250, 250, 250, 250, 250, 250, 250,
+  251, 251, 251, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252, 252, 252, 252,
+  252, 252, 253, 253, 253, 253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254,
+  254, 254, 254, 254, 255, 255, 255, 255, 255, 255, 255, 255, 255, 256, 256, 256,
+  256, 256, 256, 256, 256, 256, 257, 257, 257, 257, 257, 257, 257, 257, 257, 257,
+  258, 258, 258, 258, 258, 258, 258, 258, 258, 259, 259, 259, 259, 259, 259, 259,
+  259, 259, 260, 260, 260, 260, 260, 260, 260, 260, 260, 261, 261, 261, 261, 261,
+  261, 261, 261, 261, 262, 262, 262, 262, 262, 262, 262, 262, 262, 263, 263, 263,
+  263, 263, 263, 263, 263, 263, 264, 264, 264, 264, 264, 264, 264, 264, 264, 265,
+  265, 265, 265, 265, 265, 265, 265, 265, 266, 266, 266, 266, 266, 266, 266, 266,
+  266, 267, 267, 267, 267, 267, 267, 267, 267, 267, 268, 268, 268, 268, 268, 268,
+  268, 268, 268, 269, 269, 269, 269, 269, 269, 269, 269, 269, 269, 270, 270, 270,
+  270, 270, 270, 270, 270, 270, 271, 271, 271, 271, 271, 271, 271, 271, 271, 272,
+  272, 272, 272, 272, 272, 272, 272, 272, 273, 273, 273, 273, 273, 273, 273, 273,
+  273, 274, 274, 274, 274, 274, 274, 274, 274, 274, 275, 275, 275, 275, 275, 275,
+  275, 275, 275, 276, 276, 276, 276, 276, 276, 276, 276, 276, 277, 277, 277, 277,
+  277, 277, 277, 277, 277, 278, 278, 278, 278, 278, 278, 278, 278, 278, 279, 279,
+  279, 279, 279, 279, 279, 279, 279, 280, 280, 280, 280, 280, 280, 280, 280, 280,
+  281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 282, 282, 282, 282, 282, 282,
+  282, 282, 282, 283, 283, 283, 283, 283, 283, 283, 283, 283, 284, 284, 284, 284,
+  284, 284, 284, 284, 284, 285, 285, 285, 285, 285, 285, 285, 285, 285, 286, 286,
+  286, 286, 286, 286, 286, 286, 286, 287, 287, 287, 287, 287, 287, 287, 287, 287,
+  288, 288, 288, 288, 288, 288, 288, 288, 288, 289, 289, 289, 289, 289, 289, 289,
+  289, 289, 290, 290, 290, 290, 290, 290, 290, 290, 290, 291, 291, 291, 291, 291,
+  291, 291, 291, 291, 292, 292, 292, 292, 292, 292, 292, 292, 292, 293, 293, 293,
+  293, 293, 293, 293, 293, 293, 294, 294, 294, 294, 294, 294, 294, 294, 294, 294,
+  295, 295, 295, 295, 295, 295, 295, 295, 295, 296, 296, 296, 296, 296, 296, 296,
+  296, 296, 297, 297, 297, 297, 297, 297, 297, 297, 297, 298, 298, 298, 298, 298,
+  298, 298, 298, 298, 299, 299, 299, 299, 299, 299, 299, 299, 299, 300, 300, 300,
+  300, 300, 301, 301, 301, 302, 302, 302, 302, 303, 303, 303, 303, 304, 304, 304,
+  304, 305, 305, 305, 305, 306, 306, 306, 306, 307, 307, 307, 307, 308, 308, 308,
+  308, 309, 309, 309, 309, 310, 310, 310, 310, 311, 311, 311, 311, 312, 312, 312,
+  312, 313, 313, 313, 313, 314, 314, 314, 314, 315, 315, 315, 315, 316, 316, 316,
+  316, 317, 317, 317, 317, 318, 318, 318, 318, 319, 319, 319, 319, 320, 320, 320,
+  320, 321, 321, 321, 321, 322, 322, 322, 322, 323, 323, 323, 323, 324, 324, 324,
+  324, 325, 325, 325, 325, 326, 326, 326, 326, 327, 327, 327, 327, 328, 328, 328,
+  328, 329, 329, 329, 329, 330, 330, 330, 330, 331, 331, 331, 331, 332, 332, 332,
+  332, 333, 333, 333, 333, 334, 334, 334, 334, 334, 335, 335, 335, 335, 336, 336,
+  336, 336, 337, 337, 337, 337, 338, 338, 338, 338, 339, 339, 339, 339, 340, 340,
+  340, 340, 341, 341, 341, 341, 342, 342, 342, 342, 343, 343, 343, 343, 344, 344,
+  344, 344, 345, 345, 345, 345, 346, 346, 346, 346, 347, 347, 347, 347, 348, 348,
+  348, 348, 349, 349, 349, 349, 350, 350, 350, 350, 351, 351, 351, 351, 352, 352,
+  352, 352, 353, 353, 353, 353, 354, 354, 354, 354, 355, 355, 355, 355, 356, 356,
+  356, 356, 357, 357, 357, 357, 358, 358, 358, 358, 359, 359, 359, 359, 360, 360,
+  360, 360, 361, 361, 361, 361, 362, 362, 362, 362, 363, 363, 363, 363, 364, 364,
+  364, 364, 365, 365, 365, 365, 366, 366, 366, 366, 367, 367, 367, 367, 367, 368,
+  368, 368, 368, 369, 369, 369, 369, 370, 370, 370, 370, 371, 371, 371, 371, 372,
+  372, 372, 372, 373, 373, 373, 373, 374, 374, 374, 374, 375, 375, 375, 375, 376,
+  376, 376, 376, 377, 377, 377, 377, 378, 378, 378, 378, 379, 379, 379, 379, 380,
+  380, 380, 380, 381, 381, 381, 381, 382, 382, 382, 382, 383, 383, 383, 383, 384,
+  384, 384, 384, 385, 385, 385, 385, 386, 386, 386, 386, 387, 387, 387, 387, 388,
+  388, 388, 388, 389, 389, 389, 389, 390, 390, 390, 390, 391, 391, 391, 391, 392,
+  392, 392, 392, 393, 393, 393, 393, 394, 394, 394, 394, 395, 395, 395, 395, 396,
+  396, 396, 396, 397, 397, 397, 397, 398, 398, 398, 398, 399, 399, 399, 399, 400,
+  400, 400, 401, 401, 401, 402, 402, 402, 402, 403, 403, 403, 403, 404, 404, 404,
+  404, 405, 405, 405, 405, 406, 406, 406, 406, 407, 407, 407, 407, 408, 408, 408,
+  408, 409, 409, 409, 409, 410, 410, 410, 410, 411, 411, 411, 411, 412, 412, 412,
+  412, 413, 413, 413, 413, 414, 414, 414, 414, 415, 415, 415, 415, 416, 416, 416,
+  416, 417, 417, 417, 417, 418, 418, 418, 418, 419, 419, 419, 419, 420, 420, 420,
+  420, 421, 421, 421, 421, 422, 422, 422, 422, 423, 423, 423, 423, 424, 424, 424,
+  424, 425, 425, 425, 425, 426, 426, 426, 426, 427, 427, 427, 427, 428, 428, 428,
+  428, 429, 429, 429, 429, 430, 430, 430, 430, 431, 431, 431, 431, 432, 432, 432,
+  432, 433, 433, 433, 433, 434, 434, 434, 434, 434, 435, 435, 435, 435, 436, 436,
+  436, 436, 437, 437, 437, 437, 438, 438, 438, 438, 439, 439, 439, 439, 440, 440,
+  440, 440, 441, 441, 441, 441, 442, 442, 442, 442, 443, 443, 443, 443, 444, 444,
+  444, 444, 445, 445, 445, 445, 446, 446, 446, 446, 447, 447, 447, 447, 448, 448,
+  448, 448, 449, 449, 449, 449, 450, 450, 450, 450, 451, 451, 451, 451, 452, 452,
+  452, 452, 453, 453, 453, 453, 454, 454, 454, 454, 455, 455, 455, 455, 456, 456,
+  456, 456, 457, 457, 457, 457, 458, 458, 458, 458, 459, 459, 459, 459, 460, 460,
+  460, 460, 461, 461, 461, 461, 462, 462, 462, 462, 463, 463, 463, 463, 464, 464,
+  464, 464, 465, 465, 465, 465, 466, 466, 466, 466, 467, 467, 467, 467, 467, 468,
+  468, 468, 468, 469, 469, 469, 469, 470, 470, 470, 470, 471, 471, 471, 471, 472,
+  472, 472, 472, 473, 473, 473, 473, 474, 474, 474, 474, 475, 475, 475, 475, 476,
+  476, 476, 476, 477, 477, 477, 477, 478, 478, 478, 478, 479, 479, 479, 479, 480,
+  480, 480, 480, 481, 481, 481, 481, 482, 482, 482, 482, 483, 483, 483, 483, 484,
+  484, 484, 484, 485, 485, 485, 485, 486, 486, 486, 486, 487, 487, 487, 487, 488,
+  488, 488, 488, 489, 489, 489, 489, 490, 490, 490, 490, 491, 491, 491, 491, 492,
+  492, 492, 492, 493, 493, 493, 493, 494, 494, 494, 494, 495, 495, 495, 495, 496,
+  496, 496, 496, 497, 497, 497, 497, 498, 498, 498, 498, 499, 499, 499, 499, 500,
+  500, 500, 501,
+};
+
+// o3 1 hour (0.001 ppm), 0 below 0.125 ppm
+static const uint16_t UNITED_STATES_AQI_O3_1H_LUT[405] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 101, 102, 104,
+  105, 106, 107, 109, 110, 111, 112, 114, 115, 116, 117, 119, 120, 121, 122, 124,
+  125, 126, 127, 129, 130, 131, 132, 134, 135, 136, 137, 139, 140, 141, 142, 144,
+  145, 146, 147, 149, 151, 151, 152, 154, 155, 156, 157, 159, 160, 161, 162, 164,
+  165, 166, 167, 169, 170, 171, 172, 174, 175, 176, 177, 179, 180, 181, 182, 184,
+  185, 186, 187, 189, 190, 191, 192, 194, 195, 196, 197, 199, 200, 201, 201, 202,
+  202, 203, 203, 204, 204, 205, 205, 206, 206, 207, 207, 208, 208, 209, 209, 210,
+  210, 211, 211, 212, 212, 213, 213, 214, 214, 215, 215, 216, 216, 217, 217, 218,
+  218, 219, 219, 220, 220, 221, 221, 222, 222, 223, 223, 224, 224, 225, 225, 226,
+  226, 227, 227, 228, 228, 229, 229, 230, 230, 231, 231, 232, 232, 233, 233, 234,
+  234, 235, 235, 236, 236, 237, 237, 238, 238, 239, 239, 240, 240, 241, 241, 242,
+  242, 243, 243, 244, 244, 245, 245, 246, 246, 247, 247, 248, 248, 249, 249, 250,
+  250, 251, 251, 252, 252, 253, 253, 254, 254, 255, 255, 256, 256, 257, 257, 258,
+  258, 259, 259, 260, 260, 261, 261, 262, 262, 263, 263, 264, 264, 265, 265, 266,
+  266, 267, 267, 268, 268, 269, 269, 270, 270, 271, 271, 272, 272, 273, 273, 274,
+  274, 275, 275, 276, 276, 277, 277, 278, 278, 279, 279, 280, 280, 281, 281, 282,
+  282, 283, 283, 284, 284, 285, 285, 286, 286, 287, 287, 288, 288, 289, 289, 290,
+  290, 291, 291, 292, 292, 293, 293, 294, 294, 295, 295, 296, 296, 297, 297, 298,
+  298, 299, 299, 300, 301,
+};
+
+// o3 8 hour (0.001 ppm), 0 above 0.200 ppm
+static const uint16_t UNITED_STATES_AQI_O3_8H_LUT[201] = {
+    0,   1,   2,   3,   4,   5,   6,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+   15,  16,  17,  18,  19,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,
+   30,  31,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,
+   44,  45,  46,  47,  48,  49,  51,  51,  54,  58,  61,  64,  67,  71,  74,  77,
+   80,  84,  87,  90,  93,  97, 101, 101, 104, 108, 112, 115, 118, 122, 126, 129,
+  132, 136, 140, 143, 147, 151, 151, 154, 156, 159, 161, 164, 166, 169, 172, 174,
+  177, 179, 182, 185, 187, 190, 192, 195, 197, 200, 201, 202, 203, 204, 205, 206,
+  207, 208, 209, 210, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+  224, 225, 226, 227, 228, 229, 230, 232, 233, 234, 235, 236, 237, 238, 239, 240,
+  241, 242, 243, 244, 245, 246, 247, 248, 249, 251, 252, 253, 254, 255, 256, 257,
+  258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268, 269, 271, 272, 273, 274,
+  275, 276, 277, 278, 279, 280, 281, 282, 283, 284, 285, 286, 287, 288, 289, 291,
+  292, 293, 294, 295, 296, 297, 298, 299,   0,
+};
+
+// so2 1 hour (ppb), only used up to 185 ppb
+static const uint16_t UNITED_STATES_AQI_SO2_1H_LUT[186] = {
+    0,   1,   3,   4,   6,   7,   9,  10,  11,  13,  14,  16,  17,  19,  20,  21,
+   23,  24,  26,  27,  29,  30,  31,  33,  34,  36,  37,  39,  40,  41,  43,  44,
+   46,  47,  49,  50,  51,  52,  54,  55,  56,  57,  59,  60,  61,  62,  64,  65,
+   66,  67,  69,  70,  71,  72,  74,  75,  76,  77,  79,  80,  81,  82,  84,  85,
+   86,  87,  89,  90,  91,  92,  94,  95,  96,  97,  99, 100, 101, 101, 102, 102,
+  103, 103, 104, 104, 105, 105, 105, 106, 106, 107, 107, 108, 108, 109, 109, 110,
+  110, 110, 111, 111, 112, 112, 113, 113, 114, 114, 114, 115, 115, 116, 116, 117,
+  117, 118, 118, 119, 119, 119, 120, 120, 121, 121, 122, 122, 123, 123, 123, 124,
+  124, 125, 125, 126, 126, 127, 127, 128, 128, 128, 129, 129, 130, 130, 131, 131,
+  132, 132, 132, 133, 133, 134, 134, 135, 135, 136, 136, 137, 137, 137, 138, 138,
+  139, 139, 140, 140, 141, 141, 141, 142, 142, 143, 143, 144, 144, 145, 145, 146,
+  146, 146, 147, 147, 148, 148, 149, 149, 150, 150,
+};
+
+// pm10 (μg/m^3), the last entry covers everything above
+static const uint16_t UNITED_STATES_AQI_PM10_24H_LUT[606] = {
+    0,   1,   2,   3,   4,   5,   6,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+   15,  16,  17,  18,  19,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,
+   30,  31,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,
+   44,  45,  46,  47,  48,  49,  50,  51,  51,  52,  52,  53,  53,  54,  54,  55,
+   55,  56,  56,  57,  57,  58,  58,  59,  59,  60,  60,  61,  61,  62,  62,  63,
+   63,  64,  64,  65,  65,  66,  66,  67,  67,  68,  68,  69,  69,  70,  70,  71,
+   71,  72,  72,  73,  73,  74,  74,  75,  75,  76,  76,  77,  77,  78,  78,  79,
+   79,  80,  80,  81,  81,  82,  82,  83,  83,  84,  84,  85,  85,  86,  86,  87,
+   87,  88,  88,  89,  89,  90,  90,  91,  91,  92,  92,  93,  93,  94,  94,  95,
+   95,  96,  96,  97,  97,  98,  98,  99,  99, 100, 100, 101, 101, 102, 102, 103,
+  103, 104, 104, 105, 105, 106, 106, 107, 107, 108, 108, 109, 109, 110, 110, 111,
+  111, 112, 112, 113, 113, 114, 114, 115, 115, 116, 116, 117, 117, 118, 118, 119,
+  119, 120, 120, 121, 121, 122, 122, 123, 123, 124, 124, 125, 125, 126, 126, 127,
+  127, 128, 128, 129, 129, 130, 130, 131, 131, 132, 132, 133, 133, 134, 134, 135,
+  135, 136, 136, 137, 137, 138, 138, 139, 139, 140, 140, 141, 141, 142, 142, 143,
+  143, 144, 144, 145, 145, 146, 146, 147, 147, 148, 148, 149, 149, 150, 150, 151,
+  151, 152, 152, 153, 153, 154, 154, 155, 155, 156, 156, 157, 157, 158, 158, 159,
+  159, 160, 160, 161, 161, 162, 162, 163, 163, 164, 164, 165, 165, 166, 166, 167,
+  167, 168, 168, 169, 169, 170, 170, 171, 171, 172, 172, 173, 173, 174, 174, 175,
+  175, 176, 176, 177, 177, 178, 178, 179, 179, 180, 180, 181, 181, 182, 182, 183,
+  183, 184, 184, 185, 185, 186, 186, 187, 187, 188, 188, 189, 189, 190, 190, 191,
+  191, 192, 192, 193, 193, 194, 194, 195, 195, 196, 196, 197, 197, 198, 198, 199,
+  199, 200, 200, 201, 202, 204, 205, 207, 208, 210, 211, 212, 214, 215, 217, 218,
+  220, 221, 223, 224, 225, 227, 228, 230, 231, 233, 234, 235, 237, 238, 240, 241,
+  243, 244, 245, 247, 248, 250, 251, 253, 254, 256, 257, 258, 260, 261, 263, 264,
+  266, 267, 268, 270, 271, 273, 274, 276, 277, 278, 280, 281, 283, 284, 286, 287,
+  289, 290, 291, 293, 294, 296, 297, 299, 300, 301, 302, 304, 305, 306, 307, 309,
+  310, 311, 312, 314, 315, 316, 317, 319, 320, 321, 322, 324, 325, 326, 327, 329,
+  330, 331, 332, 334, 335, 336, 337, 339, 340, 341, 342, 344, 345, 346, 347, 349,
+  350, 351, 352, 354, 355, 356, 357, 359, 360, 361, 362, 364, 365, 366, 367, 369,
+  370, 371, 372, 374, 375, 376, 377, 379, 380, 381, 382, 384, 385, 386, 387, 389,
+  390, 391, 392, 394, 395, 396, 397, 399, 400, 401, 402, 403, 404, 405, 406, 407,
+  408, 409, 410, 411, 412, 413, 414, 415, 416, 417, 418, 419, 420, 421, 422, 423,
+  424, 425, 426, 427, 428, 429, 430, 431, 432, 433, 434, 435, 436, 437, 438, 439,
+  440, 441, 442, 443, 444, 445, 446, 447, 448, 449, 450, 451, 452, 453, 454, 455,
+  456, 457, 458, 459, 460, 461, 462, 463, 464, 465, 466, 467, 468, 469, 470, 471,
+  472, 473, 474, 475, 476, 477, 478, 479, 480, 481, 482, 483, 484, 485, 486, 487,
+  488, 489, 490, 491, 492, 493, 494, 495, 496, 497, 498, 499, 500, 501,
+};
+
+// pm2_5 (0.1 μg/m^3), the last entry covers everything above
+static const uint16_t UNITED_STATES_AQI_PM2_5_24H_LUT[5006] = {
+    0,   0,   1,   1,   2,   2,   3,   3,   3,   4,   4,   5,   5,   5,   6,   6,
+    7,   7,   7,   8,   8,   9,   9,  10,  10,  10,  11,  11,  12,  12,  13,  13,
+   13,  14,  14,  15,  15,  15,  16,  16,  17,  17,  17,  18,  18,  19,  19,  20,
+   20,  20,  21,  21,  22,  22,  23,  23,  23,  24,  24,  25,  25,  25,  26,  26,
+   27,  27,  27,  28,  28,  29,  29,  30,  30,  30,  31,  31,  32,  32,  33,  33,
+   33,  34,  34,  35,  35,  35,  36,  36,  37,  37,  38,  38,  38,  39,  39,  40,
+   40,  40,  41,  41,  42,  42,  42,  43,  43,  44,  44,  45,  45,  45,  46,  46,
+   47,  47,  47,  48,  48,  49,  49,  50,  50,  51,  51,  51,  52,  52,  52,  52,
+   52,  53,  53,  53,  53,  54,  54,  54,  54,  54,  55,  55,  55,  55,  55,  56,
+   56,  56,  56,  56,  57,  57,  57,  57,  58,  58,  58,  58,  58,  59,  59,  59,
+   59,  59,  60,  60,  60,  60,  60,  61,  61,  61,  61,  62,  62,  62,  62,  62,
+   63,  63,  63,  63,  63,  64,  64,  64,  64,  64,  65,  65,  65,  65,  66,  66,
+   66,  66,  66,  67,  67,  67,  67,  67,  68,  68,  68,  68,  68,  69,  69,  69,
+   69,  70,  70,  70,  70,  70,  71,  71,  71,  71,  71,  72,  72,  72,  72,  72,
+   73,  73,  73,  73,  74,  74,  74,  74,  74,  75,  75,  75,  75,  75,  76,  76,
+   76,  76,  76,  77,  77,  77,  77,  77,  78,  78,  78,  78,  79,  79,  79,  79,
+   79,  80,  80,  80,  80,  80,  81,  81,  81,  81,  81,  82,  82,  82,  82,  83,
+   83,  83,  83,  83,  84,  84,  84,  84,  84,  85,  85,  85,  85,  85,  86,  86,
+   86,  86,  87,  87,  87,  87,  87,  88,  88,  88,  88,  88,  89,  89,  89,  89,
+   89,  90,  90,  90,  90,  91,  91,  91,  91,  91,  92,  92,  92,  92,  92,  93,
+   93,  93,  93,  93,  94,  94,  94,  94,  95,  95,  95,  95,  95,  96,  96,  96,
+   96,  96,  97,  97,  97,  97,  97,  98,  98,  98,  98,  99,  99,  99,  99,  99,
+  100, 100, 101, 101, 101, 101, 102, 102, 102, 102, 103, 103, 103, 103, 104, 104,
+  104, 104, 105, 105, 105, 105, 106, 106, 106, 106, 107, 107, 107, 107, 108, 108,
+  108, 108, 109, 109, 109, 109, 110, 110, 110, 110, 111, 111, 111, 111, 112, 112,
+  112, 112, 113, 113, 113, 113, 114, 114, 114, 114, 115, 115, 115, 115, 116, 116,
+  116, 116, 117, 117, 117, 117, 117, 118, 118, 118, 118, 119, 119, 119, 119, 120,
+  120, 120, 120, 121, 121, 121, 121, 122, 122, 122, 122, 123, 123, 123, 123, 124,
+  124, 124, 124, 125, 125, 125, 125, 126, 126, 126, 126, 127, 127, 127, 127, 128,
+  128, 128, 128, 129, 129, 129, 129, 130, 130, 130, 130, 131, 131, 131, 131, 132,
+  132, 132, 132, 133, 133, 133, 133, 134, 134, 134, 134, 134, 135, 135, 135, 135,
+  136, 136, 136, 136, 137, 137, 137, 137, 138, 138, 138, 138, 139, 139, 139, 139,
+  140, 140, 140, 140, 141, 141, 141, 141, 142, 142, 142, 142, 143, 143, 143, 143,
+  144, 144, 144, 144, 145, 145, 145, 145, 146, 146, 146, 146, 147, 147, 147, 147,
+  148, 148, 148, 148, 149, 149, 149, 149, 150, 150, 151, 151, 151, 151, 151, 151,
+  151, 151, 151, 151, 151, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152,
+  152, 152, 152, 152, 152, 152, 152, 152, 152, 153, 153, 153, 153, 153, 153, 153,
+  153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 154, 154, 154, 154,
+  154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 155,
+  155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155,
+  155, 155, 155, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
+  156, 156, 156, 156, 156, 156, 157, 157, 157, 157, 157, 157, 157, 157, 157, 157,
+  157, 157, 157, 157, 157, 157, 157, 157, 157, 158, 158, 158, 158, 158, 158, 158,
+  158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 159, 159, 159,
+  159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159,
+  160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160,
+  160, 160, 160, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161,
+  161, 161, 161, 161, 161, 161, 161, 162, 162, 162, 162, 162, 162, 162, 162, 162,
+  162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 163, 163, 163, 163, 163, 163,
+  163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 164, 164,
+  164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164,
+  164, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165,
+  165, 165, 165, 165, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166,
+  166, 166, 166, 166, 166, 166, 166, 166, 167, 167, 167, 167, 167, 167, 167, 167,
+  167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 168, 168, 168, 168, 168,
+  168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 169, 169,
+  169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169,
+  169, 169, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170,
+  170, 170, 170, 170, 170, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171,
+  171, 171, 171, 171, 171, 171, 171, 171, 171, 172, 172, 172, 172, 172, 172, 172,
+  172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 173, 173, 173, 173,
+  173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 174,
+  174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
+  174, 174, 174, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175,
+  175, 175, 175, 175, 175, 175, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
+  176, 176, 176, 176, 176, 176, 176, 176, 176, 177, 177, 177, 177, 177, 177, 177,
+  177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 178, 178, 178,
+  178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178,
+  179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179,
+  179, 179, 179, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180,
+  180, 180, 180, 180, 180, 180, 180, 181, 181, 181, 181, 181, 181, 181, 181, 181,
+  181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 182, 182, 182, 182, 182, 182,
+  182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 183, 183,
+  183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183,
+  183, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184,
+  184, 184, 184, 184, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185,
+  185, 185, 185, 185, 185, 185, 185, 185, 186, 186, 186, 186, 186, 186, 186, 186,
+  186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 187, 187, 187, 187, 187,
+  187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 188, 188,
+  188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188,
+  188, 188, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189,
+  189, 189, 189, 189, 189, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190,
+  190, 190, 190, 190, 190, 190, 190, 190, 190, 191, 191, 191, 191, 191, 191, 191,
+  191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 192, 192, 192, 192,
+  192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 193,
+  193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193,
+  193, 193, 193, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194,
+  194, 194, 194, 194, 194, 194, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195,
+  195, 195, 195, 195, 195, 195, 195, 195, 195, 196, 196, 196, 196, 196, 196, 196,
+  196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 197, 197, 197,
+  197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197,
+  198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198,
+  198, 198, 198, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+  199, 199, 199, 199, 199, 199, 199, 200, 200, 200, 200, 200, 200, 200, 200, 200,
+  200, 201, 201, 201, 201, 201, 201, 202, 202, 202, 202, 202, 202, 202, 202, 202,
+  202, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 204, 204, 204, 204, 204,
+  204, 204, 204, 204, 204, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 206,
+  206, 206, 206, 206, 206, 206, 206, 206, 206, 207, 207, 207, 207, 207, 207, 207,
+  207, 207, 207, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 209, 209, 209,
+  209, 209, 209, 209, 209, 209, 209, 210, 210, 210, 210, 210, 210, 210, 210, 210,
+  210, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 212, 212, 212, 212, 212,
+  212, 212, 212, 212, 212, 212, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213,
+  214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 215, 215, 215, 215, 215, 215,
+  215, 215, 215, 215, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 217, 217,
+  217, 217, 217, 217, 217, 217, 217, 217, 218, 218, 218, 218, 218, 218, 218, 218,
+  218, 218, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 220, 220, 220, 220,
+  220, 220, 220, 220, 220, 220, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+  222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 223, 223, 223, 223, 223, 223,
+  223, 223, 223, 223, 223, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 225,
+  225, 225, 225, 225, 225, 225, 225, 225, 225, 226, 226, 226, 226, 226, 226, 226,
+  226, 226, 226, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 228, 228, 228,
+  228, 228, 228, 228, 228, 228, 228, 229, 229, 229, 229, 229, 229, 229, 229, 229,
+  229, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 231, 231, 231, 231, 231,
+  231, 231, 231, 231, 231, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 233,
+  233, 233, 233, 233, 233, 233, 233, 233, 233, 234, 234, 234, 234, 234, 234, 234,
+  234, 234, 234, 234, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 236, 236,
+  236, 236, 236, 236, 236, 236, 236, 236, 237, 237, 237, 237, 237, 237, 237, 237,
+  237, 237, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 239, 239, 239, 239,
+  239, 239, 239, 239, 239, 239, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240,
+  241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 242, 242, 242, 242, 242, 242,
+  242, 242, 242, 242, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 244, 244,
+  244, 244, 244, 244, 244, 244, 244, 244, 245, 245, 245, 245, 245, 245, 245, 245,
+  245, 245, 245, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 247, 247, 247,
+  247, 247, 247, 247, 247, 247, 247, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+  248, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 250, 250, 250, 250, 250,
+  250, 250, 250, 250, 250, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 252,
+  252, 252, 252, 252, 252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 253, 253,
+  253, 253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+  256, 256, 257, 257, 257, 257, 257, 257, 257, 257, 257, 257, 258, 258, 258, 258,
+  258, 258, 258, 258, 258, 258, 259, 259, 259, 259, 259, 259, 259, 259, 259, 259,
+  260, 260, 260, 260, 260, 260, 260, 260, 260, 260, 261, 261, 261, 261, 261, 261,
+  261, 261, 261, 261, 262, 262, 262, 262, 262, 262, 262, 262, 262, 262, 263, 263,
+  263, 263, 263, 263, 263, 263, 263, 263, 264, 264, 264, 264, 264, 264, 264, 264,
+  264, 264, 265, 265, 265, 265, 265, 265, 265, 265, 265, 265, 266, 266, 266, 266,
+  266, 266, 266, 266, 266, 266, 267, 267, 267, 267, 267, 267, 267, 267, 267, 267,
+  267, 268, 268, 268, 268, 268, 268, 268, 268, 268, 268, 269, 269, 269, 269, 269,
+  269, 269, 269, 269, 269, 270, 270, 270, 270, 270, 270, 270, 270, 270, 270, 271,
+  271, 271, 271, 271, 271, 271, 271, 271, 271, 272, 272, 272, 272, 272, 272, 272,
+  272, 272, 272, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 274, 274, 274,
+  274, 274, 274, 274, 274, 274, 274, 275, 275, 275, 275, 275, 275, 275, 275, 275,
+  275, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 277, 277, 277, 277, 277,
+  277, 277, 277, 277, 277, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278,
+  279, 279, 279, 279, 279, 279, 279, 279, 279, 279, 280, 280, 280, 280, 280, 280,
+  280, 280, 280, 280, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 282, 282,
+  282, 282, 282, 282, 282, 282, 282, 282, 283, 283, 283, 283, 283, 283, 283, 283,
+  283, 283, 284, 284, 284, 284, 284, 284, 284, 284, 284, 284, 285, 285, 285, 285,
+  285, 285, 285, 285, 285, 285, 286, 286, 286, 286, 286, 286, 286, 286, 286, 286,
+  287, 287, 287, 287, 287, 287, 287, 287, 287, 287, 288, 288, 288, 288, 288, 288,
+  288, 288, 288, 288, 289, 289, 289, 289, 289, 289, 289, 289, 289, 289, 289, 290,
+  290, 290, 290, 290, 290, 290, 290, 290, 290, 291, 291, 291, 291, 291, 291, 291,
+  291, 291, 291, 292, 292, 292, 292, 292, 292, 292, 292, 292, 292, 293, 293, 293,
+  293, 293, 293, 293, 293, 293, 293, 294, 294, 294, 294, 294, 294, 294, 294, 294,
+  294, 295, 295, 295, 295, 295, 295, 295, 295, 295, 295, 296, 296, 296, 296, 296,
+  296, 296, 296, 296, 296, 297, 297, 297, 297, 297, 297, 297, 297, 297, 297, 298,
+  298, 298, 298, 298, 298, 298, 298, 298, 298, 299, 299, 299, 299, 299, 299, 299,
+  299, 299, 299, 300, 300, 300, 300, 300, 300, 301, 301, 301, 301, 301, 301, 302,
+  302, 302, 302, 302, 302, 302, 302, 302, 302, 303, 303, 303, 303, 303, 303, 303,
+  303, 303, 303, 304, 304, 304, 304, 304, 304, 304, 304, 304, 304, 305, 305, 305,
+  305, 305, 305, 305, 305, 305, 305, 306, 306, 306, 306, 306, 306, 306, 306, 306,
+  306, 307, 307, 307, 307, 307, 307, 307, 307, 307, 307, 308, 308, 308, 308, 308,
+  308, 308, 308, 308, 308, 309, 309, 309, 309, 309, 309, 309, 309, 309, 309, 310,
+  310, 310, 310, 310, 310, 310, 310, 310, 310, 311, 311, 311, 311, 311, 311, 311,
+  311, 311, 311, 312, 312, 312, 312, 312, 312, 312, 312, 312, 312, 312, 313, 313,
+  313, 313, 313, 313, 313, 313, 313, 313, 314, 314, 314, 314, 314, 314, 314, 314,
+  314, 314, 315, 315, 315, 315, 315, 315, 315, 315, 315, 315, 316, 316, 316, 316,
+  316, 316, 316, 316, 316, 316, 317, 317, 317, 317, 317, 317, 317, 317, 317, 317,
+  318, 318, 318, 318, 318, 318, 318, 318, 318, 318, 319, 319, 319, 319, 319, 319,
+  319, 319, 319, 319, 320, 320, 320, 320, 320, 320, 320, 320, 320, 320, 321, 321,
+  321, 321, 321, 321, 321, 321, 321, 321, 322, 322, 322, 322, 322, 322, 322, 322,
+  322, 322, 323, 323, 323, 323, 323, 323, 323, 323, 323, 323, 323, 324, 324, 324,
+  324, 324, 324, 324, 324, 324, 324, 325, 325, 325, 325, 325, 325, 325, 325, 325,
+  325, 326, 326, 326, 326, 326, 326, 326, 326, 326, 326, 327, 327, 327, 327, 327,
+  327, 327, 327, 327, 327, 328, 328, 328, 328, 328, 328, 328, 328, 328, 328, 329,
+  329, 329, 329, 329, 329, 329, 329, 329, 329, 330, 330, 330, 330, 330, 330, 330,
+  330, 330, 330, 331, 331, 331, 331, 331, 331, 331, 331, 331, 331, 332, 332, 332,
+  332, 332, 332, 332, 332, 332, 332, 333, 333, 333, 333, 333, 333, 333, 333, 333,
+  333, 334, 334, 334, 334, 334, 334, 334, 334, 334, 334, 334, 335, 335, 335, 335,
+  335, 335, 335, 335, 335, 335, 336, 336, 336, 336, 336, 336, 336, 336, 336, 336,
+  337, 337, 337, 337, 337, 337, 337, 337, 337, 337, 338, 338, 338, 338, 338, 338,
+  338, 338, 338, 338, 339, 339, 339, 339, 339, 339, 339, 339, 339, 339, 340, 340,
+  340, 340, 340, 340, 340, 340, 340, 340, 341, 341, 341, 341, 341, 341, 341, 341,
+  341, 341, 342, 342, 342, 342, 342, 342, 342, 342, 342, 342, 343, 343, 343, 343,
+  343, 343, 343, 343, 343, 343, 344, 344, 344, 344, 344, 344, 344, 344, 344, 344,
+  345, 345, 345, 345, 345, 345, 345, 345, 345, 345, 345, 346, 346, 346, 346, 346,
+  346, 346, 346, 346, 346, 347, 347, 347, 347, 347, 347, 347, 347, 347, 347, 348,
+  348, 348, 348, 348, 348, 348, 348, 348, 348, 349, 349, 349, 349, 349, 349, 349,
+  349, 349, 349, 350, 350, 350, 350, 350, 350, 350, 350, 350, 350, 351, 351, 351,
+  351, 351, 351, 351, 351, 351, 351, 352, 352, 352, 352, 352, 352, 352, 352, 352,
+  352, 353, 353, 353, 353, 353, 353, 353, 353, 353, 353, 354, 354, 354, 354, 354,
+  354, 354, 354, 354, 354, 355, 355, 355, 355, 355, 355, 355, 355, 355, 355, 356,
+  356, 356, 356, 356, 356, 356, 356, 356, 356, 356, 357, 357, 357, 357, 357, 357,
+  357, 357, 357, 357, 358, 358, 358, 358, 358, 358, 358, 358, 358, 358, 359, 359,
+  359, 359, 359, 359, 359, 359, 359, 359, 360, 360, 360, 360, 360, 360, 360, 360,
+  360, 360, 361, 361, 361, 361, 361, 361, 361, 361, 361, 361, 362, 362, 362, 362,
+  362, 362, 362, 362, 362, 362, 363, 363, 363, 363, 363, 363, 363, 363, 363, 363,
+  364, 364, 364, 364, 364, 364, 364, 364, 364, 364, 365, 365, 365, 365, 365, 365,
+  365, 365, 365, 365, 366, 366, 366, 366, 366, 366, 366, 366, 366, 366, 367, 367,
+  367, 367, 367, 367, 367, 367, 367, 367, 367, 368, 368, 368, 368, 368, 368, 368,
+  368, 368, 368, 369, 369, 369, 369, 369, 369, 369, 369, 369, 369, 370, 370, 370,
+  370, 370, 370, 370, 370, 370, 370, 371, 371, 371, 371, 371, 371, 371, 371, 371,
+  371, 372, 372, 372, 372, 372, 372, 372, 372, 372, 372, 373, 373, 373, 373, 373,
+  373, 373, 373, 373, 373, 374, 374, 374, 374, 374, 374, 374, 374, 374, 374, 375,
+  375, 375, 375, 375, 375, 375, 375, 375, 375, 376, 376, 376, 376, 376, 376, 376,
+  376, 376, 376, 377, 377, 377, 377, 377, 377, 377, 377, 377, 377, 378, 378, 378,
+  378, 378, 378, 378, 378, 378, 378, 378, 379, 379, 379, 379, 379, 379, 379, 379,
+  379, 379, 380, 380, 380, 380, 380, 380, 380, 380, 380, 380, 381, 381, 381, 381,
+  381, 381, 381, 381, 381, 381, 382, 382, 382, 382, 382, 382, 382, 382, 382, 382,
+  383, 383, 383, 383, 383, 383, 383, 383, 383, 383, 384, 384, 384, 384, 384, 384,
+  384, 384, 384, 384, 385, 385, 385, 385, 385, 385, 385, 385, 385, 385, 386, 386,
+  386, 386, 386, 386, 386, 386, 386, 386, 387, 387, 387, 387, 387, 387, 387, 387,
+  387, 387, 388, 388, 388, 388, 388, 388, 388, 388, 388, 388, 389, 389, 389, 389,
+  389, 389, 389, 389, 389, 389, 389, 390, 390, 390, 390, 390, 390, 390, 390, 390,
+  390, 391, 391, 391, 391, 391, 391, 391, 391, 391, 391, 392, 392, 392, 392, 392,
+  392, 392, 392, 392, 392, 393, 393, 393, 393, 393, 393, 393, 393, 393, 393, 394,
+  394, 394, 394, 394, 394, 394, 394, 394, 394, 395, 395, 395, 395, 395, 395, 395,
+  395, 395, 395, 396, 396, 396, 396, 396, 396, 396, 396, 396, 396, 397, 397, 397,
+  397, 397, 397, 397, 397, 397, 397, 398, 398, 398, 398, 398, 398, 398, 398, 398,
+  398, 399, 399, 399, 399, 399, 399, 399, 399, 399, 399, 400, 400, 400, 400, 400,
+  400, 401, 401, 401, 401, 401, 401, 401, 401, 402, 402, 402, 402, 402, 402, 402,
+  402, 402, 402, 402, 402, 402, 402, 402, 403, 403, 403, 403, 403, 403, 403, 403,
+  403, 403, 403, 403, 403, 403, 403, 404, 404, 404, 404, 404, 404, 404, 404, 404,
+  404, 404, 404, 404, 404, 404, 405, 405, 405, 405, 405, 405, 405, 405, 405, 405,
+  405, 405, 405, 405, 405, 405, 406, 406, 406, 406, 406, 406, 406, 406, 406, 406,
+  406, 406, 406, 406, 406, 407, 407, 407, 407, 407, 407, 407, 407, 407, 407, 407,
+  407, 407, 407, 407, 408, 408, 408, 408, 408, 408, 408, 408, 408, 408, 408, 408,
+  408, 408, 408, 409, 409, 409, 409, 409, 409, 409, 409, 409, 409, 409, 409, 409,
+  409, 409, 410, 410, 410, 410, 410, 410, 410, 410, 410, 410, 410, 410, 410, 410,
+  410, 411, 411, 411, 411, 411, 411, 411, 411, 411, 411, 411, 411, 411, 411, 411,
+  412, 412, 412, 412, 412, 412, 412, 412, 412, 412, 412, 412, 412, 412, 412, 412,
+  413, 413, 413, 413, 413, 413, 413, 413, 413, 413, 413, 413, 413, 413, 413, 414,
+  414, 414, 414, 414, 414, 414, 414, 414, 414, 414, 414, 414, 414, 414, 415, 415,
+  415, 415, 415, 415, 415, 415, 415, 415, 415, 415, 415, 415, 415, 416, 416, 416,
+  416, 416, 416, 416, 416, 416, 416, 416, 416, 416, 416, 416, 417, 417, 417, 417,
+  417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 417, 418, 418, 418, 418, 418,
+  418, 418, 418, 418, 418, 418, 418, 418, 418, 418, 419, 419, 419, 419, 419, 419,
+  419, 419, 419, 419, 419, 419, 419, 419, 419, 419, 420, 420, 420, 420, 420, 420,
+  420, 420, 420, 420, 420, 420, 420, 420, 420, 421, 421, 421, 421, 421, 421, 421,
+  421, 421, 421, 421, 421, 421, 421, 421, 422, 422, 422, 422, 422, 422, 422, 422,
+  422, 422, 422, 422, 422, 422, 422, 423, 423, 423, 423, 423, 423, 423, 423, 423,
+  423, 423, 423, 423, 423, 423, 424, 424, 424, 424, 424, 424, 424, 424, 424, 424,
+  424, 424, 424, 424, 424, 425, 425, 425, 425, 425, 425, 425, 425, 425, 425, 425,
+  425, 425, 425, 425, 426, 426, 426, 426, 426, 426, 426, 426, 426, 426, 426, 426,
+  426, 426, 426, 426, 427, 427, 427, 427, 427, 427, 427, 427, 427, 427, 427, 427,
+  427, 427, 427, 428, 428, 428, 428, 428, 428, 428, 428, 428, 428, 428, 428, 428,
+  428, 428, 429, 429, 429, 429, 429, 429, 429, 429, 429, 429, 429, 429, 429, 429,
+  429, 430, 430, 430, 430, 430, 430, 430, 430, 430, 430, 430, 430, 430, 430, 430,
+  431, 431, 431, 431, 431, 431, 431, 431, 431, 431, 431, 431, 431, 431, 431, 432,
+  432, 432, 432, 432, 432, 432, 432, 432, 432, 432, 432, 432, 432, 432, 433, 433,
+  433, 433, 433, 433, 433, 433, 433, 433, 433, 433, 433, 433, 433, 433, 434, 434,
+  434, 434, 434, 434, 434, 434, 434, 434, 434, 434, 434, 434, 434, 435, 435, 435,
+  435, 435, 435, 435, 435, 435, 435, 435, 435, 435, 435, 435, 436, 436, 436, 436,
+  436, 436, 436, 436, 436, 436, 436, 436, 436, 436, 436, 437, 437, 437, 437, 437,
+  437, 437, 437, 437, 437, 437, 437, 437, 437, 437, 438, 438, 438, 438, 438, 438,
+  438, 438, 438, 438, 438, 438, 438, 438, 438, 439, 439, 439, 439, 439, 439, 439,
+  439, 439, 439, 439, 439, 439, 439, 439, 440, 440, 440, 440, 440, 440, 440, 440,
+  440, 440, 440, 440, 440, 440, 440, 440, 441, 441, 441, 441, 441, 441, 441, 441,
+  441, 441, 441, 441, 441, 441, 441, 442, 442, 442, 442, 442, 442, 442, 442, 442,
+  442, 442, 442, 442, 442, 442, 443, 443, 443, 443, 443, 443, 443, 443, 443, 443,
+  443, 443, 443, 443, 443, 444, 444, 444, 444, 444, 444, 444, 444, 444, 444, 444,
+  444, 444, 444, 444, 445, 445, 445, 445, 445, 445, 445, 445, 445, 445, 445, 445,
+  445, 445, 445, 446, 446, 446, 446, 446, 446, 446, 446, 446, 446, 446, 446, 446,
+  446, 446, 447, 447, 447, 447, 447, 447, 447, 447, 447, 447, 447, 447, 447, 447,
+  447, 447, 448, 448, 448, 448, 448, 448, 448, 448, 448, 448, 448, 448, 448, 448,
+  448, 449, 449, 449, 449, 449, 449, 449, 449, 449, 449, 449, 449, 449, 449, 449,
+  450, 450, 450, 450, 450, 450, 450, 450, 450, 450, 450, 450, 450, 450, 450, 451,
+  451, 451, 451, 451, 451, 451, 451, 451, 451, 451, 451, 451, 451, 451, 452, 452,
+  452, 452, 452, 452, 452, 452, 452, 452, 452, 452, 452, 452, 452, 453, 453, 453,
+  453, 453, 453, 453, 453, 453, 453, 453, 453, 453, 453, 453, 454, 454, 454, 454,
+  454, 454, 454, 454, 454, 454, 454, 454, 454, 454, 454, 454, 455, 455, 455, 455,
+  455, 455, 455, 455, 455, 455, 455, 455, 455, 455, 455, 456, 456, 456, 456, 456,
+  456, 456, 456, 456, 456, 456, 456, 456, 456, 456, 457, 457, 457, 457, 457, 457,
+  457, 457, 457, 457, 457, 457, 457, 457, 457, 458, 458, 458, 458, 458, 458, 458,
+  458, 458, 458, 458, 458, 458, 458, 458, 459, 459, 459, 459, 459, 459, 459, 459,
+  459, 459, 459, 459, 459, 459, 459, 460, 460, 460, 460, 460, 460, 460, 460, 460,
+  460, 460, 460, 460, 460, 460, 461, 461, 461, 461, 461, 461, 461, 461, 461, 461,
+  461, 461, 461, 461, 461, 461, 462, 462, 462, 462, 462, 462, 462, 462, 462, 462,
+  462, 462, 462, 462, 462, 463, 463, 463, 463, 463, 463, 463, 463, 463, 463, 463,
+  463, 463, 463, 463, 464, 464, 464, 464, 464, 464, 464, 464, 464, 464, 464, 464,
+  464, 464, 464, 465, 465, 465, 465, 465, 465, 465, 465, 465, 465, 465, 465, 465,
+  465, 465, 466, 466, 466, 466, 466, 466, 466, 466, 466, 466, 466, 466, 466, 466,
+  466, 467, 467, 467, 467, 467, 467, 467, 467, 467, 467, 467, 467, 467, 467, 467,
+  468, 468, 468, 468, 468, 468, 468, 468, 468, 468, 468, 468, 468, 468, 468, 468,
+  469, 469, 469, 469, 469, 469, 469, 469, 469, 469, 469, 469, 469, 469, 469, 470,
+  470, 470, 470, 470, 470, 470, 470, 470, 470, 470, 470, 470, 470, 470, 471, 471,
+  471, 471, 471, 471, 471, 471, 471, 471, 471, 471, 471, 471, 471, 472, 472, 472,
+  472, 472, 472, 472, 472, 472, 472, 472, 472, 472, 472, 472, 473, 473, 473, 473,
+  473, 473, 473, 473, 473, 473, 473, 473, 473, 473, 473, 474, 474, 474, 474, 474,
+  474, 474, 474, 474, 474, 474, 474, 474, 474, 474, 475, 475, 475, 475, 475, 475,
+  475, 475, 475, 475, 475, 475, 475, 475, 475, 475, 476, 476, 476, 476, 476, 476,
+  476, 476, 476, 476, 476, 476, 476, 476, 476, 477, 477, 477, 477, 477, 477, 477,
+  477, 477, 477, 477, 477, 477, 477, 477, 478, 478, 478, 478, 478, 478, 478, 478,
+  478, 478, 478, 478, 478, 478, 478, 479, 479, 479, 479, 479, 479, 479, 479, 479,
+  479, 479, 479, 479, 479, 479, 480, 480, 480, 480, 480, 480, 480, 480, 480, 480,
+  480, 480, 480, 480, 480, 481, 481, 481, 481, 481, 481, 481, 481, 481, 481, 481,
+  481, 481, 481, 481, 482, 482, 482, 482, 482, 482, 482, 482, 482, 482, 482, 482,
+  482, 482, 482, 482, 483, 483, 483, 483, 483, 483, 483, 483, 483, 483, 483, 483,
+  483, 483, 483, 484, 484, 484, 484, 484, 484, 484, 484, 484, 484, 484, 484, 484,
+  484, 484, 485, 485, 485, 485, 485, 485, 485, 485, 485, 485, 485, 485, 485, 485,
+  485, 486, 486, 486, 486, 486, 486, 486, 486, 486, 486, 486, 486, 486, 486, 486,
+  487, 487, 487, 487, 487, 487, 487, 487, 487, 487, 487, 487, 487, 487, 487, 488,
+  488, 488, 488, 488, 488, 488, 488, 488, 488, 488, 488, 488, 488, 488, 489, 489,
+  489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 490, 490,
+  490, 490, 490, 490, 490, 490, 490, 490, 490, 490, 490, 490, 490, 491, 491, 491,
+  491, 491, 491, 491, 491, 491, 491, 491, 491, 491, 491, 491, 492, 492, 492, 492,
+  492, 492, 492, 492, 492, 492, 492, 492, 492, 492, 492, 493, 493, 493, 493, 493,
+  493, 493, 493, 493, 493, 493, 493, 493, 493, 493, 494, 494, 494, 494, 494, 494,
+  494, 494, 494, 494, 494, 494, 494, 494, 494, 495, 495, 495, 495, 495, 495, 495,
+  495, 495, 495, 495, 495, 495, 495, 495, 496, 496, 496, 496, 496, 496, 496, 496,
+  496, 496, 496, 496, 496, 496, 496, 496, 497, 497, 497, 497, 497, 497, 497, 497,
+  497, 497, 497, 497, 497, 497, 497, 498, 498, 498, 498, 498, 498, 498, 498, 498,
+  498, 498, 498, 498, 498, 498, 499, 499, 499, 499, 499, 499, 499, 499, 499, 499,
+  499, 499, 499, 499, 499, 500, 500, 500, 500, 500, 500, 500, 500, 501,
+};
+
+/* Sub-indices of truncated concentrations, in units of the last decimal place
+ * kept (see united_states_aqi()). These define the lookup tables above: every
+ * entry is the sub-index of its own index.
+ */
+static int united_states_aqi_co_sub(float co)
+{
+  return breakpoint_aqi(&UNITED_STATES_AQI_CO_8H, co / 10);
+} // end united_states_aqi_co_sub
+
+static int united_states_aqi_no2_sub(float no2)
+{
+  return breakpoint_aqi(&UNITED_STATES_AQI_NO2_1H, no2);
+} // end united_states_aqi_no2_sub
 
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h < 30.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 30;
-  }
-  else if (pm2_5_24h < 60.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 31;
-    c_hi = 60;
-  }
-  else if (pm2_5_24h < 90.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 61;
-    c_hi = 90;
-  }
-  else if (pm2_5_24h < 120.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 91;
-    c_hi = 120;
-  }
-  else if (pm2_5_24h < 250.5)
+static int united_states_aqi_o3_1h_sub(float o3)
+{
+  if (o3 / 1000 >= 0.125)
   {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 121;
-    c_hi = 250;
+    return breakpoint_aqi(&UNITED_STATES_AQI_O3_1H, o3 / 1000);
   }
-  else
+  return 0;
+} // end united_states_aqi_o3_1h_sub
+
+static int united_states_aqi_o3_8h_sub(float o3)
+{
+  if (o3 / 1000 <= 0.200)
   {
-    // index > 400
-    return 401;
+    return breakpoint_aqi(&UNITED_STATES_AQI_O3_8H, o3 / 1000);
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
+  return 0;
+} // end united_states_aqi_o3_8h_sub
 
-  return aqi;
-} // end india_aqi
+static int united_states_aqi_so2_1h_sub(float so2)
+{
+  return breakpoint_aqi(&UNITED_STATES_AQI_SO2, so2);
+} // end united_states_aqi_so2_1h_sub
 
-/* Singapore (PSI)
- *
- * References:
- *   https://www.haze.gov.sg/
- *   http://www.haze.gov.sg/docs/default-source/faq/computation-of-the-pollutant-standards-index-%28psi%29.pdf
+static int united_states_aqi_pm10_sub(float pm10)
+{
+  return breakpoint_aqi(&UNITED_STATES_AQI_PM10_24H, pm10);
+} // end united_states_aqi_pm10_sub
+
+static int united_states_aqi_pm2_5_sub(float pm2_5)
+{
+  return breakpoint_aqi(&UNITED_STATES_AQI_PM2_5_24H, pm2_5 / 10);
+} // end united_states_aqi_pm2_5_sub
+
+/* Returns k clamped to [0, len - 1] as an index into a lookup table.
  */
-int singapore_psi(float co_8h,   float no2_1h,   float o3_1h, float o3_8h,
-                  float so2_24h, float pm10_24h, float pm2_5_24h)
+static inline int united_states_aqi_index(float k, int len)
 {
-  int psi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
+  return k <= 0 ? 0 : k >= len - 1 ? len - 1 : (int) k;
+} // end united_states_aqi_index
 
-  // co    μg/m^3, Carbon Monoxide (CO)
-  // 1mg/m^3 = 1000 μg/m^3
-  if (co_8h < 5050)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 5000;
-  }
-  else if (co_8h < 10050)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 5100;
-    c_hi = 10000;
-  }
-  else if (co_8h < 17050)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 10100;
-    c_hi = 17000;
-  }
-  else if (co_8h < 34050)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 17100;
-    c_hi = 34000;
-  }
-  else if (co_8h < 46050)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 34100;
-    c_hi = 46000;
-  }
-  else if (co_8h < 57550)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 46100;
-    c_hi = 57500;
-  }
-  else
-  {
-    // index > 500
-    return 501;
+#define UNITED_STATES_AQI_LOOKUP(lut, k) \
+  (lut)[united_states_aqi_index((k), sizeof(lut) / sizeof((lut)[0]))]
+
+/* Writes the sub-index of each pollutant of the United States AQI to 'sub',
+ * shared by united_states_aqi() and united_states_aqi_detail(). Pollutants
+ * the scale does not use are left unchanged.
+ */
+static inline void united_states_aqi_sub_indices(float co_8h,    float no2_1h,
+                                                 float o3_1h,    float o3_8h,
+                                                 float so2_1h,   float so2_24h,
+                                                 float pm10_24h,
+                                                 float pm2_5_24h, int *sub)
+{
+  // Pollutant averages are truncated, in units of the last decimal place kept
+  float co    = floorf((float)(co_8h / 1145.6) * 10);   // (0.1 ppm)
+  float no2   = (int)(no2_1h / 1.8816);                 // (ppb)
+  float o3_1  = floorf((float)(o3_1h / 1963.2) * 1000); // (0.001 ppm)
+  float o3_8  = floorf((float)(o3_8h / 1963.2) * 1000); // (0.001 ppm)
+  float so2   = (int)(so2_1h / 8.4744);                 // (ppb)
+  float pm10  = (int)pm10_24h;                          // (μg/m^3)
+  float pm2_5 = floorf(pm2_5_24h * 10);                 // (0.1 μg/m^3)
+
+  // The 1 hour o3 table stops at 0.404 ppm, NaN has no entry either
+  if (!(o3_1 < 405 && co == co && o3_8 == o3_8 && pm2_5 == pm2_5))
+  {
+    sub[POLLUTANT_CO]    = united_states_aqi_co_sub(co);
+    sub[POLLUTANT_NO2]   = united_states_aqi_no2_sub(no2);
+    sub[POLLUTANT_O3]    = max(united_states_aqi_o3_1h_sub(o3_1),
+                               united_states_aqi_o3_8h_sub(o3_8));
+    // The 24 hour average of so2 is only used above 185 ppb.
+    sub[POLLUTANT_SO2]   = so2 <= 185
+                           ? united_states_aqi_so2_1h_sub(so2)
+                           : breakpoint_aqi(&UNITED_STATES_AQI_SO2, so2_24h);
+    sub[POLLUTANT_PM10]  = united_states_aqi_pm10_sub(pm10);
+    sub[POLLUTANT_PM2_5] = united_states_aqi_pm2_5_sub(pm2_5);
+    return;
   }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_8h));
 
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  // only calculated if >= 1130 μg/m^3
-  if (no2_1h >= 1129.5)
+  sub[POLLUTANT_CO]    = UNITED_STATES_AQI_LOOKUP(UNITED_STATES_AQI_CO_8H_LUT,
+                                                  co);
+  sub[POLLUTANT_NO2]   = UNITED_STATES_AQI_LOOKUP(UNITED_STATES_AQI_NO2_1H_LUT,
+                                                  no2);
+  sub[POLLUTANT_O3]    = max(UNITED_STATES_AQI_LOOKUP(
+                               UNITED_STATES_AQI_O3_1H_LUT, o3_1),
+                             UNITED_STATES_AQI_LOOKUP(
+                               UNITED_STATES_AQI_O3_8H_LUT, o3_8));
+  sub[POLLUTANT_SO2]   = so2 <= 185
+                         ? UNITED_STATES_AQI_LOOKUP(
+                             UNITED_STATES_AQI_SO2_1H_LUT, so2)
+                         : breakpoint_aqi(&UNITED_STATES_AQI_SO2, so2_24h);
+  sub[POLLUTANT_PM10]  = UNITED_STATES_AQI_LOOKUP(
+                           UNITED_STATES_AQI_PM10_24H_LUT, pm10);
+  sub[POLLUTANT_PM2_5] = UNITED_STATES_AQI_LOOKUP(
+                           UNITED_STATES_AQI_PM2_5_24H_LUT, pm2_5);
+} // end united_states_aqi_sub_indices
+
+AQI_API
+int united_states_aqi(float co_8h,    float no2_1h,
+                      float o3_1h,    float o3_8h,
+                      float so2_1h,   float so2_24h,
+                      float pm10_24h, float pm2_5_24h)
+{
+  int sub[NUM_AQI_POLLUTANTS];
+  united_states_aqi_sub_indices(co_8h, no2_1h, o3_1h, o3_8h, so2_1h, so2_24h,
+                                pm10_24h, pm2_5_24h, sub);
+  return max(max(max(0, sub[POLLUTANT_CO]), max(sub[POLLUTANT_NO2],
+                                                sub[POLLUTANT_O3])),
+             max(sub[POLLUTANT_SO2], max(sub[POLLUTANT_PM10],
+                                         sub[POLLUTANT_PM2_5])));
+} // end united_states_aqi
+
+/* Per-pollutant sub-indices
+ *
+ * Variants of the scale functions that keep the sub-index of every pollutant
+ * instead of only their maximum. Each evaluates exactly the same sub-indices as
+ * the scale function, so the index they return is identical.
+ */
+
+static void aqi_detail_clear(aqi_detail_t *detail)
+{
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    if (no2_1h < 2260.5)
-    {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 1131;
-      c_hi = 2260;
-    }
-    else if (no2_1h < 3000.5)
-    {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 2261;
-      c_hi = 3000;
-    }
-    else if (no2_1h < 3750.5)
-    {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 3001;
-      c_hi = 3750;
-    }
-    else
-    {
-      // index > 500
-      return 501;
-    }
-    if (no2_1h >= 1129.5 && no2_1h < 1130.5)
-    {
-      psi = max(psi, 200);
-    }
-    else
-    {
-      psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
-    }
+    detail->sub[p] = 0;
   }
+} // end aqi_detail_clear
 
-  // o3    μg/m^3, Ozone (O3)
-  // When 8-hour o3 concentration is > 785 μg/m^3, then the PSI sub-index is
-  // calculated using the 1 hour concentration.
-  if (o3_8h <= 785)
+/* Sets the index of a detail to the maximum of 'floor' and its sub-indices,
+ * and the dominant pollutant to the first one with that sub-index (or
+ * NUM_AQI_POLLUTANTS if none exceeds 'floor'). Returns the index.
+ */
+static int aqi_detail_finish(aqi_detail_t *detail, int floor)
+{
+  int aqi = floor;
+  detail->dominant = NUM_AQI_POLLUTANTS;
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    if (o3_8h < 118.5)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 118;
-    }
-    else if (o3_8h < 157.5)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 119;
-      c_hi = 157;
-    }
-    else if (o3_8h < 235.5)
-    {
-      i_lo = 101;
-      i_hi = 200;
-      c_lo = 158;
-      c_hi = 235;
-    }
-    else
+    if (detail->sub[p] > aqi)
     {
-      // o3_8h <= 785
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 236;
-      c_hi = 785;
+      aqi = detail->sub[p];
+      detail->dominant = (aqi_pollutant_t) p;
     }
-    psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
   }
-  else
+  detail->aqi = aqi;
+  return aqi;
+} // end aqi_detail_finish
+
+AQI_API
+int australia_aqi_detail(float co_8h,  float no2_1h,   float o3_1h,
+                         float o3_4h,  float so2_1h,   float pm10_24h,
+                         float pm2_5_24h, aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_CO]    = compute_nepm_aqi(10310.4, co_8h);
+  sub[POLLUTANT_NO2]   = compute_nepm_aqi(225.792, no2_1h);
+  sub[POLLUTANT_O3]    = max(compute_nepm_aqi(196.32, o3_1h),
+                             compute_nepm_aqi(157.056, o3_4h));
+  sub[POLLUTANT_SO2]   = compute_nepm_aqi(1694.88, so2_1h);
+  sub[POLLUTANT_PM10]  = compute_nepm_aqi(50, pm10_24h);
+  sub[POLLUTANT_PM2_5] = compute_nepm_aqi(25, pm2_5_24h);
+  return aqi_detail_finish(detail, 0);
+} // end australia_aqi_detail
+
+/* The AQHI scales add up the risk of every pollutant rather than taking the
+ * largest sub-index. Their sub-indices are the AQHI of each pollutant on its
+ * own, and the dominant pollutant is the one adding the largest risk, that is
+ * the largest exponent k * c. The sub-indices and the AQHI are all derived from
+ * the same exponentials, each evaluated once.
+ */
+static void aqhi_detail_dominant(aqi_detail_t *detail,
+                                 const float y[NUM_AQI_POLLUTANTS])
+{
+  float y_max = 0;
+  detail->dominant = NUM_AQI_POLLUTANTS;
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    if (o3_1h < 118.5)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 118;
-    }
-    else if (o3_1h < 157.5)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 119;
-      c_hi = 157;
-    }
-    else if (o3_1h < 235.5)
-    {
-      i_lo = 101;
-      i_hi = 200;
-      c_lo = 158;
-      c_hi = 235;
-    }
-    else if (o3_1h < 785.5)
-    {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 236;
-      c_hi = 785;
-    }
-    else if (o3_1h < 980.5)
-    {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 786;
-      c_hi = 980;
-    }
-    else if (o3_1h < 1180.5)
-    {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 981;
-      c_hi = 1180;
-    }
-    else
+    if (y[p] > y_max)
     {
-      // index > 500
-      return 501;
+      y_max = y[p];
+      detail->dominant = (aqi_pollutant_t) p;
     }
-    psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
   }
+} // end aqhi_detail_dominant
 
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  if (so2_24h < 80.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 80;
-  }
-  else if (so2_24h < 365.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 81;
-    c_hi = 365;
-  }
-  else if (so2_24h < 800.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 366;
-    c_hi = 800;
-  }
-  else if (so2_24h < 1600.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 801;
-    c_hi = 1600;
-  }
-  else if (so2_24h < 2100.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1601;
-    c_hi = 2100;
-  }
-  else if (so2_24h < 2620.5)
+AQI_API
+int canada_aqhi_detail(float no2_3h, float o3_3h, float pm2_5_3h,
+                       aqi_detail_t *detail)
+{
+  aqhi_exp_t o3, no2, pm2_5, none;
+  aqhi_exp_init(&o3,    CANADA_AQHI_K_O3,    o3_3h);
+  aqhi_exp_init(&no2,   CANADA_AQHI_K_NO2,   no2_3h);
+  aqhi_exp_init(&pm2_5, CANADA_AQHI_K_PM2_5, pm2_5_3h);
+  // e^0, in place of the pollutants a sub-index leaves out
+  aqhi_exp_init(&none, 0, 0);
+
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_NO2]   = canada_aqhi_exps(&none, &no2, &none);
+  sub[POLLUTANT_O3]    = canada_aqhi_exps(&o3, &none, &none);
+  sub[POLLUTANT_PM2_5] = canada_aqhi_exps(&none, &none, &pm2_5);
+
+  const float y[NUM_AQI_POLLUTANTS] = {
+    [POLLUTANT_NO2]   = no2.y,
+    [POLLUTANT_O3]    = o3.y,
+    [POLLUTANT_PM2_5] = pm2_5.y,
+  };
+  aqhi_detail_dominant(detail, y);
+  detail->aqi = canada_aqhi_exps(&o3, &no2, &pm2_5);
+  return detail->aqi;
+} // end canada_aqhi_detail
+
+AQI_API
+int china_aqi_detail(float co_1h, float co_24h, float no2_1h, float no2_24h,
+                     float o3_1h, float o3_8h,  float so2_1h, float so2_24h,
+                     float pm10_24h, float pm2_5_24h, aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_CO]    = max(breakpoint_aqi(&CHINA_AQI_CO_1H, co_1h),
+                             breakpoint_aqi(&CHINA_AQI_CO_24H, co_24h));
+  sub[POLLUTANT_NO2]   = max(breakpoint_aqi(&CHINA_AQI_NO2_1H, no2_1h),
+                             breakpoint_aqi(&CHINA_AQI_NO2_24H, no2_24h));
+  sub[POLLUTANT_O3]    = breakpoint_aqi(&CHINA_AQI_O3_1H, o3_1h);
+  if (o3_8h <= 800)
   {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 2101;
-    c_hi = 2620;
+    sub[POLLUTANT_O3]  = max(sub[POLLUTANT_O3],
+                             breakpoint_aqi(&CHINA_AQI_O3_8H, o3_8h));
   }
-  else
+  sub[POLLUTANT_SO2]   = breakpoint_aqi(&CHINA_AQI_SO2_24H, so2_24h);
+  if (so2_1h <= 800)
   {
-    // index > 500
-    return 501;
+    sub[POLLUTANT_SO2] = max(sub[POLLUTANT_SO2],
+                             breakpoint_aqi(&CHINA_AQI_SO2_1H, so2_1h));
   }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
+  sub[POLLUTANT_PM10]  = breakpoint_aqi(&CHINA_AQI_PM10_24H, pm10_24h);
+  sub[POLLUTANT_PM2_5] = breakpoint_aqi(&CHINA_AQI_PM2_5_24H, pm2_5_24h);
+  return aqi_detail_finish(detail, 0);
+} // end china_aqi_detail
 
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h < 50.5)
+AQI_API
+int european_union_caqi_detail(float no2_1h,  float o3_1h, float pm10_1h,
+                               float pm2_5_1h, aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_NO2]   = breakpoint_aqi(&EUROPEAN_UNION_CAQI_NO2_1H, no2_1h);
+  sub[POLLUTANT_O3]    = breakpoint_aqi(&EUROPEAN_UNION_CAQI_O3_1H, o3_1h);
+  sub[POLLUTANT_PM10]  = breakpoint_aqi(&EUROPEAN_UNION_CAQI_PM10_1H, pm10_1h);
+  sub[POLLUTANT_PM2_5] = breakpoint_aqi(&EUROPEAN_UNION_CAQI_PM2_5_1H,
+                                        pm2_5_1h);
+  return aqi_detail_finish(detail, 0);
+} // end european_union_caqi_detail
+
+AQI_API
+int hong_kong_aqhi_detail(float no2_3h,  float o3_3h, float so2_3h,
+                          float pm10_3h, float pm2_5_3h, aqi_detail_t *detail)
+{
+  aqhi_exp_t no2, so2, o3, pm10, pm2_5, none;
+  hong_kong_aqhi_exp_init(&no2, &so2, &o3, &pm10, &pm2_5,
+                          no2_3h, o3_3h, so2_3h, pm10_3h, pm2_5_3h);
+  // e^0, in place of the pollutants a sub-index leaves out
+  aqhi_exp_init(&none, 0, 0);
+
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_NO2]   = hong_kong_aqhi_exps(&no2, &none, &none, &none, &none);
+  sub[POLLUTANT_O3]    = hong_kong_aqhi_exps(&none, &none, &o3, &none, &none);
+  sub[POLLUTANT_SO2]   = hong_kong_aqhi_exps(&none, &so2, &none, &none, &none);
+  sub[POLLUTANT_PM10]  = hong_kong_aqhi_exps(&none, &none, &none, &pm10, &none);
+  sub[POLLUTANT_PM2_5] = hong_kong_aqhi_exps(&none, &none, &none, &none,
+                                             &pm2_5);
+
+  // only the larger of the two particulate risks is added, which is the one
+  // with the larger exponent
+  const float y[NUM_AQI_POLLUTANTS] = {
+    [POLLUTANT_NO2]   = no2.y,
+    [POLLUTANT_O3]    = o3.y,
+    [POLLUTANT_SO2]   = so2.y,
+    [POLLUTANT_PM10]  = pm10.y,
+    [POLLUTANT_PM2_5] = pm2_5.y,
+  };
+  aqhi_detail_dominant(detail, y);
+  detail->aqi = hong_kong_aqhi_exps(&no2, &so2, &o3, &pm10, &pm2_5);
+  return detail->aqi;
+} // end hong_kong_aqhi_detail
+
+AQI_API
+int india_aqi_detail(float co_8h,  float nh3_24h, float no2_24h,  float o3_8h,
+                     float pb_24h, float so2_24h, float pm10_24h,
+                     float pm2_5_24h, aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_CO]    = breakpoint_aqi(&INDIA_AQI_CO_8H, co_8h);
+  sub[POLLUTANT_NH3]   = breakpoint_aqi(&INDIA_AQI_NH3_24H, nh3_24h);
+  sub[POLLUTANT_NO2]   = breakpoint_aqi(&INDIA_AQI_NO2_24H, no2_24h);
+  sub[POLLUTANT_O3]    = breakpoint_aqi(&INDIA_AQI_O3_8H, o3_8h);
+  sub[POLLUTANT_PB]    = breakpoint_aqi(&INDIA_AQI_PB_24H, pb_24h);
+  sub[POLLUTANT_SO2]   = breakpoint_aqi(&INDIA_AQI_SO2_24H, so2_24h);
+  sub[POLLUTANT_PM10]  = breakpoint_aqi(&INDIA_AQI_PM10_24H, pm10_24h);
+  sub[POLLUTANT_PM2_5] = breakpoint_aqi(&INDIA_AQI_PM2_5_24H, pm2_5_24h);
+  return aqi_detail_finish(detail, 0);
+} // end india_aqi_detail
+
+AQI_API
+int singapore_psi_detail(float co_8h,   float no2_1h,   float o3_1h,
+                         float o3_8h,   float so2_24h,  float pm10_24h,
+                         float pm2_5_24h, aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_CO]    = breakpoint_aqi(&SINGAPORE_PSI_CO_8H, co_8h);
+  sub[POLLUTANT_NO2]   = singapore_psi_no2(no2_1h,
+                                           breakpoint_aqi(&SINGAPORE_PSI_NO2_1H,
+                                                          no2_1h));
+  sub[POLLUTANT_O3]    = breakpoint_aqi(&SINGAPORE_PSI_O3,
+                                        singapore_psi_o3(o3_1h, o3_8h));
+  sub[POLLUTANT_SO2]   = breakpoint_aqi(&SINGAPORE_PSI_SO2_24H, so2_24h);
+  sub[POLLUTANT_PM10]  = breakpoint_aqi(&SINGAPORE_PSI_PM10_24H, pm10_24h);
+  sub[POLLUTANT_PM2_5] = breakpoint_aqi(&SINGAPORE_PSI_PM2_5_24H, pm2_5_24h);
+  return aqi_detail_finish(detail, 0);
+} // end singapore_psi_detail
+
+AQI_API
+int south_korea_cai_detail(float co_1h,  float no2_1h,   float o3_1h,
+                           float so2_1h, float pm10_24h, float pm2_5_24h,
+                           aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_CO]    = breakpoint_aqi(&SOUTH_KOREA_CAI_CO_1H, co_1h);
+  sub[POLLUTANT_NO2]   = breakpoint_aqi(&SOUTH_KOREA_CAI_NO2_1H, no2_1h);
+  sub[POLLUTANT_O3]    = breakpoint_aqi(&SOUTH_KOREA_CAI_O3_1H, o3_1h);
+  sub[POLLUTANT_SO2]   = breakpoint_aqi(&SOUTH_KOREA_CAI_SO2_1H, so2_1h);
+  sub[POLLUTANT_PM10]  = breakpoint_aqi(&SOUTH_KOREA_CAI_PM10_24H, pm10_24h);
+  sub[POLLUTANT_PM2_5] = breakpoint_aqi(&SOUTH_KOREA_CAI_PM2_5_24H, pm2_5_24h);
+  return aqi_detail_finish(detail, 0);
+} // end south_korea_cai_detail
+
+AQI_API
+int united_kingdom_daqi_detail(float no2_1h,   float o3_8h, float so2_15min,
+                               float pm10_24h, float pm2_5_24h,
+                               aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  sub[POLLUTANT_NO2]   = UNITED_KINGDOM_DAQI_LOOKUP(
+                           UNITED_KINGDOM_DAQI_NO2_1H_LUT, no2_1h);
+  sub[POLLUTANT_O3]    = UNITED_KINGDOM_DAQI_LOOKUP(
+                           UNITED_KINGDOM_DAQI_O3_8H_LUT, o3_8h);
+  sub[POLLUTANT_SO2]   = UNITED_KINGDOM_DAQI_LOOKUP(
+                           UNITED_KINGDOM_DAQI_SO2_15MIN_LUT, so2_15min);
+  sub[POLLUTANT_PM10]  = UNITED_KINGDOM_DAQI_LOOKUP(
+                           UNITED_KINGDOM_DAQI_PM10_24H_LUT, pm10_24h);
+  sub[POLLUTANT_PM2_5] = UNITED_KINGDOM_DAQI_LOOKUP(
+                           UNITED_KINGDOM_DAQI_PM2_5_24H_LUT, pm2_5_24h);
+  return aqi_detail_finish(detail, 1);
+} // end united_kingdom_daqi_detail
+
+AQI_API
+int united_states_aqi_detail(float co_8h,    float no2_1h,
+                             float o3_1h,    float o3_8h,
+                             float so2_1h,   float so2_24h,
+                             float pm10_24h, float pm2_5_24h,
+                             aqi_detail_t *detail)
+{
+  int *sub = detail->sub;
+  aqi_detail_clear(detail);
+  united_states_aqi_sub_indices(co_8h, no2_1h, o3_1h, o3_8h, so2_1h, so2_24h,
+                                pm10_24h, pm2_5_24h, sub);
+  return aqi_detail_finish(detail, 0);
+} // end united_states_aqi_detail
+
+/* Upper bounds of every descriptor category of a scale but the last, padded
+ * with INT_MAX. The category of a value is the number of bounds below it.
+ * Organized alphabetically (same order as aqi_scale_t enums).
+ */
+static const int AQI_CATEGORY_LOOKUP_TABLE[NUM_AQI_SCALES]
+                                          [AQI_MAX_CATEGORIES - 1] = {
+  {  33,  66,  99,     149,     200 }, // Australia
+  {   4,   6,  10, INT_MAX, INT_MAX }, // Canada
+  {  50, 100, 150,     200,     300 }, // China
+  {  25,  50,  75,     100, INT_MAX }, // European Union
+  {   3,   6,   7,      10, INT_MAX }, // Hong Kong
+  {  50, 100, 200,     300,     400 }, // India
+  {  50, 100, 200,     300, INT_MAX }, // Singapore
+  {  50, 100, 250, INT_MAX, INT_MAX }, // South Korea
+  {   3,   6,   9, INT_MAX, INT_MAX }, // United Kingdom
+  {  50, 100, 150,     200,     300 }, // United States
+};
+
+/* Fast lookup for the number of descriptor categories of each scale.
+ * Organized alphabetically (same order as aqi_scale_t enums).
+ */
+static const int AQI_NUM_CATEGORIES_LOOKUP_TABLE[NUM_AQI_SCALES] = {
+  6, // Australia
+  4, // Canada
+  6, // China
+  5, // European Union
+  5, // Hong Kong
+  6, // India
+  5, // Singapore
+  4, // South Korea
+  4, // United Kingdom
+  6, // United States
+};
+
+AQI_API
+int aqi_category(aqi_scale_t scale, int val)
+{
+  const int *upper = AQI_CATEGORY_LOOKUP_TABLE[scale];
+  return (val > upper[0]) + (val > upper[1]) + (val > upper[2])
+       + (val > upper[3]) + (val > upper[4]);
+} // end aqi_category
+
+AQI_API
+int aqi_num_categories(aqi_scale_t scale)
+{
+  return AQI_NUM_CATEGORIES_LOOKUP_TABLE[scale];
+} // end aqi_num_categories
+
+static void aqi_category_batch_scalar(const int *upper, size_t n,
+                                      const int *values, uint8_t *out)
+{
+  const int u0 = upper[0], u1 = upper[1], u2 = upper[2], u3 = upper[3],
+            u4 = upper[4];
+  for (size_t i = 0; i < n; ++i)
   {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
+    int v = values[i];
+    out[i] = (uint8_t) ((v > u0) + (v > u1) + (v > u2) + (v > u3) + (v > u4));
   }
-  else if (pm10_24h < 150.5)
+} // end aqi_category_batch_scalar
+
+#ifdef AQI_X86_KERNELS
+/* Returns the categories of 4 values, as 32-bit lanes.
+ */
+__attribute__((target("sse4.2")))
+static inline __m128i aqi_category_sse42(const __m128i *upper, __m128i v)
+{
+  __m128i cat = _mm_setzero_si128();
+  for (int k = 0; k < AQI_MAX_CATEGORIES - 1; ++k)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 51;
-    c_hi = 150;
+    cat = _mm_sub_epi32(cat, _mm_cmpgt_epi32(v, upper[k]));
   }
-  else if (pm10_24h < 350.5)
+  return cat;
+} // end aqi_category_sse42
+
+/* SSE4.2 kernel, classifies 16 values per iteration.
+ */
+__attribute__((target("sse4.2")))
+static void aqi_category_batch_sse42(const int *upper, size_t n,
+                                     const int *values, uint8_t *out)
+{
+  __m128i u[AQI_MAX_CATEGORIES - 1];
+  for (int k = 0; k < AQI_MAX_CATEGORIES - 1; ++k)
   {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 151;
-    c_hi = 350;
+    u[k] = _mm_set1_epi32(upper[k]);
   }
-  else if (pm10_24h < 420.5)
+
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m128i *v = (const __m128i *)(values + i);
+    __m128i a = aqi_category_sse42(u, _mm_loadu_si128(v + 0));
+    __m128i b = aqi_category_sse42(u, _mm_loadu_si128(v + 1));
+    __m128i c = aqi_category_sse42(u, _mm_loadu_si128(v + 2));
+    __m128i d = aqi_category_sse42(u, _mm_loadu_si128(v + 3));
+    __m128i cat = _mm_packs_epi16(_mm_packs_epi32(a, b),
+                                  _mm_packs_epi32(c, d));
+    _mm_storeu_si128((__m128i *)(out + i), cat);
+  }
+  aqi_category_batch_scalar(upper, n - i, values + i, out + i);
+} // end aqi_category_batch_sse42
+
+/* Returns the categories of 8 values, as 32-bit lanes.
+ */
+__attribute__((target("avx2")))
+static inline __m256i aqi_category_avx2(const __m256i *upper, __m256i v)
+{
+  __m256i cat = _mm256_setzero_si256();
+  for (int k = 0; k < AQI_MAX_CATEGORIES - 1; ++k)
   {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 351;
-    c_hi = 420;
+    cat = _mm256_sub_epi32(cat, _mm256_cmpgt_epi32(v, upper[k]));
   }
-  else if (pm10_24h < 500.5)
+  return cat;
+} // end aqi_category_avx2
+
+/* AVX2 kernel, classifies 32 values per iteration.
+ */
+__attribute__((target("avx2")))
+static void aqi_category_batch_avx2(const int *upper, size_t n,
+                                    const int *values, uint8_t *out)
+{
+  __m256i u[AQI_MAX_CATEGORIES - 1];
+  for (int k = 0; k < AQI_MAX_CATEGORIES - 1; ++k)
   {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 421;
-    c_hi = 500;
+    u[k] = _mm256_set1_epi32(upper[k]);
   }
-  else if (pm10_24h < 600.5)
+  // packing works within 128-bit lanes, this restores the order of values
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    const __m256i *v = (const __m256i *)(values + i);
+    __m256i a = aqi_category_avx2(u, _mm256_loadu_si256(v + 0));
+    __m256i b = aqi_category_avx2(u, _mm256_loadu_si256(v + 1));
+    __m256i c = aqi_category_avx2(u, _mm256_loadu_si256(v + 2));
+    __m256i d = aqi_category_avx2(u, _mm256_loadu_si256(v + 3));
+    __m256i cat = _mm256_packs_epi16(_mm256_packs_epi32(a, b),
+                                     _mm256_packs_epi32(c, d));
+    cat = _mm256_permutevar8x32_epi32(cat, order);
+    _mm256_storeu_si256((__m256i *)(out + i), cat);
+  }
+  aqi_category_batch_scalar(upper, n - i, values + i, out + i);
+} // end aqi_category_batch_avx2
+#endif // x86
+
+AQI_API
+void aqi_category_batch(aqi_scale_t scale, size_t n, const int *values,
+                        uint8_t *out)
+{
+  const int *upper = AQI_CATEGORY_LOOKUP_TABLE[scale];
+  switch (kernel_isa)
+  {
+#ifdef AQI_X86_KERNELS
+    case AQI_ISA_AVX512:
+    case AQI_ISA_AVX2:
+      aqi_category_batch_avx2(upper, n, values, out);
+      return;
+    case AQI_ISA_SSE4_2:
+      aqi_category_batch_sse42(upper, n, values, out);
+      return;
+#endif
+    default:
+      aqi_category_batch_scalar(upper, n, values, out);
+      return;
+  }
+} // end aqi_category_batch
+
+/* Fast lookup for AQI descriptor strings. Organized alphabetically
+ * (same order as aqi_scale_t enums).
+ */
+static const char **AQI_TXT_LOOKUP_TABLE[NUM_AQI_SCALES] = {
+  AUSTRALIA_AQI_TXT,
+  CANADA_AQHI_TXT,
+  CHINA_AQI_TXT,
+  EUROPEAN_UNION_CAQI_TXT,
+  HONG_KONG_AQHI_TXT,
+  INDIA_AQI_TXT,
+  SINGAPORE_PSI_TXT,
+  SOUTH_KOREA_CAI_TXT,
+  UNITED_KINGDOM_DAQI_TXT,
+  UNITED_STATES_AQI_TXT,
+};
+
+AQI_API
+const char *aqi_category_desc(aqi_scale_t scale, int category)
+{
+  if (category < 0 || category >= AQI_NUM_CATEGORIES_LOOKUP_TABLE[scale])
   {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 501;
-    c_hi = 600;
+    return NULL;
   }
-  else
+  return AQI_TXT_LOOKUP_TABLE[scale][category];
+} // end aqi_category_desc
+
+/*
+ * Indicates Air Quality
+ */
+AQI_API
+const char *australia_aqi_desc(int aqi)
+{
+  return AUSTRALIA_AQI_TXT[aqi_category(AUSTRALIA_AQI, aqi)];
+} // end australia_aqi_desc
+
+/*
+ * Indicates Health Risk
+ */
+AQI_API
+const char *canada_aqhi_desc(int aqhi)
+{
+  return CANADA_AQHI_TXT[aqi_category(CANADA_AQHI, aqhi)];
+} // end canada_aqhi_desc
+
+/*
+ * Indicates Air Pollution
+ */
+AQI_API
+const char *china_aqi_desc(int aqi)
+{
+  return CHINA_AQI_TXT[aqi_category(CHINA_AQI, aqi)];
+} // end china_aqi_desc
+
+/*
+ * Indicates Air Pollution
+ */
+AQI_API
+const char *european_union_caqi_desc(int caqi)
+{
+  return EUROPEAN_UNION_CAQI_TXT[aqi_category(EUROPEAN_UNION_CAQI, caqi)];
+} // end european_union_caqi_desc
+
+/*
+ * Indicates Health Risk
+ */
+AQI_API
+const char *hong_kong_aqhi_desc(int aqhi)
+{
+  return HONG_KONG_AQHI_TXT[aqi_category(HONG_KONG_AQHI, aqhi)];
+} // end hong_kong_aqhi_desc
+
+/*
+ * Indicates Air Quality
+ */
+AQI_API
+const char *india_aqi_desc(int aqi)
+{
+  return INDIA_AQI_TXT[aqi_category(INDIA_AQI, aqi)];
+} // end india_aqi_desc
+
+/*
+ * Indicates Health Risk
+ */
+AQI_API
+const char *singapore_psi_desc(int psi)
+{
+  return SINGAPORE_PSI_TXT[aqi_category(SINGAPORE_PSI, psi)];
+} // end singapore_psi_desc
+
+/*
+ * Indicates Health Risk
+ */
+AQI_API
+const char *south_korea_cai_desc(int cai)
+{
+  return SOUTH_KOREA_CAI_TXT[aqi_category(SOUTH_KOREA_CAI, cai)];
+} // end south_korea_cai_desc
+
+/*
+ * Indicates Air Pollution
+ */
+AQI_API
+const char *united_kingdom_daqi_desc(int daqi)
+{
+  return UNITED_KINGDOM_DAQI_TXT[aqi_category(UNITED_KINGDOM_DAQI, daqi)];
+} // end united_kingdom_daqi_desc
+
+/*
+ * Indicates Health Risk
+ */
+AQI_API
+const char *united_states_aqi_desc(int aqi)
+{
+  return UNITED_STATES_AQI_TXT[aqi_category(UNITED_STATES_AQI, aqi)];
+} // end united_states_aqi_desc
+
+/* Returns the average pollutant concentration over a given number of previous
+ * hours.
+ *
+ * 'pollutant' is an array of hourly concentrations. The last element in
+ * pollutant is the most recent hourly concentration. 'hours' must be a positive
+ * integer.
+ *
+ * Passing NULL will return 0.
+ */
+AQI_API
+float avg_conc(const float pollutant[24], int hours)
+{
+  if (pollutant == NULL)
   {
-    // index > 500
-    return 501;
+    return 0.f;
   }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
 
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h < 12.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 12;
-  }
-  else if (pm2_5_24h < 55.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 13;
-    c_hi = 55;
-  }
-  else if (pm2_5_24h < 150.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 56;
-    c_hi = 150;
-  }
-  else if (pm2_5_24h < 250.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 151;
-    c_hi = 250;
-  }
-  else if (pm2_5_24h < 350.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 251;
-    c_hi = 350;
-  }
-  else if (pm2_5_24h < 500.5)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 351;
-    c_hi = 500;
-  }
-  else
+  float avg = 0;
+  // index (size - 1) is most recent hourly concentration
+  for (int h = (24 - 1) - (hours - 1) ; h < 24 ; ++h)
   {
-    // index > 500
-    return 501;
+    avg += pollutant[h];
   }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
 
-  return psi;
-} // end singapore_psi
+  avg = avg / (float) hours;
+  return avg;
+}
 
-/* South Korea (CAI)
+/* Averaging windows
  *
- * References:
- *   https://www.airkorea.or.kr/eng/khaiInfo?pMENU_NO=166
+ * Every input form (hourly arrays, views, validity masks, rolling states, long
+ * histories, prefix sums, batches and fixed-point samples) evaluates a scale
+ * the same way: it takes each average listed in the windows table of the scale
+ * with its own averager, and passes them to the scale function in that order.
  */
-int south_korea_cai(float co_1h,  float no2_1h,   float o3_1h,
-                    float so2_1h, float pm10_24h, float pm2_5_24h)
+
+/* The average concentration of a pollutant over the previous 'minutes'
+ * minutes.
+ */
+typedef struct {
+  aqi_pollutant_t pollutant;
+  int             minutes;
+} aqi_window_t;
+
+/* Largest number of averages taken by a scale (China).
+ */
+#define AQI_MAX_WINDOWS 10
+
+/* Averages taken by each scale, in the order of the scale function's
+ * arguments.
+ */
+static const aqi_window_t AUSTRALIA_AQI_WINDOWS[] = {
+  { POLLUTANT_CO,     480 }, // co_8h
+  { POLLUTANT_NO2,     60 }, // no2_1h
+  { POLLUTANT_O3,      60 }, // o3_1h
+  { POLLUTANT_O3,     240 }, // o3_4h
+  { POLLUTANT_SO2,     60 }, // so2_1h
+  { POLLUTANT_PM10,  1440 }, // pm10_24h
+  { POLLUTANT_PM2_5, 1440 }, // pm2_5_24h
+};
+
+static const aqi_window_t CANADA_AQHI_WINDOWS[] = {
+  { POLLUTANT_NO2,    180 }, // no2_3h
+  { POLLUTANT_O3,     180 }, // o3_3h
+  { POLLUTANT_PM2_5,  180 }, // pm2_5_3h
+};
+
+static const aqi_window_t CHINA_AQI_WINDOWS[] = {
+  { POLLUTANT_CO,      60 }, // co_1h
+  { POLLUTANT_CO,    1440 }, // co_24h
+  { POLLUTANT_NO2,     60 }, // no2_1h
+  { POLLUTANT_NO2,   1440 }, // no2_24h
+  { POLLUTANT_O3,      60 }, // o3_1h
+  { POLLUTANT_O3,     480 }, // o3_8h
+  { POLLUTANT_SO2,     60 }, // so2_1h
+  { POLLUTANT_SO2,   1440 }, // so2_24h
+  { POLLUTANT_PM10,  1440 }, // pm10_24h
+  { POLLUTANT_PM2_5, 1440 }, // pm2_5_24h
+};
+
+static const aqi_window_t EUROPEAN_UNION_CAQI_WINDOWS[] = {
+  { POLLUTANT_NO2,     60 }, // no2_1h
+  { POLLUTANT_O3,      60 }, // o3_1h
+  { POLLUTANT_PM10,    60 }, // pm10_1h
+  { POLLUTANT_PM2_5,   60 }, // pm2_5_1h
+};
+
+static const aqi_window_t HONG_KONG_AQHI_WINDOWS[] = {
+  { POLLUTANT_NO2,    180 }, // no2_3h
+  { POLLUTANT_O3,     180 }, // o3_3h
+  { POLLUTANT_SO2,    180 }, // so2_3h
+  { POLLUTANT_PM10,   180 }, // pm10_3h
+  { POLLUTANT_PM2_5,  180 }, // pm2_5_3h
+};
+
+static const aqi_window_t INDIA_AQI_WINDOWS[] = {
+  { POLLUTANT_CO,     480 }, // co_8h
+  { POLLUTANT_NH3,   1440 }, // nh3_24h
+  { POLLUTANT_NO2,   1440 }, // no2_24h
+  { POLLUTANT_O3,     480 }, // o3_8h
+  { POLLUTANT_PB,    1440 }, // pb_24h
+  { POLLUTANT_SO2,   1440 }, // so2_24h
+  { POLLUTANT_PM10,  1440 }, // pm10_24h
+  { POLLUTANT_PM2_5, 1440 }, // pm2_5_24h
+};
+
+static const aqi_window_t SINGAPORE_PSI_WINDOWS[] = {
+  { POLLUTANT_CO,     480 }, // co_8h
+  { POLLUTANT_NO2,     60 }, // no2_1h
+  { POLLUTANT_O3,      60 }, // o3_1h
+  { POLLUTANT_O3,     480 }, // o3_8h
+  { POLLUTANT_SO2,   1440 }, // so2_24h
+  { POLLUTANT_PM10,  1440 }, // pm10_24h
+  { POLLUTANT_PM2_5, 1440 }, // pm2_5_24h
+};
+
+static const aqi_window_t SOUTH_KOREA_CAI_WINDOWS[] = {
+  { POLLUTANT_CO,      60 }, // co_1h
+  { POLLUTANT_NO2,     60 }, // no2_1h
+  { POLLUTANT_O3,      60 }, // o3_1h
+  { POLLUTANT_SO2,     60 }, // so2_1h
+  { POLLUTANT_PM10,  1440 }, // pm10_24h
+  { POLLUTANT_PM2_5, 1440 }, // pm2_5_24h
+};
+
+static const aqi_window_t UNITED_KINGDOM_DAQI_WINDOWS[] = {
+  { POLLUTANT_NO2,     60 }, // no2_1h
+  { POLLUTANT_O3,     480 }, // o3_8h
+  { POLLUTANT_SO2,     15 }, // so2_15min
+  { POLLUTANT_PM10,  1440 }, // pm10_24h
+  { POLLUTANT_PM2_5, 1440 }, // pm2_5_24h
+};
+
+static const aqi_window_t UNITED_STATES_AQI_WINDOWS[] = {
+  { POLLUTANT_CO,     480 }, // co_8h
+  { POLLUTANT_NO2,     60 }, // no2_1h
+  { POLLUTANT_O3,      60 }, // o3_1h
+  { POLLUTANT_O3,     480 }, // o3_8h
+  { POLLUTANT_SO2,     60 }, // so2_1h
+  { POLLUTANT_SO2,   1440 }, // so2_24h
+  { POLLUTANT_PM10,  1440 }, // pm10_24h
+  { POLLUTANT_PM2_5, 1440 }, // pm2_5_24h
+};
+
+typedef struct {
+  const aqi_window_t *window;
+  int                 count;
+} aqi_windows_t;
+
+#define AQI_WINDOWS(windows) \
+  { (windows), (int)(sizeof(windows) / sizeof((windows)[0])) }
+
+/* Fast lookup for the averages taken by each scale. Organized alphabetically
+ * (same order as aqi_scale_t enums).
+ */
+static const aqi_windows_t AQI_WINDOWS_LOOKUP_TABLE[NUM_AQI_SCALES] = {
+  AQI_WINDOWS(AUSTRALIA_AQI_WINDOWS),
+  AQI_WINDOWS(CANADA_AQHI_WINDOWS),
+  AQI_WINDOWS(CHINA_AQI_WINDOWS),
+  AQI_WINDOWS(EUROPEAN_UNION_CAQI_WINDOWS),
+  AQI_WINDOWS(HONG_KONG_AQHI_WINDOWS),
+  AQI_WINDOWS(INDIA_AQI_WINDOWS),
+  AQI_WINDOWS(SINGAPORE_PSI_WINDOWS),
+  AQI_WINDOWS(SOUTH_KOREA_CAI_WINDOWS),
+  AQI_WINDOWS(UNITED_KINGDOM_DAQI_WINDOWS),
+  AQI_WINDOWS(UNITED_STATES_AQI_WINDOWS),
+};
+
+/* Returns the number of hourly samples averaged over a window. Hourly samples
+ * can not resolve a window shorter than an hour (the 15 minute so2 mean of the
+ * United Kingdom DAQI), which is given the last hourly concentration instead.
+ */
+static inline int window_hours(const aqi_window_t *window)
 {
-  int cai = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
+  return (window->minutes + 59) / 60;
+} // end window_hours
 
-  // co    μg/m^3, Carbon Monoxide (CO)
-  // 1ppm * 1000ppb/1ppm * 1.1456 μg/m^3/ppb = 1145.6 μg/m^3
-  if (co_1h < 2348.48)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 2291.2;
-  }
-  else if (co_1h < 10367.68)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 2405.76;
-    c_hi = 10310.4;
-  }
-  else if (co_1h < 17241.28)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 10424.96;
-    c_hi = 17184;
-  }
-  else if (co_1h < 57337.28)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 17298.56;
-    c_hi = 57280;
-  }
-  else
+/* Evaluate a scale from the averages listed in its windows table, also writing
+ * the sub-indices to 'detail' unless it is NULL.
+ */
+static int eval_australia_aqi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    // index > 500
-    return 501;
+    return australia_aqi_detail(c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+                                detail);
   }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_1h));
+  return australia_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+} // end eval_australia_aqi
 
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  // 1ppm * 1000ppb/1ppm * 1.8816 μg/m^3/ppb = 1881.6 μg/m^3
-  if (no2_1h < 57.3888)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 56.448;
-  }
-  else if (no2_1h < 113.8368)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 58.3296;
-    c_hi = 112.896;
-  }
-  else if (no2_1h < 377.2608)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 114.7776;
-    c_hi = 376.32;
-  }
-  else if (no2_1h < 3772.608)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 378.2016;
-    c_hi = 3763.2;
-  }
-  else
+static int eval_canada_aqhi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    // index > 500
-    return 501;
+    return canada_aqhi_detail(c[0], c[1], c[2], detail);
   }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
+  return canada_aqhi(c[0], c[1], c[2]);
+} // end eval_canada_aqhi
 
-  // o3    μg/m^3, Ozone (O3)
-  // 1ppm * 1000ppb/1ppm * 1.9632 μg/m^3/ppb = 1963.2 μg/m^3
-  if (o3_1h < 59.8776)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 58.896;
-  }
-  else if (o3_1h < 177.6696)
+static int eval_china_aqi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 60.8592;
-    c_hi = 176.688;
+    return china_aqi_detail(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7],
+                            c[8], c[9], detail);
   }
-  else if (o3_1h < 295.4616)
+  return china_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8],
+                   c[9]);
+} // end eval_china_aqi
+
+static int eval_european_union_caqi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 178.6512;
-    c_hi = 294.48;
+    return european_union_caqi_detail(c[0], c[1], c[2], c[3], detail);
   }
-  else if (o3_1h < 1178.9016)
+  return european_union_caqi(c[0], c[1], c[2], c[3]);
+} // end eval_european_union_caqi
+
+static int eval_hong_kong_aqhi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 296.4432;
-    c_hi = 1177.92;
+    return hong_kong_aqhi_detail(c[0], c[1], c[2], c[3], c[4], detail);
   }
-  else
+  return hong_kong_aqhi(c[0], c[1], c[2], c[3], c[4]);
+} // end eval_hong_kong_aqhi
+
+static int eval_india_aqi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    // index > 500
-    return 501;
+    return india_aqi_detail(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7],
+                            detail);
   }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
+  return india_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]);
+} // end eval_india_aqi
 
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  // 1ppm * 1000ppb/1ppm * 8.4744 μg/m^3/ppb = 8474.4 μg/m^3
-  if (so2_1h < 173.7252)
+static int eval_singapore_psi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 169.488;
+    return singapore_psi_detail(c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+                                detail);
   }
-  else if (so2_1h < 427.9572)
+  return singapore_psi(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+} // end eval_singapore_psi
+
+static int eval_south_korea_cai(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 177.9624;
-    c_hi = 423.72;
+    return south_korea_cai_detail(c[0], c[1], c[2], c[3], c[4], c[5], detail);
   }
-  else if (so2_1h < 1271.16)
+  return south_korea_cai(c[0], c[1], c[2], c[3], c[4], c[5]);
+} // end eval_south_korea_cai
+
+static int eval_united_kingdom_daqi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 432.1944;
-    c_hi = 1271.16;
+    return united_kingdom_daqi_detail(c[0], c[1], c[2], c[3], c[4], detail);
   }
-  else if (so2_1h < 8478.6372)
+  return united_kingdom_daqi(c[0], c[1], c[2], c[3], c[4]);
+} // end eval_united_kingdom_daqi
+
+static int eval_united_states_aqi(const float c[], aqi_detail_t *detail)
+{
+  if (detail != NULL)
   {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 1279.6344;
-    c_hi = 8474.4;
+    return united_states_aqi_detail(c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+                                    c[7], detail);
   }
-  else
+  return united_states_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]);
+} // end eval_united_states_aqi
+
+/* Fast lookup for eval functions. Organized alphabetically
+ * (same order as aqi_scale_t enums).
+ */
+static int (*EVAL_AQI_LOOKUP_TABLE[NUM_AQI_SCALES])(const float[],
+                                                    aqi_detail_t *) = {
+  eval_australia_aqi,
+  eval_canada_aqhi,
+  eval_china_aqi,
+  eval_european_union_caqi,
+  eval_hong_kong_aqhi,
+  eval_india_aqi,
+  eval_singapore_psi,
+  eval_south_korea_cai,
+  eval_united_kingdom_daqi,
+  eval_united_states_aqi,
+};
+
+/* An averager returns the average concentration over a window of the samples
+ * of one input form, given as 'src'.
+ */
+typedef float (*aqi_avg_fn)(const void *src, const aqi_window_t *window);
+
+/* Evaluates a scale from the averages taken by 'avg', also writing the
+ * sub-indices to 'detail' unless it is NULL. The loop is unrolled so that,
+ * with 'scale' known at compile time, every average is specialized for its
+ * window.
+ */
+static inline int eval_windows(aqi_scale_t scale, aqi_avg_fn avg,
+                               const void *src, aqi_detail_t *detail)
+{
+  const aqi_windows_t *windows = &AQI_WINDOWS_LOOKUP_TABLE[scale];
+  float c[AQI_MAX_WINDOWS];
+#if defined(__GNUC__) && __GNUC__ >= 8
+#pragma GCC unroll 10
+#endif
+  for (int w = 0; w < windows->count; ++w)
   {
-    // index > 500
-    return 501;
+    c[w] = avg(src, &windows->window[w]);
   }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_1h));
+  return EVAL_AQI_LOOKUP_TABLE[scale](c, detail);
+} // end eval_windows
 
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h < 30.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 30;
+/* Same as eval_windows(), with a copy specialized for each scale. Inlined into
+ * each input form so that its averager is inlined too.
+ */
+static inline int eval_scale(aqi_scale_t scale, aqi_avg_fn avg,
+                             const void *src, aqi_detail_t *detail)
+{
+  switch (scale)
+  {
+    case AUSTRALIA_AQI:
+      return eval_windows(AUSTRALIA_AQI,       avg, src, detail);
+    case CANADA_AQHI:
+      return eval_windows(CANADA_AQHI,         avg, src, detail);
+    case CHINA_AQI:
+      return eval_windows(CHINA_AQI,           avg, src, detail);
+    case EUROPEAN_UNION_CAQI:
+      return eval_windows(EUROPEAN_UNION_CAQI, avg, src, detail);
+    case HONG_KONG_AQHI:
+      return eval_windows(HONG_KONG_AQHI,      avg, src, detail);
+    case INDIA_AQI:
+      return eval_windows(INDIA_AQI,           avg, src, detail);
+    case SINGAPORE_PSI:
+      return eval_windows(SINGAPORE_PSI,       avg, src, detail);
+    case SOUTH_KOREA_CAI:
+      return eval_windows(SOUTH_KOREA_CAI,     avg, src, detail);
+    case UNITED_KINGDOM_DAQI:
+      return eval_windows(UNITED_KINGDOM_DAQI, avg, src, detail);
+    default:
+      return eval_windows(UNITED_STATES_AQI,   avg, src, detail);
+  }
+} // end eval_scale
+
+/* Averager of the averages taken by cache_windows(), where avg_h[p][h] is the
+ * average of pollutant p over h hours.
+ */
+typedef struct {
+  float avg_h[NUM_AQI_POLLUTANTS][24 + 1];
+} avg_cache_t;
+
+static inline float cached_window_avg(const void *src,
+                                      const aqi_window_t *window)
+{
+  const avg_cache_t *cache = src;
+  return cache->avg_h[window->pollutant][window_hours(window)];
+} // end cached_window_avg
+
+/* Takes every distinct window used by any scale once from the hourly averager
+ * 'avg'. The loops are unrolled so that every average is specialized for its
+ * window.
+ */
+static inline void cache_windows(aqi_avg_fn avg, const void *src,
+                                 avg_cache_t *cache)
+{
+  uint32_t taken[NUM_AQI_POLLUTANTS] = { 0 }; // bit h - 1 for avg_h[][h]
+#if defined(__GNUC__) && __GNUC__ >= 8
+#pragma GCC unroll 10
+#endif
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
+  {
+    const aqi_windows_t *windows = &AQI_WINDOWS_LOOKUP_TABLE[s];
+#if defined(__GNUC__) && __GNUC__ >= 8
+#pragma GCC unroll 10
+#endif
+    for (int w = 0; w < windows->count; ++w)
+    {
+      const aqi_window_t *window = &windows->window[w];
+      aqi_pollutant_t p = window->pollutant;
+      int hours = window_hours(window);
+      uint32_t bit = (uint32_t) 1 << (hours - 1);
+      if (!(taken[p] & bit))
+      {
+        cache->avg_h[p][hours] = avg(src, window);
+        taken[p] |= bit;
+      }
+    }
   }
-  else if (pm10_24h < 80.5)
+} // end cache_windows
+
+/* Evaluates every scale from the averages taken by cache_windows().
+ */
+static void eval_all_scales(const avg_cache_t *cache, int aqi[NUM_AQI_SCALES])
+{
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 31;
-    c_hi = 80;
+    aqi[s] = eval_scale((aqi_scale_t) s, cached_window_avg, cache, NULL);
   }
-  else if (pm10_24h < 150.5)
+} // end eval_all_scales
+
+/* Averager of hourly samples: 'src' is an array of NUM_AQI_POLLUTANTS
+ * pointers in aqi_pollutant_t order to 24 hourly concentrations, or NULL.
+ */
+static inline float hourly_window_avg(const void *src,
+                                      const aqi_window_t *window)
+{
+  const float *const *pollutant = src;
+  return avg_conc(pollutant[window->pollutant], window_hours(window));
+} // end hourly_window_avg
+
+AQI_API
+int calc_aqi(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  const float *pollutant[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  return eval_scale(scale, hourly_window_avg, pollutant, NULL);
+} // end calc_aqi
+
+AQI_API
+int calc_australia_aqi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(AUSTRALIA_AQI, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+} // end calc_australia_aqi
+
+AQI_API
+int calc_canada_aqhi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(CANADA_AQHI, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+} // end calc_canada_aqhi
+
+AQI_API
+int calc_china_aqi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(CHINA_AQI, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+} // end calc_china_aqi
+
+AQI_API
+int calc_european_union_caqi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(EUROPEAN_UNION_CAQI, co, nh3, no, no2, o3, pb, so2, pm10,
+                  pm2_5);
+} // end calc_european_union_caqi
+
+AQI_API
+int calc_hong_kong_aqhi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(HONG_KONG_AQHI, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+} // end calc_hong_kong_aqhi
+
+AQI_API
+int calc_india_aqi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(INDIA_AQI, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+} // end calc_india_aqi
+
+AQI_API
+int calc_singapore_psi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(SINGAPORE_PSI, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+} // end calc_singapore_psi
+
+AQI_API
+int calc_south_korea_cai(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(SOUTH_KOREA_CAI, co, nh3, no, no2, o3, pb, so2, pm10,
+                  pm2_5);
+} // end calc_south_korea_cai
+
+AQI_API
+int calc_united_kingdom_daqi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(UNITED_KINGDOM_DAQI, co, nh3, no, no2, o3, pb, so2, pm10,
+                  pm2_5);
+} // end calc_united_kingdom_daqi
+
+AQI_API
+int calc_united_states_aqi(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  return calc_aqi(UNITED_STATES_AQI, co, nh3, no, no2, o3, pb, so2, pm10,
+                  pm2_5);
+} // end calc_united_states_aqi
+
+AQI_API
+void calc_aqi_all(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24],
+             int aqi[NUM_AQI_SCALES])
+{
+  const float *pollutant[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  avg_cache_t cache;
+  cache_windows(hourly_window_avg, pollutant, &cache);
+  eval_all_scales(&cache, aqi);
+} // end calc_aqi_all
+
+/* Returns the average pollutant concentration over a given number of previous
+ * hours, read from a view. Samples are summed from least to most recent,
+ * exactly as avg_conc() does.
+ *
+ * Passing NULL (or a view with a NULL base) will return 0.
+ */
+static inline float view_avg(const aqi_view_t *view, int hours)
+{
+  if (view == NULL || view->base == NULL)
   {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 81;
-    c_hi = 150;
+    return 0.f;
   }
-  else if (pm10_24h < 600.5)
+
+  // the window is at most two runs of slots, split where it wraps around
+  size_t back  = (size_t)(hours - 1);
+  size_t slot  = view->head >= back ? view->head - back
+                                    : view->head + view->capacity - back;
+  size_t first = view->capacity - slot;
+  int    n1    = (size_t) hours < first ? hours : (int) first;
+  const char *sample = (const char *) view->base + slot * view->stride;
+
+  float avg = 0;
+  for (int h = 0; h < n1; ++h, sample += view->stride)
   {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 151;
-    c_hi = 600;
+    avg += *(const float *) sample;
   }
-  else
+  sample = (const char *) view->base;
+  for (int h = n1; h < hours; ++h, sample += view->stride)
   {
-    // index > 500
-    return 501;
+    avg += *(const float *) sample;
   }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
 
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h < 15.5)
+  avg = avg / (float) hours;
+  return avg;
+} // end view_avg
+
+AQI_API
+float avg_conc_view(const aqi_view_t *view, int hours)
+{
+  return view_avg(view, hours);
+} // end avg_conc_view
+
+/* Averager of views: 'src' is an array of NUM_AQI_POLLUTANTS pointers in
+ * aqi_pollutant_t order to views, or NULL.
+ */
+static inline float view_window_avg(const void *src,
+                                    const aqi_window_t *window)
+{
+  const aqi_view_t *const *view = src;
+  return view_avg(view[window->pollutant], window_hours(window));
+} // end view_window_avg
+
+AQI_API
+int calc_aqi_view(aqi_scale_t scale,
+             const aqi_view_t *co,  const aqi_view_t *nh3,
+             const aqi_view_t *no,  const aqi_view_t *no2,
+             const aqi_view_t *o3,  const aqi_view_t *pb,
+             const aqi_view_t *so2, const aqi_view_t *pm10,
+             const aqi_view_t *pm2_5)
+{
+  const aqi_view_t *view[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  return eval_scale(scale, view_window_avg, view, NULL);
+} // end calc_aqi_view
+
+AQI_API
+void calc_aqi_all_view(
+             const aqi_view_t *co,  const aqi_view_t *nh3,
+             const aqi_view_t *no,  const aqi_view_t *no2,
+             const aqi_view_t *o3,  const aqi_view_t *pb,
+             const aqi_view_t *so2, const aqi_view_t *pm10,
+             const aqi_view_t *pm2_5,
+             int aqi[NUM_AQI_SCALES])
+{
+  const aqi_view_t *view[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  avg_cache_t cache;
+  cache_windows(view_window_avg, view, &cache);
+  eval_all_scales(&cache, aqi);
+} // end calc_aqi_all_view
+
+/* Validity masks
+ */
+
+/* Returns the number of bits set in v, by summing bits in parallel within
+ * ever wider fields.
+ */
+static inline int popcount32(uint32_t v)
+{
+  v = v - ((v >> 1) & 0x55555555u);
+  v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+  v = (v + (v >> 4)) & 0x0f0f0f0fu;
+  return (int)((v * 0x01010101u) >> 24);
+} // end popcount32
+
+/* Returns the average concentration over the valid hours among the previous
+ * 'hours' hours, or 0 if fewer than 75% of them are valid. Hours missing from
+ * the mask are added as 0 rather than skipped, which leaves the sum unchanged
+ * without branching per hour. Windows with every hour valid take the plain
+ * avg_conc() path.
+ */
+static inline float masked_avg(const float pollutant[24], uint32_t valid,
+                               int hours)
+{
+  if (pollutant == NULL)
   {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 15;
+    return 0.f;
   }
-  else if (pm2_5_24h < 35.5)
+
+  uint32_t full   = ((uint32_t) 1 << hours) - 1;
+  uint32_t window = (valid >> (24 - hours)) & full;
+  if (window == full)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 16;
-    c_hi = 35;
+    return avg_conc(pollutant, hours);
   }
-  else if (pm2_5_24h < 75.5)
+
+  int n = popcount32(window);
+  if (4 * n < 3 * hours)
   {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 36;
-    c_hi = 75;
+    return 0.f;
   }
-  else if (pm2_5_24h < 500.5)
+
+  float avg = 0;
+  for (int h = 24 - hours ; h < 24 ; ++h)
   {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 76;
-    c_hi = 500;
+    // clear every bit of an invalid sample, turning it into +0
+    union { float f; uint32_t u; } sample = { pollutant[h] };
+    sample.u &= 0u - ((valid >> h) & 1);
+    avg += sample.f;
   }
-  else
+
+  avg = avg / (float) n;
+  return avg;
+} // end masked_avg
+
+AQI_API
+float avg_conc_masked(const float pollutant[24], uint32_t valid, int hours)
+{
+  return masked_avg(pollutant, valid, hours);
+} // end avg_conc_masked
+
+/* Averager of hourly samples with validity masks.
+ */
+typedef struct {
+  const float    *pollutant[NUM_AQI_POLLUTANTS];
+  const uint32_t *valid;
+} masked_src_t;
+
+static inline float masked_window_avg(const void *src,
+                                      const aqi_window_t *window)
+{
+  const masked_src_t *masked = src;
+  aqi_pollutant_t p = window->pollutant;
+  return masked_avg(masked->pollutant[p], masked->valid[p],
+                    window_hours(window));
+} // end masked_window_avg
+
+AQI_API
+int calc_aqi_masked(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24],
+             const uint32_t valid[NUM_AQI_POLLUTANTS])
+{
+  if (valid == NULL)
   {
-    // index > 500
-    return 501;
+    return calc_aqi(scale, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
   }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
+  const masked_src_t masked = {
+    { co, nh3, no, no2, o3, pb, so2, pm10, pm2_5 }, valid
+  };
+  return eval_scale(scale, masked_window_avg, &masked, NULL);
+} // end calc_aqi_masked
 
-  return cai;
-} // end south_korea_cai
+/* Per-pollutant sub-indices from hourly samples
+ */
 
-/* United Kingdom (DAQI)
+AQI_API
+int calc_aqi_detail(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24],
+             aqi_detail_t *detail)
+{
+  const float *pollutant[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  return eval_scale(scale, hourly_window_avg, pollutant, detail);
+} // end calc_aqi_detail
+
+/* Number of stations the batch functions process at a time. Large enough to
+ * amortize the per-chunk overhead, small enough that the per-chunk averages
+ * stay in L1 cache.
+ */
+#define AQI_BATCH_CHUNK 64
+
+/* Batch equivalent of avg_conc(). Writes the average concentration over the
+ * previous 'hours' hours of stations i0..i0+len-1 to avg[0..len-1]. Hour h of
+ * station i is column[h * stride + i], so 'stride' is n for aqi_columns_t and
+ * the plane stride for rasters.
  *
- * References:
- *   https://uk-air.defra.gov.uk/air-pollution/daqi?view=more-info
- *   https://en.wikipedia.org/wiki/Air_quality_index#United_Kingdom
- *   https://uk-air.defra.gov.uk/library/reports?report_id=750
+ * Samples are summed from least to most recent, exactly as avg_conc() does, so
+ * that results are bit-identical.
  */
-int united_kingdom_daqi(float no2_1h,   float o3_8h, float so2_15min,
-                        float pm10_24h, float pm2_5_24h)
+static void avg_conc_column(const float *column, size_t stride, size_t i0,
+                            int len, int hours, float *avg)
 {
-  // Pollutant averages are rounded to nearest integer
-  if (o3_8h >= 240.5 || no2_1h >= 600.5 || so2_15min >= 1064.5 ||
-      pm2_5_24h >= 70.5 || pm10_24h >= 100.5)
-  {
-    return 10;
-  }
-  else if (o3_8h >= 213.5 || no2_1h >= 534.5 || so2_15min >= 887.5 ||
-           pm2_5_24h >= 64.5 || pm10_24h >= 91.5)
-  {
-    return 9;
-  }
-  else if (o3_8h >= 187.5 || no2_1h >= 467.5 || so2_15min >= 710.5 ||
-           pm2_5_24h >= 58.5 || pm10_24h >= 83.5)
-  {
-    return 8;
-  }
-  else if (o3_8h >= 160.5 || no2_1h >= 400.5 || so2_15min >= 532.5 ||
-           pm2_5_24h >= 53.5 || pm10_24h >= 75.5)
+  if (column == NULL)
   {
-    return 7;
+    for (int j = 0; j < len; ++j)
+    {
+      avg[j] = 0.f;
+    }
+    return;
   }
-  else if (o3_8h >= 140.5 || no2_1h >= 334.5 || so2_15min >= 443.5 ||
-           pm2_5_24h >= 47.5 || pm10_24h >= 66.5)
+
+  for (int j = 0; j < len; ++j)
   {
-    return 6;
+    avg[j] = 0;
   }
-  else if (o3_8h >= 120.5 || no2_1h >= 267.5 || so2_15min >= 354.5 ||
-           pm2_5_24h >= 41.5 || pm10_24h >= 58.5)
+  for (int h = (24 - 1) - (hours - 1) ; h < 24 ; ++h)
   {
-    return 5;
+    const float *row = column + h * stride + i0;
+    for (int j = 0; j < len; ++j)
+    {
+      avg[j] += row[j];
+    }
   }
-  else if (o3_8h >= 100.5 || no2_1h >= 200.5 || so2_15min >= 266.5 ||
-           pm2_5_24h >= 35.5 || pm10_24h >= 50.5)
+  for (int j = 0; j < len; ++j)
   {
-    return 4;
+    avg[j] = avg[j] / (float) hours;
   }
-  else if (o3_8h >= 66.5 || no2_1h >= 134.5 || so2_15min >= 177.5 ||
-           pm2_5_24h >= 23.5 || pm10_24h >= 33.5)
+} // end avg_conc_column
+
+/* Batch equivalent of aqi = max(aqi, breakpoint_aqi(t, c)), for len
+ * concentrations.
+ */
+static void breakpoint_aqi_max_column(const breakpoint_table_t *t, int len,
+                                      const float *c, int *aqi)
+{
+  int sub[AQI_BATCH_CHUNK];
+  breakpoint_aqi_column(t, len, c, sub);
+  for (int j = 0; j < len; ++j)
   {
-    return 3;
+    aqi[j] = max(aqi[j], sub[j]);
   }
-  else if (o3_8h >= 33.5 || no2_1h >= 67.5 || so2_15min >= 88.5 ||
-           pm2_5_24h >= 11.5 || pm10_24h >= 16.5)
+} // end breakpoint_aqi_max_column
+
+/* Writes canada_aqhi_fast() of len 3-hour averages to aqhi[0..len-1], 0 where
+ * the exact path is needed.
+ */
+static void canada_aqhi_column_scalar(int len, const float *no2_3h,
+                                      const float *o3_3h,
+                                      const float *pm2_5_3h, int *aqhi)
+{
+  for (int j = 0; j < len; ++j)
   {
-    return 2;
+    aqhi[j] = canada_aqhi_fast(no2_3h[j], o3_3h[j], pm2_5_3h[j]);
   }
-  else
+} // end canada_aqhi_column_scalar
+
+/* Writes hong_kong_aqhi_fast() of len 3-hour averages to aqhi[0..len-1], 0
+ * where the exact path is needed.
+ */
+static void hong_kong_aqhi_column_scalar(int len, const float *no2_3h,
+                                         const float *o3_3h,
+                                         const float *so2_3h,
+                                         const float *pm10_3h,
+                                         const float *pm2_5_3h, int *aqhi)
+{
+  for (int j = 0; j < len; ++j)
   {
-    return 1;
+    aqhi[j] = hong_kong_aqhi_fast(no2_3h[j], o3_3h[j], so2_3h[j],
+                                  pm10_3h[j], pm2_5_3h[j]);
   }
-} // end united_kingdom_daqi
+} // end hong_kong_aqhi_column_scalar
 
-/* United States (AQI)
- *
- * References:
- *   https://www.epa.gov/outdoor-air-quality-data/how-aqi-calculated
- *   https://www.airnow.gov/sites/default/files/2020-05/aqi-technical-assistance-document-sept2018.pdf
- *   https://en.wikipedia.org/wiki/Air_quality_index#United_States
+#ifdef AQI_X86_KERNELS
+/* SSE4.2 fast_expf(), x must already be clamped to AQI_FAST_EXP_MAX_ARG.
  */
-int united_states_aqi(float co_8h,    float no2_1h,
-                      float o3_1h,    float o3_8h,
-                      float so2_1h,   float so2_24h,
-                      float pm10_24h, float pm2_5_24h)
+__attribute__((target("sse4.2")))
+static inline __m128 fast_expf_sse42(__m128 x)
 {
-  int aqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
+  __m128 n = _mm_round_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504f)),
+                          _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(0.693359375f)));
+  r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(-2.12194440e-4f)));
 
-  // Pollutant averages are truncated
-  co_8h = truncate_float(co_8h / 1145.6, 1); // (ppm) truncate to 1 decimal place
-  no2_1h = (int)(no2_1h / 1.8816);           // (ppb) truncate to integer
-  o3_1h = truncate_float(o3_1h / 1963.2, 3); // (ppm) truncate to 3 decimal places
-  o3_8h = truncate_float(o3_8h / 1963.2, 3); // (ppm) truncate to 3 decimal places
-  so2_1h = (int)(so2_1h / 8.4744);           // (ppb) truncate to integer
-  pm10_24h = (int)pm10_24h;                  // (μg/m^3) truncate to integer
-  pm2_5_24h = truncate_float(pm2_5_24h, 1);  // (μg/m^3) truncate to 1 decimal place
+  __m128 p = _mm_set1_ps(1.9875691500e-4f);
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.3981999507e-3f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073e-3f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894e-2f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201e-1f));
+  p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r),
+                 _mm_set1_ps(1.f));
 
-  // co    μg/m^3, Carbon Monoxide (CO)
-  if (co_8h <= 4.4)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 4.4;
-  }
-  else if (co_8h <= 9.4)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 4.5;
-    c_hi = 9.4;
-  }
-  else if (co_8h <= 12.4)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 9.5;
-    c_hi = 12.4;
+  // scale by 2^n
+  __m128i s = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n),
+                                           _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(p, _mm_castsi128_ps(s));
+} // end fast_expf_sse42
+
+/* Returns k * c clamped to AQI_FAST_EXP_MAX_ARG, and clears the lanes of *ok
+ * where it was out of range (or NaN).
+ */
+__attribute__((target("sse4.2")))
+static inline __m128 fast_exp_arg_sse42(float k, const float *c, __m128 *ok)
+{
+  const __m128 max_arg = _mm_set1_ps(AQI_FAST_EXP_MAX_ARG);
+  __m128 y = _mm_mul_ps(_mm_set1_ps(k), _mm_loadu_ps(c));
+  __m128 in_range = _mm_cmple_ps(_mm_andnot_ps(_mm_set1_ps(-0.f), y), max_arg);
+  *ok = _mm_and_ps(*ok, in_range);
+  return _mm_min_ps(max_arg, _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), max_arg),
+                                        y));
+} // end fast_exp_arg_sse42
+
+/* SSE4.2 kernel, evaluates 4 stations per iteration.
+ */
+__attribute__((target("sse4.2")))
+static void canada_aqhi_column_sse42(int len, const float *no2_3h,
+                                     const float *o3_3h, const float *pm2_5_3h,
+                                     int *aqhi)
+{
+  const __m128 one    = _mm_set1_ps(1.f);
+  const __m128 half   = _mm_set1_ps(0.5f);
+  const __m128 margin = _mm_set1_ps(CANADA_AQHI_FAST_MARGIN);
+  const __m128 sign   = _mm_set1_ps(-0.f);
+
+  int j = 0;
+  for (; j + 4 <= len; j += 4)
+  {
+    __m128 ok = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    __m128 e_o3    = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) CANADA_AQHI_K_O3,    o3_3h + j,    &ok));
+    __m128 e_no2   = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) CANADA_AQHI_K_NO2,   no2_3h + j,   &ok));
+    __m128 e_pm2_5 = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) CANADA_AQHI_K_PM2_5, pm2_5_3h + j, &ok));
+    __m128 v = _mm_mul_ps(_mm_set1_ps(1000 / 10.4f),
+                          _mm_add_ps(_mm_add_ps(_mm_sub_ps(e_o3, one),
+                                                _mm_sub_ps(e_no2, one)),
+                                     _mm_sub_ps(e_pm2_5, one)));
+
+    // undecided if within the error bound of a rounding boundary
+    __m128 whole = _mm_round_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m128 frac = _mm_sub_ps(v, whole);
+    __m128 dist = _mm_andnot_ps(sign, _mm_sub_ps(frac, half));
+    __m128 err = _mm_mul_ps(margin, _mm_add_ps(_mm_add_ps(e_o3, e_no2),
+                                               e_pm2_5));
+    ok = _mm_and_ps(ok, _mm_cmpgt_ps(dist, err));
+
+    __m128 r = _mm_add_ps(whole, _mm_and_ps(one, _mm_cmpgt_ps(frac, half)));
+    r = _mm_and_ps(ok, _mm_max_ps(one, r));
+    _mm_storeu_si128((__m128i *)(aqhi + j), _mm_cvttps_epi32(r));
   }
-  else if (co_8h <= 15.4)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 12.5;
-    c_hi = 15.4;
+  canada_aqhi_column_scalar(len - j, no2_3h + j, o3_3h + j, pm2_5_3h + j,
+                            aqhi + j);
+} // end canada_aqhi_column_sse42
+
+/* SSE4.2 kernel, evaluates 4 stations per iteration.
+ */
+__attribute__((target("sse4.2")))
+static void hong_kong_aqhi_column_sse42(int len, const float *no2_3h,
+                                        const float *o3_3h, const float *so2_3h,
+                                        const float *pm10_3h,
+                                        const float *pm2_5_3h, int *aqhi)
+{
+  const __m128  one     = _mm_set1_ps(1.f);
+  const __m128  hundred = _mm_set1_ps(100.f);
+  const __m128  margin  = _mm_set1_ps(HONG_KONG_AQHI_FAST_MARGIN);
+  const __m128  sign    = _mm_set1_ps(-0.f);
+
+  int j = 0;
+  for (; j + 4 <= len; j += 4)
+  {
+    __m128 ok = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    __m128 e_no2   = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) HONG_KONG_AQHI_K_NO2,   no2_3h + j,   &ok));
+    __m128 e_so2   = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) HONG_KONG_AQHI_K_SO2,   so2_3h + j,   &ok));
+    __m128 e_o3    = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) HONG_KONG_AQHI_K_O3,    o3_3h + j,    &ok));
+    __m128 e_pm10  = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) HONG_KONG_AQHI_K_PM10,  pm10_3h + j,  &ok));
+    __m128 e_pm2_5 = fast_expf_sse42(fast_exp_arg_sse42(
+                       (float) HONG_KONG_AQHI_K_PM2_5, pm2_5_3h + j, &ok));
+    __m128 ar = _mm_add_ps(
+                  _mm_add_ps(
+                    _mm_add_ps(
+                      _mm_mul_ps(_mm_sub_ps(e_no2, one), hundred),
+                      _mm_mul_ps(_mm_sub_ps(e_so2, one), hundred)),
+                    _mm_mul_ps(_mm_sub_ps(e_o3, one), hundred)),
+                  _mm_max_ps(
+                    _mm_mul_ps(_mm_sub_ps(e_pm10, one), hundred),
+                    _mm_mul_ps(_mm_sub_ps(e_pm2_5, one), hundred)));
+    __m128 err = _mm_mul_ps(
+                   margin,
+                   _mm_add_ps(_mm_add_ps(_mm_add_ps(e_no2, e_so2),
+                                         _mm_add_ps(e_o3, e_pm10)),
+                              e_pm2_5));
+
+    // band = number of upper bounds below ar, undecided if any is too close
+    __m128 r = one;
+    for (int b = 0; b < 10; ++b)
+    {
+      __m128 t = _mm_set1_ps(HONG_KONG_AQHI_AR_UPPER[b]);
+      __m128 dist = _mm_andnot_ps(sign, _mm_sub_ps(ar, t));
+      ok = _mm_and_ps(ok, _mm_cmpgt_ps(dist, err));
+      r = _mm_add_ps(r, _mm_and_ps(one, _mm_cmpgt_ps(ar, t)));
+    }
+    r = _mm_and_ps(ok, r);
+    _mm_storeu_si128((__m128i *)(aqhi + j), _mm_cvttps_epi32(r));
   }
-  else if (co_8h <= 30.4)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 15.5;
-    c_hi = 30.4;
+  hong_kong_aqhi_column_scalar(len - j, no2_3h + j, o3_3h + j, so2_3h + j,
+                               pm10_3h + j, pm2_5_3h + j, aqhi + j);
+} // end hong_kong_aqhi_column_sse42
+
+/* AVX2 fast_expf(), x must already be clamped to AQI_FAST_EXP_MAX_ARG.
+ */
+__attribute__((target("avx2")))
+static inline __m256 fast_expf_avx2(__m256 x)
+{
+  __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                             _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+  r = _mm256_sub_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+
+  __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+  p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.3981999507e-3f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(8.3334519073e-3f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(4.1665795894e-2f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.6666665459e-1f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(5.0000001201e-1f));
+  p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, r), r), r),
+                    _mm256_set1_ps(1.f));
+
+  // scale by 2^n
+  __m256i s = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                                 _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(p, _mm256_castsi256_ps(s));
+} // end fast_expf_avx2
+
+/* Returns k * c clamped to AQI_FAST_EXP_MAX_ARG, and clears the lanes of *ok
+ * where it was out of range (or NaN).
+ */
+__attribute__((target("avx2")))
+static inline __m256 fast_exp_arg_avx2(float k, const float *c, __m256 *ok)
+{
+  const __m256 max_arg = _mm256_set1_ps(AQI_FAST_EXP_MAX_ARG);
+  __m256 y = _mm256_mul_ps(_mm256_set1_ps(k), _mm256_loadu_ps(c));
+  __m256 in_range = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.f), y),
+                                  max_arg, _CMP_LE_OQ);
+  *ok = _mm256_and_ps(*ok, in_range);
+  return _mm256_min_ps(max_arg, _mm256_max_ps(_mm256_sub_ps(
+                                                _mm256_setzero_ps(), max_arg),
+                                              y));
+} // end fast_exp_arg_avx2
+
+/* AVX2 kernel, evaluates 8 stations per iteration.
+ */
+__attribute__((target("avx2")))
+static void canada_aqhi_column_avx2(int len, const float *no2_3h,
+                                    const float *o3_3h, const float *pm2_5_3h,
+                                    int *aqhi)
+{
+  const __m256 one    = _mm256_set1_ps(1.f);
+  const __m256 half   = _mm256_set1_ps(0.5f);
+  const __m256 margin = _mm256_set1_ps(CANADA_AQHI_FAST_MARGIN);
+  const __m256 sign   = _mm256_set1_ps(-0.f);
+
+  int j = 0;
+  for (; j + 8 <= len; j += 8)
+  {
+    __m256 ok = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    __m256 e_o3    = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) CANADA_AQHI_K_O3,    o3_3h + j,    &ok));
+    __m256 e_no2   = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) CANADA_AQHI_K_NO2,   no2_3h + j,   &ok));
+    __m256 e_pm2_5 = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) CANADA_AQHI_K_PM2_5, pm2_5_3h + j, &ok));
+    __m256 v = _mm256_mul_ps(_mm256_set1_ps(1000 / 10.4f),
+                             _mm256_add_ps(_mm256_add_ps(
+                                             _mm256_sub_ps(e_o3, one),
+                                             _mm256_sub_ps(e_no2, one)),
+                                           _mm256_sub_ps(e_pm2_5, one)));
+
+    // undecided if within the error bound of a rounding boundary
+    __m256 whole = _mm256_round_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m256 frac = _mm256_sub_ps(v, whole);
+    __m256 dist = _mm256_andnot_ps(sign, _mm256_sub_ps(frac, half));
+    __m256 err = _mm256_mul_ps(margin, _mm256_add_ps(_mm256_add_ps(e_o3, e_no2),
+                                                     e_pm2_5));
+    ok = _mm256_and_ps(ok, _mm256_cmp_ps(dist, err, _CMP_GT_OQ));
+
+    __m256 r = _mm256_add_ps(whole, _mm256_and_ps(
+                                      one, _mm256_cmp_ps(frac, half,
+                                                         _CMP_GT_OQ)));
+    r = _mm256_and_ps(ok, _mm256_max_ps(one, r));
+    _mm256_storeu_si256((__m256i *)(aqhi + j), _mm256_cvttps_epi32(r));
+  }
+  canada_aqhi_column_scalar(len - j, no2_3h + j, o3_3h + j, pm2_5_3h + j,
+                            aqhi + j);
+} // end canada_aqhi_column_avx2
+
+/* AVX2 kernel, evaluates 8 stations per iteration.
+ */
+__attribute__((target("avx2")))
+static void hong_kong_aqhi_column_avx2(int len, const float *no2_3h,
+                                       const float *o3_3h, const float *so2_3h,
+                                       const float *pm10_3h,
+                                       const float *pm2_5_3h, int *aqhi)
+{
+  const __m256  one     = _mm256_set1_ps(1.f);
+  const __m256  hundred = _mm256_set1_ps(100.f);
+  const __m256  margin  = _mm256_set1_ps(HONG_KONG_AQHI_FAST_MARGIN);
+  const __m256  sign    = _mm256_set1_ps(-0.f);
+
+  int j = 0;
+  for (; j + 8 <= len; j += 8)
+  {
+    __m256 ok = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    __m256 e_no2   = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) HONG_KONG_AQHI_K_NO2,   no2_3h + j,   &ok));
+    __m256 e_so2   = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) HONG_KONG_AQHI_K_SO2,   so2_3h + j,   &ok));
+    __m256 e_o3    = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) HONG_KONG_AQHI_K_O3,    o3_3h + j,    &ok));
+    __m256 e_pm10  = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) HONG_KONG_AQHI_K_PM10,  pm10_3h + j,  &ok));
+    __m256 e_pm2_5 = fast_expf_avx2(fast_exp_arg_avx2(
+                       (float) HONG_KONG_AQHI_K_PM2_5, pm2_5_3h + j, &ok));
+    __m256 ar = _mm256_add_ps(
+                  _mm256_add_ps(
+                    _mm256_add_ps(
+                      _mm256_mul_ps(_mm256_sub_ps(e_no2, one), hundred),
+                      _mm256_mul_ps(_mm256_sub_ps(e_so2, one), hundred)),
+                    _mm256_mul_ps(_mm256_sub_ps(e_o3, one), hundred)),
+                  _mm256_max_ps(
+                    _mm256_mul_ps(_mm256_sub_ps(e_pm10, one), hundred),
+                    _mm256_mul_ps(_mm256_sub_ps(e_pm2_5, one), hundred)));
+    __m256 err = _mm256_mul_ps(
+                   margin,
+                   _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(e_no2, e_so2),
+                                               _mm256_add_ps(e_o3, e_pm10)),
+                                 e_pm2_5));
+
+    // band = number of upper bounds below ar, undecided if any is too close
+    __m256 r = one;
+    for (int b = 0; b < 10; ++b)
+    {
+      __m256 t = _mm256_set1_ps(HONG_KONG_AQHI_AR_UPPER[b]);
+      __m256 dist = _mm256_andnot_ps(sign, _mm256_sub_ps(ar, t));
+      ok = _mm256_and_ps(ok, _mm256_cmp_ps(dist, err, _CMP_GT_OQ));
+      r = _mm256_add_ps(r, _mm256_and_ps(one, _mm256_cmp_ps(ar, t,
+                                                            _CMP_GT_OQ)));
+    }
+    r = _mm256_and_ps(ok, r);
+    _mm256_storeu_si256((__m256i *)(aqhi + j), _mm256_cvttps_epi32(r));
   }
-  else if (co_8h <= 40.4)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 30.5;
-    c_hi = 40.4;
+  hong_kong_aqhi_column_scalar(len - j, no2_3h + j, o3_3h + j, so2_3h + j,
+                               pm10_3h + j, pm2_5_3h + j, aqhi + j);
+} // end hong_kong_aqhi_column_avx2
+
+/* AVX-512 fast_expf(), x must already be clamped to AQI_FAST_EXP_MAX_ARG.
+ */
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static inline __m512 fast_expf_avx512(__m512 x)
+{
+  __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x,
+                                                _mm512_set1_ps(1.44269504f)),
+                                  _MM_FROUND_TO_NEAREST_INT
+                                  | _MM_FROUND_NO_EXC);
+  __m512 r = _mm512_sub_ps(x, _mm512_mul_ps(n, _mm512_set1_ps(0.693359375f)));
+  r = _mm512_sub_ps(r, _mm512_mul_ps(n, _mm512_set1_ps(-2.12194440e-4f)));
+
+  __m512 p = _mm512_set1_ps(1.9875691500e-4f);
+  p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(1.3981999507e-3f));
+  p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(8.3334519073e-3f));
+  p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(4.1665795894e-2f));
+  p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(1.6666665459e-1f));
+  p = _mm512_add_ps(_mm512_mul_ps(p, r), _mm512_set1_ps(5.0000001201e-1f));
+  p = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(p, r), r), r),
+                    _mm512_set1_ps(1.f));
+
+  // scale by 2^n
+  return _mm512_scalef_ps(p, n);
+} // end fast_expf_avx512
+
+/* Returns k * c clamped to AQI_FAST_EXP_MAX_ARG, and clears the lanes of *ok
+ * where it was out of range (or NaN).
+ */
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static inline __m512 fast_exp_arg_avx512(float k, const float *c,
+                                         __mmask16 *ok)
+{
+  const __m512 max_arg = _mm512_set1_ps(AQI_FAST_EXP_MAX_ARG);
+  __m512 y = _mm512_mul_ps(_mm512_set1_ps(k), _mm512_loadu_ps(c));
+  *ok &= _mm512_cmp_ps_mask(_mm512_abs_ps(y), max_arg, _CMP_LE_OQ);
+  return _mm512_min_ps(max_arg, _mm512_max_ps(_mm512_sub_ps(
+                                                _mm512_setzero_ps(), max_arg),
+                                              y));
+} // end fast_exp_arg_avx512
+
+/* AVX-512 kernel, evaluates 16 stations per iteration.
+ */
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void canada_aqhi_column_avx512(int len, const float *no2_3h,
+                                      const float *o3_3h,
+                                      const float *pm2_5_3h, int *aqhi)
+{
+  const __m512 one    = _mm512_set1_ps(1.f);
+  const __m512 half   = _mm512_set1_ps(0.5f);
+  const __m512 margin = _mm512_set1_ps(CANADA_AQHI_FAST_MARGIN);
+
+  int j = 0;
+  for (; j + 16 <= len; j += 16)
+  {
+    __mmask16 ok = 0xffff;
+    __m512 e_o3    = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) CANADA_AQHI_K_O3,    o3_3h + j,    &ok));
+    __m512 e_no2   = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) CANADA_AQHI_K_NO2,   no2_3h + j,   &ok));
+    __m512 e_pm2_5 = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) CANADA_AQHI_K_PM2_5, pm2_5_3h + j, &ok));
+    __m512 v = _mm512_mul_ps(_mm512_set1_ps(1000 / 10.4f),
+                             _mm512_add_ps(_mm512_add_ps(
+                                             _mm512_sub_ps(e_o3, one),
+                                             _mm512_sub_ps(e_no2, one)),
+                                           _mm512_sub_ps(e_pm2_5, one)));
+
+    // undecided if within the error bound of a rounding boundary
+    __m512 whole = _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF
+                                           | _MM_FROUND_NO_EXC);
+    __m512 frac = _mm512_sub_ps(v, whole);
+    __m512 dist = _mm512_abs_ps(_mm512_sub_ps(frac, half));
+    __m512 err = _mm512_mul_ps(margin, _mm512_add_ps(_mm512_add_ps(e_o3, e_no2),
+                                                     e_pm2_5));
+    ok &= _mm512_cmp_ps_mask(dist, err, _CMP_GT_OQ);
+
+    __mmask16 up = _mm512_cmp_ps_mask(frac, half, _CMP_GT_OQ);
+    __m512 r = _mm512_max_ps(one, _mm512_mask_add_ps(whole, up, whole, one));
+    _mm512_storeu_si512((void *)(aqhi + j),
+                        _mm512_maskz_cvttps_epi32(ok, r));
+  }
+  canada_aqhi_column_scalar(len - j, no2_3h + j, o3_3h + j, pm2_5_3h + j,
+                            aqhi + j);
+} // end canada_aqhi_column_avx512
+
+/* AVX-512 kernel, evaluates 16 stations per iteration.
+ */
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void hong_kong_aqhi_column_avx512(int len, const float *no2_3h,
+                                         const float *o3_3h,
+                                         const float *so2_3h,
+                                         const float *pm10_3h,
+                                         const float *pm2_5_3h, int *aqhi)
+{
+  const __m512  one     = _mm512_set1_ps(1.f);
+  const __m512  hundred = _mm512_set1_ps(100.f);
+  const __m512  margin  = _mm512_set1_ps(HONG_KONG_AQHI_FAST_MARGIN);
+  const __m512i ione    = _mm512_set1_epi32(1);
+
+  int j = 0;
+  for (; j + 16 <= len; j += 16)
+  {
+    __mmask16 ok = 0xffff;
+    __m512 e_no2   = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) HONG_KONG_AQHI_K_NO2,   no2_3h + j,   &ok));
+    __m512 e_so2   = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) HONG_KONG_AQHI_K_SO2,   so2_3h + j,   &ok));
+    __m512 e_o3    = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) HONG_KONG_AQHI_K_O3,    o3_3h + j,    &ok));
+    __m512 e_pm10  = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) HONG_KONG_AQHI_K_PM10,  pm10_3h + j,  &ok));
+    __m512 e_pm2_5 = fast_expf_avx512(fast_exp_arg_avx512(
+                       (float) HONG_KONG_AQHI_K_PM2_5, pm2_5_3h + j, &ok));
+    __m512 ar = _mm512_add_ps(
+                  _mm512_add_ps(
+                    _mm512_add_ps(
+                      _mm512_mul_ps(_mm512_sub_ps(e_no2, one), hundred),
+                      _mm512_mul_ps(_mm512_sub_ps(e_so2, one), hundred)),
+                    _mm512_mul_ps(_mm512_sub_ps(e_o3, one), hundred)),
+                  _mm512_max_ps(
+                    _mm512_mul_ps(_mm512_sub_ps(e_pm10, one), hundred),
+                    _mm512_mul_ps(_mm512_sub_ps(e_pm2_5, one), hundred)));
+    __m512 err = _mm512_mul_ps(
+                   margin,
+                   _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(e_no2, e_so2),
+                                               _mm512_add_ps(e_o3, e_pm10)),
+                                 e_pm2_5));
+
+    // band = number of upper bounds below ar, undecided if any is too close
+    __m512i r = ione;
+    for (int b = 0; b < 10; ++b)
+    {
+      __m512 t = _mm512_set1_ps(HONG_KONG_AQHI_AR_UPPER[b]);
+      ok &= _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(ar, t)), err,
+                               _CMP_GT_OQ);
+      r = _mm512_mask_add_epi32(r, _mm512_cmp_ps_mask(ar, t, _CMP_GT_OQ),
+                                r, ione);
+    }
+    _mm512_storeu_si512((void *)(aqhi + j), _mm512_maskz_mov_epi32(ok, r));
   }
-  else if (co_8h <= 50.4)
+  hong_kong_aqhi_column_scalar(len - j, no2_3h + j, o3_3h + j, so2_3h + j,
+                               pm10_3h + j, pm2_5_3h + j, aqhi + j);
+} // end hong_kong_aqhi_column_avx512
+#endif // x86
+
+/* Writes the Canadian AQHI of len 3-hour averages to aqhi[0..len-1] using the
+ * kernel of the selected instruction set, 0 where the exact path is needed.
+ */
+static void canada_aqhi_column(int len, const float *no2_3h,
+                               const float *o3_3h, const float *pm2_5_3h,
+                               int *aqhi)
+{
+  switch (kernel_isa)
+  {
+#ifdef AQI_X86_KERNELS
+    case AQI_ISA_AVX512:
+      canada_aqhi_column_avx512(len, no2_3h, o3_3h, pm2_5_3h, aqhi);
+      return;
+    case AQI_ISA_AVX2:
+      canada_aqhi_column_avx2(len, no2_3h, o3_3h, pm2_5_3h, aqhi);
+      return;
+    case AQI_ISA_SSE4_2:
+      canada_aqhi_column_sse42(len, no2_3h, o3_3h, pm2_5_3h, aqhi);
+      return;
+#endif
+    default:
+      canada_aqhi_column_scalar(len, no2_3h, o3_3h, pm2_5_3h, aqhi);
+      return;
+  }
+} // end canada_aqhi_column
+
+/* Writes the Hong Kong AQHI of len 3-hour averages to aqhi[0..len-1] using the
+ * kernel of the selected instruction set, 0 where the exact path is needed.
+ */
+static void hong_kong_aqhi_column(int len, const float *no2_3h,
+                                  const float *o3_3h, const float *so2_3h,
+                                  const float *pm10_3h, const float *pm2_5_3h,
+                                  int *aqhi)
+{
+  switch (kernel_isa)
+  {
+#ifdef AQI_X86_KERNELS
+    case AQI_ISA_AVX512:
+      hong_kong_aqhi_column_avx512(len, no2_3h, o3_3h, so2_3h, pm10_3h,
+                                   pm2_5_3h, aqhi);
+      return;
+    case AQI_ISA_AVX2:
+      hong_kong_aqhi_column_avx2(len, no2_3h, o3_3h, so2_3h, pm10_3h,
+                                 pm2_5_3h, aqhi);
+      return;
+    case AQI_ISA_SSE4_2:
+      hong_kong_aqhi_column_sse42(len, no2_3h, o3_3h, so2_3h, pm10_3h,
+                                  pm2_5_3h, aqhi);
+      return;
+#endif
+    default:
+      hong_kong_aqhi_column_scalar(len, no2_3h, o3_3h, so2_3h, pm10_3h,
+                                   pm2_5_3h, aqhi);
+      return;
+  }
+} // end hong_kong_aqhi_column
+
+/* Batch kernels. Evaluate a scale for len stations from the averages listed in
+ * its windows table, where c[w][j] is average w of station j. The kernels may
+ * overwrite the averages.
+ */
+static void batch_australia_aqi(int len, float c[][AQI_BATCH_CHUNK],
+                                int *aqi)
+{
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 40.5;
-    c_hi = 50.4;
+    aqi[j] = australia_aqi(c[0][j], c[1][j], c[2][j], c[3][j], c[4][j],
+                           c[5][j], c[6][j]);
   }
-  else
+} // end batch_australia_aqi
+
+static void batch_canada_aqhi(int len, float c[][AQI_BATCH_CHUNK],
+                              int *aqhi)
+{
+  const float *no2_3h   = c[0];
+  const float *o3_3h    = c[1];
+  const float *pm2_5_3h = c[2];
+  canada_aqhi_column(len, no2_3h, o3_3h, pm2_5_3h, aqhi);
+  for (int j = 0; j < len; ++j)
   {
-    // index > 500
-    return 501;
+    if (aqhi[j] == 0)
+    {
+      aqhi[j] = canada_aqhi_exact(no2_3h[j], o3_3h[j], pm2_5_3h[j]);
+    }
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_8h));
+} // end batch_canada_aqhi
 
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_1h <= 53)
+static void batch_china_aqi(int len, float c[][AQI_BATCH_CHUNK],
+                            int *aqi)
+{
+  int sub[AQI_BATCH_CHUNK];
+  for (int j = 0; j < len; ++j)
+  {
+    aqi[j] = 0;
+  }
+  breakpoint_aqi_max_column(&CHINA_AQI_CO_1H,     len, c[0], aqi);
+  breakpoint_aqi_max_column(&CHINA_AQI_CO_24H,    len, c[1], aqi);
+  breakpoint_aqi_max_column(&CHINA_AQI_NO2_1H,    len, c[2], aqi);
+  breakpoint_aqi_max_column(&CHINA_AQI_NO2_24H,   len, c[3], aqi);
+  breakpoint_aqi_max_column(&CHINA_AQI_O3_1H,     len, c[4], aqi);
+  breakpoint_aqi_max_column(&CHINA_AQI_SO2_24H,   len, c[7], aqi);
+  breakpoint_aqi_max_column(&CHINA_AQI_PM10_24H,  len, c[8], aqi);
+  breakpoint_aqi_max_column(&CHINA_AQI_PM2_5_24H, len, c[9], aqi);
+
+  // o3_8h and so2_1h are not calculated above 800 μg/m^3
+  const float *o3_8h  = c[5];
+  const float *so2_1h = c[6];
+  breakpoint_aqi_column(&CHINA_AQI_O3_8H, len, o3_8h, sub);
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 53;
+    aqi[j] = max(aqi[j], o3_8h[j] <= 800 ? sub[j] : 0);
   }
-  else if (no2_1h <= 100)
+  breakpoint_aqi_column(&CHINA_AQI_SO2_1H, len, so2_1h, sub);
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 54;
-    c_hi = 100;
+    aqi[j] = max(aqi[j], so2_1h[j] <= 800 ? sub[j] : 0);
   }
-  else if (no2_1h <= 360)
+} // end batch_china_aqi
+
+static void batch_european_union_caqi(int len,
+                                      float c[][AQI_BATCH_CHUNK],
+                                      int *caqi)
+{
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 101;
-    c_hi = 360;
+    caqi[j] = 0;
   }
-  else if (no2_1h <= 649)
+  breakpoint_aqi_max_column(&EUROPEAN_UNION_CAQI_NO2_1H,   len, c[0], caqi);
+  breakpoint_aqi_max_column(&EUROPEAN_UNION_CAQI_O3_1H,    len, c[1], caqi);
+  breakpoint_aqi_max_column(&EUROPEAN_UNION_CAQI_PM10_1H,  len, c[2], caqi);
+  breakpoint_aqi_max_column(&EUROPEAN_UNION_CAQI_PM2_5_1H, len, c[3], caqi);
+} // end batch_european_union_caqi
+
+static void batch_hong_kong_aqhi(int len, float c[][AQI_BATCH_CHUNK],
+                                 int *aqhi)
+{
+  hong_kong_aqhi_column(len, c[0], c[1], c[2], c[3], c[4], aqhi);
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 361;
-    c_hi = 649;
+    if (aqhi[j] == 0)
+    {
+      aqhi[j] = hong_kong_aqhi_exact(c[0][j], c[1][j], c[2][j], c[3][j],
+                                     c[4][j]);
+    }
   }
-  else if (no2_1h <= 1249)
+} // end batch_hong_kong_aqhi
+
+static void batch_india_aqi(int len, float c[][AQI_BATCH_CHUNK],
+                            int *aqi)
+{
+  for (int j = 0; j < len; ++j)
+  {
+    aqi[j] = 0;
+  }
+  breakpoint_aqi_max_column(&INDIA_AQI_CO_8H,     len, c[0], aqi);
+  breakpoint_aqi_max_column(&INDIA_AQI_NH3_24H,   len, c[1], aqi);
+  breakpoint_aqi_max_column(&INDIA_AQI_NO2_24H,   len, c[2], aqi);
+  breakpoint_aqi_max_column(&INDIA_AQI_O3_8H,     len, c[3], aqi);
+  breakpoint_aqi_max_column(&INDIA_AQI_PB_24H,    len, c[4], aqi);
+  breakpoint_aqi_max_column(&INDIA_AQI_SO2_24H,   len, c[5], aqi);
+  breakpoint_aqi_max_column(&INDIA_AQI_PM10_24H,  len, c[6], aqi);
+  breakpoint_aqi_max_column(&INDIA_AQI_PM2_5_24H, len, c[7], aqi);
+} // end batch_india_aqi
+
+static void batch_singapore_psi(int len, float c[][AQI_BATCH_CHUNK],
+                                int *psi)
+{
+  const float *no2_1h = c[1];
+  float *o3 = c[3];
+  int sub[AQI_BATCH_CHUNK];
+  for (int j = 0; j < len; ++j)
+  {
+    psi[j] = 0;
+    o3[j] = singapore_psi_o3(c[2][j], c[3][j]);
+  }
+  breakpoint_aqi_max_column(&SINGAPORE_PSI_CO_8H,     len, c[0], psi);
+  breakpoint_aqi_max_column(&SINGAPORE_PSI_O3,        len, o3,   psi);
+  breakpoint_aqi_max_column(&SINGAPORE_PSI_SO2_24H,   len, c[4], psi);
+  breakpoint_aqi_max_column(&SINGAPORE_PSI_PM10_24H,  len, c[5], psi);
+  breakpoint_aqi_max_column(&SINGAPORE_PSI_PM2_5_24H, len, c[6], psi);
+
+  breakpoint_aqi_column(&SINGAPORE_PSI_NO2_1H, len, no2_1h, sub);
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 350;
-    c_hi = 1249;
+    psi[j] = max(psi[j], singapore_psi_no2(no2_1h[j], sub[j]));
   }
-  else if (no2_1h <= 1649)
+} // end batch_singapore_psi
+
+static void batch_south_korea_cai(int len, float c[][AQI_BATCH_CHUNK],
+                                  int *cai)
+{
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1250;
-    c_hi = 1649;
+    cai[j] = 0;
   }
-  else if (no2_1h <= 2049)
+  breakpoint_aqi_max_column(&SOUTH_KOREA_CAI_CO_1H,     len, c[0], cai);
+  breakpoint_aqi_max_column(&SOUTH_KOREA_CAI_NO2_1H,    len, c[1], cai);
+  breakpoint_aqi_max_column(&SOUTH_KOREA_CAI_O3_1H,     len, c[2], cai);
+  breakpoint_aqi_max_column(&SOUTH_KOREA_CAI_SO2_1H,    len, c[3], cai);
+  breakpoint_aqi_max_column(&SOUTH_KOREA_CAI_PM10_24H,  len, c[4], cai);
+  breakpoint_aqi_max_column(&SOUTH_KOREA_CAI_PM2_5_24H, len, c[5], cai);
+} // end batch_south_korea_cai
+
+/* Batch equivalent of daqi = max(daqi, UNITED_KINGDOM_DAQI_LOOKUP(lut, c)),
+ * for len concentrations.
+ */
+static void united_kingdom_daqi_max_column(const uint8_t *lut, int lut_len,
+                                           int len, const float *c, int *daqi)
+{
+  for (int j = 0; j < len; ++j)
   {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 1650;
-    c_hi = 2049;
+    daqi[j] = max(daqi[j], lut[united_kingdom_daqi_index(c[j], lut_len)]);
   }
-  else
+} // end united_kingdom_daqi_max_column
+
+#define UNITED_KINGDOM_DAQI_MAX_COLUMN(lut, len, c, daqi) \
+  united_kingdom_daqi_max_column((lut), sizeof(lut) / sizeof((lut)[0]), \
+                                 (len), (c), (daqi))
+
+static void batch_united_kingdom_daqi(int len,
+                                      float c[][AQI_BATCH_CHUNK],
+                                      int *daqi)
+{
+  for (int j = 0; j < len; ++j)
+  {
+    daqi[j] = 1;
+  }
+  UNITED_KINGDOM_DAQI_MAX_COLUMN(UNITED_KINGDOM_DAQI_NO2_1H_LUT,
+                                 len, c[0], daqi);
+  UNITED_KINGDOM_DAQI_MAX_COLUMN(UNITED_KINGDOM_DAQI_O3_8H_LUT,
+                                 len, c[1], daqi);
+  UNITED_KINGDOM_DAQI_MAX_COLUMN(UNITED_KINGDOM_DAQI_SO2_15MIN_LUT,
+                                 len, c[2], daqi);
+  UNITED_KINGDOM_DAQI_MAX_COLUMN(UNITED_KINGDOM_DAQI_PM10_24H_LUT,
+                                 len, c[3], daqi);
+  UNITED_KINGDOM_DAQI_MAX_COLUMN(UNITED_KINGDOM_DAQI_PM2_5_24H_LUT,
+                                 len, c[4], daqi);
+} // end batch_united_kingdom_daqi
+
+static void batch_united_states_aqi(int len, float c[][AQI_BATCH_CHUNK],
+                                    int *aqi)
+{
+  for (int j = 0; j < len; ++j)
   {
-    // index > 500
-    return 501;
+    aqi[j] = united_states_aqi(c[0][j], c[1][j], c[2][j], c[3][j], c[4][j],
+                               c[5][j], c[6][j], c[7][j]);
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
+} // end batch_united_states_aqi
 
-  // o3    μg/m^3, Ground-Level Ozone (O3)
-  if (o3_1h >= 0.125)
+/* Fast lookup for batch kernels. Organized alphabetically
+ * (same order as aqi_scale_t enums).
+ */
+static void (*BATCH_AQI_LOOKUP_TABLE[NUM_AQI_SCALES])(
+                          int, float[][AQI_BATCH_CHUNK], int *) = {
+  batch_australia_aqi,
+  batch_canada_aqhi,
+  batch_china_aqi,
+  batch_european_union_caqi,
+  batch_hong_kong_aqhi,
+  batch_india_aqi,
+  batch_singapore_psi,
+  batch_south_korea_cai,
+  batch_united_kingdom_daqi,
+  batch_united_states_aqi,
+};
+
+/* Batch equivalent of eval_scale(). Evaluates a scale for n stations, where
+ * hour h of pollutant p at station i is column[p][h * stride + i] (NULL if the
+ * pollutant is not available), AQI_BATCH_CHUNK stations at a time.
+ */
+static void batch_scale(aqi_scale_t scale, size_t n, size_t stride,
+                        const float *const column[NUM_AQI_POLLUTANTS],
+                        int *out)
+{
+  const aqi_windows_t *windows = &AQI_WINDOWS_LOOKUP_TABLE[scale];
+  float avg[AQI_MAX_WINDOWS][AQI_BATCH_CHUNK];
+  for (size_t i0 = 0; i0 < n; i0 += AQI_BATCH_CHUNK)
   {
-    if (o3_1h <= 0.164)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 0.125;
-      c_hi = 0.164;
-    }
-    else if (o3_1h <= 0.204)
-    {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 0.165;
-      c_hi = 0.204;
-    }
-    else if (o3_1h <= 0.404)
-    {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 0.205;
-      c_hi = 0.404;
-    }
-    else if (o3_1h <= 1649)
-    {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 1250;
-      c_hi = 1649;
-    }
-    else if (o3_1h <= 2049)
-    {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 1650;
-      c_hi = 2049;
-    }
-    else
+    int len = (n - i0 < AQI_BATCH_CHUNK) ? (int)(n - i0) : AQI_BATCH_CHUNK;
+    for (int w = 0; w < windows->count; ++w)
     {
-      // index > 500
-      return 501;
+      const aqi_window_t *window = &windows->window[w];
+      avg_conc_column(column[window->pollutant], stride, i0, len,
+                      window_hours(window), avg[w]);
     }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
+    BATCH_AQI_LOOKUP_TABLE[scale](len, avg, out + i0);
   }
-  if (o3_8h <= 0.200)
+} // end batch_scale
+
+/* Returns the samples of a species starting at 'offset', or NULL if the
+ * species is not available.
+ */
+static const float *column_at(const float *species, size_t offset)
+{
+  return species == NULL ? NULL : species + offset;
+} // end column_at
+
+/* Writes the columns of 'in', each starting at 'offset', to column[] in
+ * aqi_pollutant_t order.
+ */
+static void columns_at(const aqi_columns_t *in, size_t offset,
+                       const float *column[NUM_AQI_POLLUTANTS])
+{
+  column[POLLUTANT_CO]    = column_at(in->co,    offset);
+  column[POLLUTANT_NH3]   = column_at(in->nh3,   offset);
+  column[POLLUTANT_NO]    = column_at(in->no,    offset);
+  column[POLLUTANT_NO2]   = column_at(in->no2,   offset);
+  column[POLLUTANT_O3]    = column_at(in->o3,    offset);
+  column[POLLUTANT_PB]    = column_at(in->pb,    offset);
+  column[POLLUTANT_SO2]   = column_at(in->so2,   offset);
+  column[POLLUTANT_PM10]  = column_at(in->pm10,  offset);
+  column[POLLUTANT_PM2_5] = column_at(in->pm2_5, offset);
+} // end columns_at
+
+AQI_API
+void calc_aqi_batch(aqi_scale_t scale, size_t n, const aqi_columns_t *in,
+                    int *out)
+{
+  const float *column[NUM_AQI_POLLUTANTS];
+  columns_at(in, 0, column);
+  batch_scale(scale, n, n, column, out);
+} // end calc_aqi_batch
+
+/* Number of cells of a raster row evaluated at a time, sized so the samples a
+ * tile reads from every plane stay in the L1 and L2 caches.
+ */
+#define AQI_RASTER_TILE 256
+
+AQI_API
+void calc_aqi_raster(aqi_scale_t scale, const aqi_raster_t *in, size_t hour,
+                     size_t row_begin, size_t row_end,
+                     int16_t *out, size_t out_stride)
+{
+  int aqi[AQI_RASTER_TILE];
+  for (size_t r = row_begin; r < row_end; ++r)
   {
-    if (o3_8h <= 0.054)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 0.054;
-    }
-    else if (o3_8h <= 0.070)
+    for (size_t c0 = 0; c0 < in->cols; c0 += AQI_RASTER_TILE)
     {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 0.055;
-      c_hi = 0.070;
-    }
-    else if (o3_8h <= 0.085)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 0.071;
-      c_hi = 0.085;
-    }
-    else if (o3_8h <= 0.105)
-    {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 0.086;
-      c_hi = 0.105;
-    }
-    else
-    {
-      // 0.106 <= o3_8h <= 0.200
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 0.106;
-      c_hi = 0.200;
+      size_t len = in->cols - c0 < AQI_RASTER_TILE ? in->cols - c0
+                                                   : AQI_RASTER_TILE;
+      size_t offset = (hour - 23) * in->plane_stride + r * in->row_stride + c0;
+      const float *tile[NUM_AQI_POLLUTANTS] = {
+        column_at(in->co,    offset),
+        column_at(in->nh3,   offset),
+        column_at(in->no,    offset),
+        column_at(in->no2,   offset),
+        column_at(in->o3,    offset),
+        column_at(in->pb,    offset),
+        column_at(in->so2,   offset),
+        column_at(in->pm10,  offset),
+        column_at(in->pm2_5, offset),
+      };
+      batch_scale(scale, len, in->plane_stride, tile, aqi);
+
+      int16_t *dst = out + r * out_stride + c0;
+      for (size_t j = 0; j < len; ++j)
+      {
+        dst[j] = (int16_t) min(max(aqi[j], INT16_MIN), INT16_MAX);
+      }
     }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
   }
+} // end calc_aqi_raster
 
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  if (so2_1h <= 185)
+/* Number of stations in a task of calc_aqi_batch_parallel(), and minimum
+ * number of cells in a task of calc_aqi_raster_parallel(). Large enough to
+ * amortize scheduling, small enough to balance a few thousand stations.
+ */
+#define AQI_PARALLEL_CHUNK 512
+
+/* Runs task(arg, i) for every i in [0, count) on an executor, or in order on
+ * the calling thread if there is none.
+ */
+static void run_tasks(const aqi_executor_t *executor, size_t count,
+                      aqi_task_fn task, void *arg)
+{
+  if (executor == NULL)
   {
-    if (so2_1h <= 35)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 35;
-    }
-    else if (so2_1h <= 75)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 36;
-      c_hi = 75;
-    }
-    else
+    for (size_t i = 0; i < count; ++i)
     {
-      // 76 <= so2_1h <= 185
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 76;
-      c_hi = 185;
+      task(arg, i);
     }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_1h));
   }
   else
   {
-    if (so2_24h <= 35)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 35;
-    }
-    else if (so2_24h <= 75)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 36;
-      c_hi = 75;
-    }
-    else if (so2_24h <= 185)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 76;
-      c_hi = 185;
-    }
-    else if (so2_24h <= 304)
+    executor->run(executor->ctx, count, task, arg);
+  }
+} // end run_tasks
+
+typedef struct {
+  aqi_scale_t scale;
+  size_t n;
+  const aqi_columns_t *in;
+  int *out;
+} batch_job_t;
+
+/* Evaluates chunk 'index' of a batch job.
+ */
+static void batch_chunk(void *arg, size_t index)
+{
+  const batch_job_t *job = arg;
+  size_t i0 = index * AQI_PARALLEL_CHUNK;
+  size_t len = job->n - i0 < AQI_PARALLEL_CHUNK ? job->n - i0
+                                                : AQI_PARALLEL_CHUNK;
+  const float *column[NUM_AQI_POLLUTANTS];
+  columns_at(job->in, i0, column);
+  batch_scale(job->scale, len, job->n, column, job->out + i0);
+} // end batch_chunk
+
+AQI_API
+void calc_aqi_batch_parallel(aqi_scale_t scale, size_t n,
+                             const aqi_columns_t *in, int *out,
+                             const aqi_executor_t *executor)
+{
+  batch_job_t job = { scale, n, in, out };
+  run_tasks(executor, (n + AQI_PARALLEL_CHUNK - 1) / AQI_PARALLEL_CHUNK,
+            batch_chunk, &job);
+} // end calc_aqi_batch_parallel
+
+typedef struct {
+  aqi_scale_t scale;
+  const aqi_raster_t *in;
+  size_t hour;
+  size_t rows_per_task;
+  int16_t *out;
+  size_t out_stride;
+} raster_job_t;
+
+/* Evaluates band 'index' of a raster job.
+ */
+static void raster_band(void *arg, size_t index)
+{
+  const raster_job_t *job = arg;
+  size_t row_begin = index * job->rows_per_task;
+  size_t row_end = job->in->rows - row_begin < job->rows_per_task
+                 ? job->in->rows : row_begin + job->rows_per_task;
+  calc_aqi_raster(job->scale, job->in, job->hour, row_begin, row_end,
+                  job->out, job->out_stride);
+} // end raster_band
+
+AQI_API
+void calc_aqi_raster_parallel(aqi_scale_t scale, const aqi_raster_t *in,
+                              size_t hour, int16_t *out, size_t out_stride,
+                              const aqi_executor_t *executor)
+{
+  raster_job_t job = { scale, in, hour, 1, out, out_stride };
+  if (in->cols < AQI_PARALLEL_CHUNK)
+  {
+    job.rows_per_task = in->cols == 0 ? in->rows + 1
+                                      : AQI_PARALLEL_CHUNK / in->cols;
+  }
+  run_tasks(executor, (in->rows + job.rows_per_task - 1) / job.rows_per_task,
+            raster_band, &job);
+} // end calc_aqi_raster_parallel
+
+#ifdef AQI_THREADS
+/* Takes the next task of a thread's own range.
+ */
+static int pool_pop(aqi_pool_t *pool, int self, size_t *index)
+{
+  aqi_pool_queue_t *queue = &pool->queues[self];
+  int found = 0;
+  pthread_mutex_lock(&queue->lock);
+  if (queue->next < queue->end)
+  {
+    *index = queue->next++;
+    found = 1;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return found;
+} // end pool_pop
+
+/* Moves the later half of the remaining range of another thread to a thread
+ * whose own range is empty, and takes its first task. Victims are tried in
+ * order starting after 'self'.
+ */
+static int pool_steal(aqi_pool_t *pool, int self, size_t *index)
+{
+  for (int k = 1; k < pool->threads; ++k)
+  {
+    aqi_pool_queue_t *victim = &pool->queues[(self + k) % pool->threads];
+    size_t begin, end;
+    pthread_mutex_lock(&victim->lock);
+    end = victim->end;
+    begin = end - (end - victim->next) / 2;
+    if (begin == end && victim->next < end)
     {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 186;
-      c_hi = 304;
+      --begin;
     }
-    else if (so2_24h <= 604)
+    victim->end = begin;
+    pthread_mutex_unlock(&victim->lock);
+    if (begin < end)
     {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 305;
-      c_hi = 604;
+      // The victim's lock is released first, so two threads stealing from
+      // each other never wait on each other.
+      aqi_pool_queue_t *queue = &pool->queues[self];
+      pthread_mutex_lock(&queue->lock);
+      queue->next = begin + 1;
+      queue->end = end;
+      pthread_mutex_unlock(&queue->lock);
+      *index = begin;
+      return 1;
     }
-    else if (so2_24h <= 804)
+  }
+  return 0;
+} // end pool_steal
+
+/* Runs tasks of the current call until none is left to take.
+ */
+static void pool_work(aqi_pool_t *pool, int self)
+{
+  size_t index;
+  while (pool_pop(pool, self, &index) || pool_steal(pool, self, &index))
+  {
+    pool->task(pool->arg, index);
+  }
+} // end pool_work
+
+static void *pool_thread(void *arg)
+{
+  const aqi_pool_worker_t *worker = arg;
+  aqi_pool_t *pool = worker->pool;
+  unsigned long seen = 0;
+  pthread_mutex_lock(&pool->lock);
+  for (;;)
+  {
+    while (!pool->quit && pool->generation == seen)
     {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 605;
-      c_hi = 804;
+      pthread_cond_wait(&pool->start, &pool->lock);
     }
-    else if (so2_24h <= 1004)
+    if (pool->quit)
     {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 805;
-      c_hi = 1004;
+      break;
     }
-    else
+    seen = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_work(pool, worker->index);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->busy == 0)
     {
-      // index > 500
-      return 501;
+      pthread_cond_signal(&pool->done);
     }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
   }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+} // end pool_thread
 
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h <= 54)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 54;
-  }
-  else if (pm10_24h <= 154)
+/* aqi_executor_t run function of an aqi_pool_t.
+ */
+static void pool_run(void *ctx, size_t count, aqi_task_fn task, void *arg)
+{
+  aqi_pool_t *pool = ctx;
+  if (pool->threads == 1)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 55;
-    c_hi = 154;
+    run_tasks(NULL, count, task, arg);
+    return;
   }
-  else if (pm10_24h <= 254)
+
+  pthread_mutex_lock(&pool->run_lock);
+  // Every thread is idle here; the queues are published to them by pool->lock.
+  for (int t = 0; t < pool->threads; ++t)
+  {
+    pool->queues[t].next = count / pool->threads * t
+                         + count % pool->threads * t / pool->threads;
+    pool->queues[t].end = count / pool->threads * (t + 1)
+                        + count % pool->threads * (t + 1) / pool->threads;
+  }
+  pthread_mutex_lock(&pool->lock);
+  pool->task = task;
+  pool->arg = arg;
+  pool->busy = pool->threads - 1;
+  ++pool->generation;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  pool_work(pool, 0);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->busy > 0)
   {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 155;
-    c_hi = 254;
+    pthread_cond_wait(&pool->done, &pool->lock);
   }
-  else if (pm10_24h <= 354)
+  pthread_mutex_unlock(&pool->lock);
+  pthread_mutex_unlock(&pool->run_lock);
+} // end pool_run
+
+AQI_API
+int aqi_pool_init(aqi_pool_t *pool, int threads)
+{
+  if (threads < 1)
   {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 255;
-    c_hi = 354;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 && cpus < AQI_POOL_MAX_THREADS ? (int) cpus
+            : cpus > 0 ? AQI_POOL_MAX_THREADS : 1;
   }
-  else if (pm10_24h <= 424)
+  if (threads > AQI_POOL_MAX_THREADS)
   {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 355;
-    c_hi = 424;
+    threads = AQI_POOL_MAX_THREADS;
   }
-  else if (pm10_24h <= 504)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 425;
-    c_hi = 504;
+
+  pthread_mutex_init(&pool->run_lock, NULL);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  pool->generation = 0;
+  pool->busy = 0;
+  pool->quit = 0;
+  pool->task = NULL;
+  pool->arg = NULL;
+
+  pthread_mutex_init(&pool->queues[0].lock, NULL);
+  pool->threads = 1;
+  for (int t = 1; t < threads; ++t)
+  {
+    aqi_pool_worker_t *worker = &pool->workers[t];
+    worker->pool = pool;
+    worker->index = t;
+    pthread_mutex_init(&pool->queues[t].lock, NULL);
+    if (pthread_create(&worker->thread, NULL, pool_thread, worker) != 0)
+    {
+      pthread_mutex_destroy(&pool->queues[t].lock);
+      break;
+    }
+    pool->threads = t + 1;
   }
-  else if (pm10_24h <= 604)
+  return pool->threads;
+} // end aqi_pool_init
+
+AQI_API
+void aqi_pool_destroy(aqi_pool_t *pool)
+{
+  pthread_mutex_lock(&pool->lock);
+  pool->quit = 1;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int t = 1; t < pool->threads; ++t)
   {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 505;
-    c_hi = 604;
+    pthread_join(pool->workers[t].thread, NULL);
   }
-  else
+  for (int t = 0; t < pool->threads; ++t)
   {
-    // index > 500
-    return 501;
+    pthread_mutex_destroy(&pool->queues[t].lock);
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->start);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_mutex_destroy(&pool->run_lock);
+} // end aqi_pool_destroy
 
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h <= 12.0)
+AQI_API
+aqi_executor_t aqi_pool_executor(aqi_pool_t *pool)
+{
+  aqi_executor_t executor = { pool_run, pool };
+  return executor;
+} // end aqi_pool_executor
+#endif // AQI_THREADS
+
+/* Number of consecutive stations sorted by scale at a time by
+ * calc_aqi_mixed(). Small enough that the samples of a block stay in the L2
+ * cache while each scale gathers its stations from it.
+ */
+#define AQI_MIXED_BLOCK 1024
+
+/* Returns the number of stations calc_aqi_mixed() evaluates at a time.
+ */
+static size_t mixed_block(size_t n)
+{
+  return n < AQI_MIXED_BLOCK ? n : AQI_MIXED_BLOCK;
+} // end mixed_block
+
+AQI_API
+size_t calc_aqi_mixed_scratch_size(size_t n)
+{
+  size_t block = mixed_block(n);
+  return block * (sizeof(size_t) + 9 * 24 * sizeof(float) + sizeof(int));
+} // end calc_aqi_mixed_scratch_size
+
+/* Copies the last 'hours' hours of stations order[0..len-1] of an n-station
+ * column into a tile with len stations per hour, and returns the tile, or NULL
+ * if the column is not available or not used.
+ */
+static const float *mixed_gather(const float *column, size_t n, int hours,
+                                 const size_t *order, size_t len, float *tile)
+{
+  if (column == NULL || hours == 0)
   {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 12.0;
+    return NULL;
   }
-  else if (pm2_5_24h <= 35.4)
+  for (int h = 24 - hours; h < 24; ++h)
   {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 12.1;
-    c_hi = 35.4;
+    const float *src = column + h * n;
+    float *dst = tile + h * len;
+    for (size_t j = 0; j < len; ++j)
+    {
+      dst[j] = src[order[j]];
+    }
   }
-  else if (pm2_5_24h <= 55.4)
+  return tile;
+} // end mixed_gather
+
+AQI_API
+void calc_aqi_mixed(size_t n, const aqi_scale_t *scales,
+                    const aqi_columns_t *in, int *out, void *scratch)
+{
+  size_t block = mixed_block(n);
+  size_t *order = scratch;
+  float *samples = (float *) (order + block);
+  int *aqi = (int *) (samples + 9 * 24 * block);
+  const float *column[NUM_AQI_POLLUTANTS];
+  columns_at(in, 0, column);
+
+  for (size_t i0 = 0; i0 < n; i0 += block)
   {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 35.5;
-    c_hi = 55.4;
+    size_t i1 = n - i0 < block ? n : i0 + block;
+
+    // Stable counting sort of the block's stations by scale.
+    size_t begin[NUM_AQI_SCALES + 1] = { 0 };
+    size_t next[NUM_AQI_SCALES];
+    for (size_t i = i0; i < i1; ++i)
+    {
+      ++begin[scales[i] + 1];
+    }
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      begin[s + 1] += begin[s];
+      next[s] = begin[s];
+    }
+    for (size_t i = i0; i < i1; ++i)
+    {
+      order[next[scales[i]]++] = i;
+    }
+
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      const size_t *group = order + begin[s];
+      size_t len = begin[s + 1] - begin[s];
+      if (len == 0)
+      {
+        continue;
+      }
+
+      // gather the longest average over each pollutant taken by the scale
+      const aqi_windows_t *windows = &AQI_WINDOWS_LOOKUP_TABLE[s];
+      int hours[NUM_AQI_POLLUTANTS] = { 0 };
+      for (int w = 0; w < windows->count; ++w)
+      {
+        aqi_pollutant_t p = windows->window[w].pollutant;
+        hours[p] = max(hours[p], window_hours(&windows->window[w]));
+      }
+      const float *tile[NUM_AQI_POLLUTANTS];
+      for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+      {
+        tile[p] = mixed_gather(column[p], n, hours[p], group, len,
+                               samples + p * 24 * len);
+      }
+      batch_scale((aqi_scale_t) s, len, len, tile, aqi);
+
+      for (size_t j = 0; j < len; ++j)
+      {
+        out[group[j]] = aqi[j];
+      }
+    }
   }
-  else if (pm2_5_24h <= 150.4)
+} // end calc_aqi_mixed
+
+/* Lengths of the windows tracked by aqi_state_t, in hours.
+ */
+static const int AQI_STATE_HOURS[AQI_STATE_WINDOWS] = { 1, 3, 4, 8, 24 };
+
+/* Recomputes the running sums of the state from its ring buffer. Called once
+ * per lap of the ring buffer so that rounding errors can not accumulate.
+ */
+static void aqi_state_resum(aqi_state_t *state)
+{
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 55.5;
-    c_hi = 150.4;
+    for (int w = 0; w < AQI_STATE_WINDOWS; ++w)
+    {
+      double sum = 0;
+      for (int h = 1; h <= AQI_STATE_HOURS[w]; ++h)
+      {
+        sum += state->hist[p][(state->head + 24 - h) % 24];
+      }
+      state->sum[p][w] = sum;
+    }
   }
-  else if (pm2_5_24h <= 250.4)
+} // end aqi_state_resum
+
+AQI_API
+void aqi_state_init(aqi_state_t *state)
+{
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 150.5;
-    c_hi = 250.4;
+    for (int h = 0; h < 24; ++h)
+    {
+      state->hist[p][h] = 0.f;
+    }
+    for (int w = 0; w < AQI_STATE_WINDOWS; ++w)
+    {
+      state->sum[p][w] = 0;
+    }
   }
-  else if (pm2_5_24h <= 350.4)
+  state->head = 0;
+} // end aqi_state_init
+
+AQI_API
+void aqi_push_hour(aqi_state_t *state,
+                   float co,  float nh3, float no,   float no2,  float o3,
+                   float pb,  float so2, float pm10, float pm2_5)
+{
+  const float conc[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  int head = state->head;
+
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 250.5;
-    c_hi = 350.4;
+    for (int w = 0; w < AQI_STATE_WINDOWS; ++w)
+    {
+      // the sample that drops out of the window
+      float old = state->hist[p][(head + 24 - AQI_STATE_HOURS[w]) % 24];
+      state->sum[p][w] += (double) conc[p] - old;
+    }
+    state->hist[p][head] = conc[p];
   }
-  else if (pm2_5_24h <= 500.4)
+
+  state->head = (head + 1) % 24;
+  if (state->head == 0)
   {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 350.5;
-    c_hi = 500.4;
+    aqi_state_resum(state);
   }
-  else
+} // end aqi_push_hour
+
+AQI_API
+float aqi_state_avg(const aqi_state_t *state, aqi_pollutant_t pollutant,
+                    int hours)
+{
+  int w = 0;
+  while (w < AQI_STATE_WINDOWS - 1 && AQI_STATE_HOURS[w] < hours)
   {
-    // index > 500
-    return 501;
+    ++w;
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
+  return (float)(state->sum[pollutant][w] / AQI_STATE_HOURS[w]);
+} // end aqi_state_avg
 
-  return aqi;
-} // end united_states_aqi
+/* Averager of a rolling state: 'src' is an aqi_state_t.
+ */
+static inline float state_window_avg(const void *src,
+                                     const aqi_window_t *window)
+{
+  return aqi_state_avg(src, window->pollutant, window_hours(window));
+} // end state_window_avg
 
-/*
- * Indicates Air Quality
+AQI_API
+int aqi_state_eval(const aqi_state_t *state, aqi_scale_t scale)
+{
+  return eval_scale(scale, state_window_avg, state, NULL);
+} // end aqi_state_eval
+
+/* Sliding evaluation of long histories
  */
-const char *australia_aqi_desc(int aqi)
+
+AQI_API
+float avg_conc_n(const float *pollutant, size_t count, int hours)
 {
-  if (aqi <= 33)
+  if (pollutant == NULL)
   {
-    return AUSTRALIA_AQI_TXT[0];
+    return 0.f;
   }
-  else if (aqi <= 66)
+
+  float avg = 0;
+  // index (count - 1) is most recent hourly concentration
+  for (size_t h = count - (size_t) hours ; h < count ; ++h)
   {
-    return AUSTRALIA_AQI_TXT[1];
+    avg += pollutant[h];
   }
-  else if (aqi <= 99)
+
+  avg = avg / (float) hours;
+  return avg;
+} // end avg_conc_n
+
+/* Returns the last 24 of 'count' samples, or NULL if not available.
+ */
+static const float *history_last_24(const float *pollutant, size_t count)
+{
+  return pollutant == NULL ? NULL : pollutant + (count - 24);
+} // end history_last_24
+
+AQI_API
+int calc_aqi_n(aqi_scale_t scale, size_t count,
+             const float *co,  const float *nh3,  const float *no,
+             const float *no2, const float *o3,   const float *pb,
+             const float *so2, const float *pm10, const float *pm2_5)
+{
+  return calc_aqi(scale, history_last_24(co,    count),
+                         history_last_24(nh3,   count),
+                         history_last_24(no,    count),
+                         history_last_24(no2,   count),
+                         history_last_24(o3,    count),
+                         history_last_24(pb,    count),
+                         history_last_24(so2,   count),
+                         history_last_24(pm10,  count),
+                         history_last_24(pm2_5, count));
+} // end calc_aqi_n
+
+/* Averages over long histories for calc_aqi_series().
+ *
+ * Windows of up to 8 hours are summed from the samples exactly as avg_conc()
+ * does. The 24 hour window keeps a running sum per pollutant instead, which is
+ * summed from the samples the first time it is used, slid by one sample per
+ * hour after that, and summed from the samples again once every 24 hours so
+ * that rounding errors can not accumulate.
+ */
+typedef struct {
+  const float *hist[NUM_AQI_POLLUTANTS];
+  double       sum_24h[NUM_AQI_POLLUTANTS];
+  size_t       resum_at[NUM_AQI_POLLUTANTS];
+  size_t       t; // the most recent hour of the current evaluation
+} series_t;
+
+/* Returns the average concentration of a pollutant over the 'hours' hours
+ * ending at hour s->t, where 'hours' is one of 1, 3, 4, 8 or 24. Must be
+ * called for every hour from 23 onward, at most once per hour for the 24 hour
+ * average of each pollutant.
+ */
+static inline float series_avg(series_t *s, aqi_pollutant_t pollutant,
+                               int hours)
+{
+  const float *x = s->hist[pollutant];
+  size_t t = s->t;
+  if (x == NULL)
   {
-    return AUSTRALIA_AQI_TXT[2];
+    return 0.f;
   }
-  else if (aqi <= 149)
+
+  if (hours < 24)
   {
-    return AUSTRALIA_AQI_TXT[3];
+    float avg = 0;
+    for (size_t h = t + 1 - (size_t) hours; h <= t; ++h)
+    {
+      avg += x[h];
+    }
+    return avg / (float) hours;
   }
-  else if (aqi <= 200)
+
+  double *sum = &s->sum_24h[pollutant];
+  if (t >= s->resum_at[pollutant])
   {
-    return AUSTRALIA_AQI_TXT[4];
+    *sum = 0;
+    for (size_t h = t + 1 - 24; h <= t; ++h)
+    {
+      *sum += x[h];
+    }
+    s->resum_at[pollutant] = t + 24;
   }
   else
   {
-    return AUSTRALIA_AQI_TXT[5];
+    *sum += (double) x[t] - x[t - 24];
   }
-} // end australia_aqi_desc
+  return (float)(*sum / 24);
+} // end series_avg
 
-/*
- * Indicates Health Risk
+/* Averager of long histories: 'src' is a series_t.
  */
-const char *canada_aqhi_desc(int aqhi)
+static inline float series_window_avg(const void *src,
+                                      const aqi_window_t *window)
 {
-  if (aqhi <= 4)
-  {
-    return CANADA_AQHI_TXT[0];
-  }
-  else if (aqhi <= 6)
-  {
-    return CANADA_AQHI_TXT[1];
-  }
-  else if (aqhi <= 10)
-  {
-    return CANADA_AQHI_TXT[2];
-  }
-  else
+  return series_avg((series_t *) src, window->pollutant, window_hours(window));
+} // end series_window_avg
+
+AQI_API
+void calc_aqi_series(aqi_scale_t scale, size_t count,
+             const float *co,  const float *nh3,  const float *no,
+             const float *no2, const float *o3,   const float *pb,
+             const float *so2, const float *pm10, const float *pm2_5,
+             int *out)
+{
+  series_t s = {
+    .hist = { co, nh3, no, no2, o3, pb, so2, pm10, pm2_5 },
+  };
+
+  for (size_t t = 23; t < count; ++t)
   {
-    return CANADA_AQHI_TXT[3];
+    s.t = t;
+    out[t - 23] = eval_scale(scale, series_window_avg, &s, NULL);
   }
-} // end canada_aqhi_desc
+} // end calc_aqi_series
 
-/*
- * Indicates Air Pollution
+/* Prefix sums
  */
-const char *china_aqi_desc(int aqi)
+
+AQI_API
+void aqi_prefix_build(aqi_prefix_t *prefix, double *sum,
+                      const float *pollutant, size_t count)
 {
-  if (aqi <= 50)
-  {
-    return CHINA_AQI_TXT[0];
+  // Neumaier's compensated summation, so that each running sum is the sum of
+  // the samples rounded once rather than once per sample
+  double total = 0;
+  double comp  = 0;
+  sum[0] = 0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    double x = pollutant[k];
+    double t = total + x;
+    if (fabs(total) >= fabs(x))
+    {
+      comp += (total - t) + x;
+    }
+    else
+    {
+      comp += (x - t) + total;
+    }
+    total = t;
+    sum[k + 1] = total + comp;
   }
-  else if (aqi <= 100)
+
+  prefix->sum   = sum;
+  prefix->count = count;
+} // end aqi_prefix_build
+
+/* Returns the average concentration over the 'hours' hours ending at (and
+ * including) sample 'hour'. Passing NULL (or a prefix with a NULL sum) will
+ * return 0.
+ */
+static inline float prefix_avg(const aqi_prefix_t *prefix, size_t hour,
+                               int hours)
+{
+  if (prefix == NULL || prefix->sum == NULL)
   {
-    return CHINA_AQI_TXT[1];
+    return 0.f;
   }
-  else if (aqi <= 150)
+  return (float)((prefix->sum[hour + 1] - prefix->sum[hour + 1 - hours])
+                 / hours);
+} // end prefix_avg
+
+AQI_API
+float aqi_prefix_avg(const aqi_prefix_t *prefix, size_t hour, int hours)
+{
+  return prefix_avg(prefix, hour, hours);
+} // end aqi_prefix_avg
+
+/* Averager of prefix sums at a given hour.
+ */
+typedef struct {
+  const aqi_prefix_t *prefix[NUM_AQI_POLLUTANTS];
+  size_t              hour;
+} prefix_src_t;
+
+static inline float prefix_window_avg(const void *src,
+                                      const aqi_window_t *window)
+{
+  const prefix_src_t *p = src;
+  return prefix_avg(p->prefix[window->pollutant], p->hour,
+                    window_hours(window));
+} // end prefix_window_avg
+
+AQI_API
+int calc_aqi_prefix(aqi_scale_t scale, size_t hour,
+             const aqi_prefix_t *co,  const aqi_prefix_t *nh3,
+             const aqi_prefix_t *no,  const aqi_prefix_t *no2,
+             const aqi_prefix_t *o3,  const aqi_prefix_t *pb,
+             const aqi_prefix_t *so2, const aqi_prefix_t *pm10,
+             const aqi_prefix_t *pm2_5)
+{
+  const prefix_src_t prefix = {
+    { co, nh3, no, no2, o3, pb, so2, pm10, pm2_5 }, hour
+  };
+  return eval_scale(scale, prefix_window_avg, &prefix, NULL);
+} // end calc_aqi_prefix
+
+/* US EPA NowCast
+ */
+
+/* Returns the NowCast of 12 hourly samples organized from least recent
+ * (index 0) to most recent (index 11), or NaN if it is not available.
+ */
+static float nowcast_12h(const float c[AQI_NOWCAST_HOURS])
+{
+  const int last = AQI_NOWCAST_HOURS - 1;
+  // at least 2 of the 3 most recent hours must have a sample (NaN != NaN)
+  if ((c[last] == c[last]) + (c[last - 1] == c[last - 1])
+      + (c[last - 2] == c[last - 2]) < 2)
   {
-    return CHINA_AQI_TXT[2];
+    return NAN;
   }
-  else if (aqi <= 200)
+
+  float c_min = INFINITY;
+  float c_max = -INFINITY;
+  for (int h = 0; h < AQI_NOWCAST_HOURS; ++h)
   {
-    return CHINA_AQI_TXT[3];
+    if (c[h] == c[h])
+    {
+      c_min = c[h] < c_min ? c[h] : c_min;
+      c_max = c[h] > c_max ? c[h] : c_max;
+    }
   }
-  else if (aqi <= 300)
-  {
-    return CHINA_AQI_TXT[4];
+
+  // weight factor, 1 when every sample is 0
+  float w = c_max > 0 ? c_min / c_max : 1.f;
+  w = w > 0.5f ? w : 0.5f;
+
+  // sums of w^(i-1) * ci and w^(i-1) by Horner's rule, least recent first
+  float num = 0;
+  float den = 0;
+  for (int h = 0; h < AQI_NOWCAST_HOURS; ++h)
+  {
+    num *= w;
+    den *= w;
+    if (c[h] == c[h])
+    {
+      num += c[h];
+      den += 1;
+    }
   }
-  else
+  return num / den;
+} // end nowcast_12h
+
+AQI_API
+float nowcast_conc(const float pollutant[24])
+{
+  if (pollutant == NULL)
   {
-    return CHINA_AQI_TXT[5];
+    return 0.f;
   }
-} // end china_aqi_desc
+  return nowcast_12h(pollutant + (24 - AQI_NOWCAST_HOURS));
+} // end nowcast_conc
 
-/*
- * Indicates Air Pollution
+/* Averager that takes the NowCast of pm10 and pm2_5 and every other average
+ * from another averager. A NowCast that is not available counts as 0, like a
+ * missing pollutant.
  */
-const char *european_union_caqi_desc(int caqi)
+typedef struct {
+  aqi_avg_fn  avg;
+  const void *src;
+  float       pm10;
+  float       pm2_5;
+} nowcast_src_t;
+
+static inline float nowcast_window_avg(const void *src,
+                                       const aqi_window_t *window)
 {
-  if (caqi <= 25)
-  {
-    return EUROPEAN_UNION_CAQI_TXT[0];
-  }
-  else if (caqi <= 50)
-  {
-    return EUROPEAN_UNION_CAQI_TXT[1];
-  }
-  else if (caqi <= 75)
-  {
-    return EUROPEAN_UNION_CAQI_TXT[2];
-  }
-  else if (caqi <= 100)
+  const nowcast_src_t *nowcast = src;
+  switch (window->pollutant)
   {
-    return EUROPEAN_UNION_CAQI_TXT[3];
+    case POLLUTANT_PM10:
+      return nowcast->pm10 == nowcast->pm10 ? nowcast->pm10 : 0.f;
+    case POLLUTANT_PM2_5:
+      return nowcast->pm2_5 == nowcast->pm2_5 ? nowcast->pm2_5 : 0.f;
+    default:
+      return nowcast->avg(nowcast->src, window);
   }
-  else
+} // end nowcast_window_avg
+
+AQI_API
+int calc_united_states_aqi_nowcast(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  const float *pollutant[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  const nowcast_src_t nowcast = {
+    hourly_window_avg, pollutant, nowcast_conc(pm10), nowcast_conc(pm2_5)
+  };
+  return eval_scale(UNITED_STATES_AQI, nowcast_window_avg, &nowcast, NULL);
+} // end calc_united_states_aqi_nowcast
+
+AQI_API
+void aqi_nowcast_init(aqi_nowcast_t *nowcast)
+{
+  for (int h = 0; h < 2 * AQI_NOWCAST_HOURS; ++h)
   {
-    return EUROPEAN_UNION_CAQI_TXT[4];
+    nowcast->hist[h] = NAN;
   }
-} // end european_union_caqi_desc
+  nowcast->head = 0;
+} // end aqi_nowcast_init
 
-/*
- * Indicates Health Risk
+AQI_API
+void aqi_nowcast_push(aqi_nowcast_t *nowcast, float conc)
+{
+  // slots head..head+11 hold the last 12 hours, least recent first
+  int head = nowcast->head;
+  nowcast->hist[head] = conc;
+  nowcast->hist[head + AQI_NOWCAST_HOURS] = conc;
+  nowcast->head = (head + 1) % AQI_NOWCAST_HOURS;
+} // end aqi_nowcast_push
+
+AQI_API
+float aqi_nowcast_value(const aqi_nowcast_t *nowcast)
+{
+  return nowcast_12h(nowcast->hist + nowcast->head);
+} // end aqi_nowcast_value
+
+AQI_API
+int aqi_state_eval_nowcast(const aqi_state_t *state,
+                           const aqi_nowcast_t *pm10,
+                           const aqi_nowcast_t *pm2_5)
+{
+  const nowcast_src_t nowcast = {
+    state_window_avg, state,
+    pm10  == NULL ? 0.f : aqi_nowcast_value(pm10),
+    pm2_5 == NULL ? 0.f : aqi_nowcast_value(pm2_5)
+  };
+  return eval_scale(UNITED_STATES_AQI, nowcast_window_avg, &nowcast, NULL);
+} // end aqi_state_eval_nowcast
+
+/* Minute-resolution rolling state
  */
-const char *hong_kong_aqhi_desc(int aqhi)
+
+/* Lengths of the windows tracked by aqi_minute_state_t, in minutes.
+ */
+static const int AQI_MINUTE_STATE_MINUTES[AQI_MINUTE_STATE_WINDOWS] = {
+  15, 60, 180, 240, 480, 1440
+};
+
+/* Recomputes the running sums of the state from its ring buffer. Called once
+ * per lap of the ring buffer so that rounding errors can not accumulate.
+ */
+static void aqi_minute_state_resum(aqi_minute_state_t *state)
 {
-  if (aqhi <= 3)
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    return HONG_KONG_AQHI_TXT[0];
+    for (int w = 0; w < AQI_MINUTE_STATE_WINDOWS; ++w)
+    {
+      double sum = 0;
+      for (int m = 1; m <= AQI_MINUTE_STATE_MINUTES[w]; ++m)
+      {
+        sum += state->hist[p][(state->head + AQI_MINUTES_PER_DAY - m)
+                              % AQI_MINUTES_PER_DAY];
+      }
+      state->sum[p][w] = sum;
+    }
   }
-  else if (aqhi <= 6)
+} // end aqi_minute_state_resum
+
+AQI_API
+void aqi_minute_state_init(aqi_minute_state_t *state)
+{
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    return HONG_KONG_AQHI_TXT[1];
+    for (int m = 0; m < AQI_MINUTES_PER_DAY; ++m)
+    {
+      state->hist[p][m] = 0.f;
+    }
+    for (int w = 0; w < AQI_MINUTE_STATE_WINDOWS; ++w)
+    {
+      state->sum[p][w] = 0;
+    }
   }
-  else if (aqhi <= 7)
+  state->head = 0;
+} // end aqi_minute_state_init
+
+AQI_API
+void aqi_push_minute(aqi_minute_state_t *state,
+                     float co,  float nh3, float no,   float no2,  float o3,
+                     float pb,  float so2, float pm10, float pm2_5)
+{
+  const float conc[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  int head = state->head;
+
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
   {
-    return HONG_KONG_AQHI_TXT[2];
+    for (int w = 0; w < AQI_MINUTE_STATE_WINDOWS; ++w)
+    {
+      // the sample that drops out of the window
+      int drop = head - AQI_MINUTE_STATE_MINUTES[w];
+      drop += drop < 0 ? AQI_MINUTES_PER_DAY : 0;
+      state->sum[p][w] += (double) conc[p] - state->hist[p][drop];
+    }
+    state->hist[p][head] = conc[p];
   }
-  else if (aqhi <= 10)
+
+  state->head = head + 1 < AQI_MINUTES_PER_DAY ? head + 1 : 0;
+  if (state->head == 0)
   {
-    return HONG_KONG_AQHI_TXT[3];
+    aqi_minute_state_resum(state);
   }
-  else
+} // end aqi_push_minute
+
+AQI_API
+float aqi_minute_state_avg(const aqi_minute_state_t *state,
+                           aqi_pollutant_t pollutant, int minutes)
+{
+  int w = 0;
+  while (w < AQI_MINUTE_STATE_WINDOWS - 1
+         && AQI_MINUTE_STATE_MINUTES[w] < minutes)
   {
-    return HONG_KONG_AQHI_TXT[4];
+    ++w;
   }
-} // end hong_kong_aqhi_desc
+  return (float)(state->sum[pollutant][w] / AQI_MINUTE_STATE_MINUTES[w]);
+} // end aqi_minute_state_avg
 
-/*
- * Indicates Air Quality
+/* Averager of a minute-resolution rolling state: 'src' is an
+ * aqi_minute_state_t. Unlike the hourly averagers, windows shorter than an
+ * hour are taken as they are.
  */
-const char *india_aqi_desc(int aqi)
+static inline float minute_state_window_avg(const void *src,
+                                            const aqi_window_t *window)
 {
-  if (aqi <= 50)
-  {
-    return INDIA_AQI_TXT[0];
-  }
-  else if (aqi <= 100)
-  {
-    return INDIA_AQI_TXT[1];
-  }
-  else if (aqi <= 200)
-  {
-    return INDIA_AQI_TXT[2];
-  }
-  else if (aqi <= 300)
-  {
-    return INDIA_AQI_TXT[3];
-  }
-  else if (aqi <= 400)
+  return aqi_minute_state_avg(src, window->pollutant, window->minutes);
+} // end minute_state_window_avg
+
+AQI_API
+int aqi_minute_state_eval(const aqi_minute_state_t *state, aqi_scale_t scale)
+{
+  return eval_scale(scale, minute_state_window_avg, state, NULL);
+} // end aqi_minute_state_eval
+
+#ifdef AQI_FIXED_POINT
+/* Fixed-point evaluation
+ *
+ * Integer-only versions of the scale functions, for targets without a
+ * hardware FPU. Concentrations are aqi_fixed_t, in hundredths of a μg/m^3.
+ */
+
+/* Returns num / den rounded to the nearest integer, with halfway cases
+ * rounded away from zero (like round()). 'den' must be positive.
+ */
+static int64_t fixed_div_round(int64_t num, int64_t den)
+{
+  if (num >= 0)
   {
-    return INDIA_AQI_TXT[4];
+    return (2 * num + den) / (2 * den);
   }
-  else
+  return -((2 * -num + den) / (2 * den));
+} // end fixed_div_round
+
+/* Returns num / den rounded down (like floorf()). 'den' must be positive.
+ */
+static int64_t fixed_div_floor(int64_t num, int64_t den)
+{
+  if (num >= 0)
   {
-    return INDIA_AQI_TXT[5];
+    return num / den;
   }
-} // end india_aqi_desc
+  return -((-num + den - 1) / den);
+} // end fixed_div_floor
 
-/*
- * Indicates Health Risk
+/* Breakpoints of a piecewise linear sub-index, in integer units.
+ *
+ * The integer equivalent of breakpoint_table_t. A concentration c (usually in
+ * hundredths of a μg/m^3) falls into the first band b for which c < c_lt[b].
+ * c_lo and c_hi are scaled by a further 100, so that breakpoints given to 4
+ * decimal places (e.g. South Korea) are exact.
+ *
+ * The tables below hold the same breakpoints as their float counterparts.
+ * Where a breakpoint like 3.55 is not exactly representable as a float, c_lt
+ * follows the comparison breakpoint_band() makes on the float concentration,
+ * so both versions put c and (float) c / 100 into the same band.
  */
-const char *singapore_psi_desc(int psi)
+typedef struct {
+  int     num_bands;
+  int     over;
+  int32_t c_lt[AQI_MAX_BANDS];
+  int32_t i_lo[AQI_MAX_BANDS];
+  int32_t i_hi[AQI_MAX_BANDS];
+  int32_t c_lo[AQI_MAX_BANDS];
+  int32_t c_hi[AQI_MAX_BANDS];
+} breakpoint_fixed_t;
+
+/* Returns the sub-index of concentration c, or t->over if c is off the scale.
+ * Equivalent to breakpoint_aqi().
+ */
+static int breakpoint_aqi_fixed(const breakpoint_fixed_t *t, int32_t c)
 {
-  if (psi <= 50)
+  int b = 0;
+  for (int i = 0; i < t->num_bands; ++i)
   {
-    return SINGAPORE_PSI_TXT[0];
+    b += (c >= t->c_lt[i]);
   }
-  else if (psi <= 100)
+  if (b >= t->num_bands)
   {
-    return SINGAPORE_PSI_TXT[1];
+    return t->over;
   }
-  else if (psi <= 200)
+
+  // concentrations between bands (below c_lo) evaluate to i_lo
+  int64_t num = (int64_t)(t->i_hi[b] - t->i_lo[b])
+                * ((int64_t) c * 100 - t->c_lo[b]);
+  if (num <= 0)
   {
-    return SINGAPORE_PSI_TXT[2];
+    return t->i_lo[b];
   }
-  else if (psi <= 300)
+  return min(t->i_hi[b],
+             t->i_lo[b] + (int) fixed_div_round(num, t->c_hi[b] - t->c_lo[b]));
+} // end breakpoint_aqi_fixed
+
+/* 2^(j/64) in Q30, for j = 0..63
+ */
+static const int32_t AQI_FIXED_EXP2_TABLE[64] = {
+  1073741824, 1085434106, 1097253708, 1109202018,
+  1121280436, 1133490379, 1145833280, 1158310587,
+  1170923762, 1183674286, 1196563654, 1209593378,
+  1222764986, 1236080024, 1249540052, 1263146652,
+  1276901417, 1290805962, 1304861917, 1319070932,
+  1333434672, 1347954824, 1362633090, 1377471191,
+  1392470869, 1407633882, 1422962010, 1438457051,
+  1454120821, 1469955159, 1485961921, 1502142985,
+  1518500250, 1535035634, 1551751076, 1568648537,
+  1585730000, 1602997467, 1620452965, 1638098541,
+  1655936265, 1673968228, 1692196547, 1710623359,
+  1729250827, 1748081133, 1767116489, 1786359126,
+  1805811301, 1825475297, 1845353420, 1865448001,
+  1885761398, 1906295993, 1927054196, 1948038440,
+  1969251188, 1990694927, 2012372174, 2034285470,
+  2056437387, 2078830522, 2101467502, 2124350982,
+};
+
+#define AQI_FIXED_LN2_Q30 744261118
+
+/* 1.0 in the Q30 format returned by fixed_exp()
+ */
+#define AQI_FIXED_EXP_ONE ((int64_t) 1 << 30)
+
+/* Exponents are clamped to +/-21 * ln(2) (about e^14.5), which keeps the AQHI
+ * sums within 64 bits. Reaching the clamp takes concentrations far beyond any
+ * that have been measured (e.g. ~30000 μg/m^3 of pm2_5).
+ */
+#define AQI_FIXED_EXP2_MAX ((int64_t) 21 << 32)
+
+/* Returns e^(k * c / 100) in Q30, where c is a fixed-point concentration and
+ * k_q is k / (100 * ln(2)) in Q48.
+ *
+ * The exponent is split into 2^n * 2^(j/64) * 2^r with 0 <= r < 1/64. 2^r is
+ * evaluated with a 3rd order Taylor polynomial, whose error (< 1e-9) is about
+ * the resolution of the result.
+ */
+static int64_t fixed_exp(int64_t k_q, aqi_fixed_t c)
+{
+  // z = k * c / (100 * ln(2)), in Q32
+  int64_t z = k_q * c / 65536;
+  if (z > AQI_FIXED_EXP2_MAX)
   {
-    return SINGAPORE_PSI_TXT[3];
+    z = AQI_FIXED_EXP2_MAX;
   }
-  else
+  else if (z < -AQI_FIXED_EXP2_MAX)
   {
-    return SINGAPORE_PSI_TXT[4];
+    z = -AQI_FIXED_EXP2_MAX;
   }
-} // end singapore_psi_desc
 
-/*
- * Indicates Health Risk
+  int64_t n = fixed_div_floor(z, (int64_t) 1 << 32);
+  int64_t g = z - n * ((int64_t) 1 << 32);
+  int     j = (int)(g >> 26);
+
+  // t = r * ln(2), 2^r = e^t
+  int64_t t  = (((g & 0x3ffffff) >> 2) * AQI_FIXED_LN2_Q30) >> 30;
+  int64_t t2 = (t * t) >> 30;
+  int64_t p  = ((int64_t) 1 << 30) + t + t2 / 2 + ((t2 * t) >> 30) / 6;
+  int64_t m  = ((int64_t) AQI_FIXED_EXP2_TABLE[j] * p) >> 30;
+
+  // scale by 2^n
+  return n >= 0 ? m << n : m >> -n;
+} // end fixed_exp
+
+/* Australia (AQI)
+ *
+ * Standards in 1/10000 μg/m^3, see australia_aqi().
  */
-const char *south_korea_cai_desc(int cai)
+static int compute_nepm_aqi_fixed(int64_t std, aqi_fixed_t c)
 {
-  if (cai <= 50)
-  {
-    return SOUTH_KOREA_CAI_TXT[0];
-  }
-  else if (cai <= 100)
+  // c / std * 100, c in hundredths of a μg/m^3
+  return (int) fixed_div_round((int64_t) c * 10000, std);
+} // end compute_nepm_aqi_fixed
+
+AQI_API
+int australia_aqi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t no2_1h,
+                        aqi_fixed_t o3_1h,    aqi_fixed_t o3_4h,
+                        aqi_fixed_t so2_1h,   aqi_fixed_t pm10_24h,
+                        aqi_fixed_t pm2_5_24h)
+{
+  int aqi = 0;
+  aqi = max(aqi, compute_nepm_aqi_fixed(103104000, co_8h));
+  aqi = max(aqi, compute_nepm_aqi_fixed(  2257920, no2_1h));
+  aqi = max(aqi, compute_nepm_aqi_fixed(  1963200, o3_1h));
+  aqi = max(aqi, compute_nepm_aqi_fixed(  1570560, o3_4h));
+  aqi = max(aqi, compute_nepm_aqi_fixed( 16948800, so2_1h));
+  aqi = max(aqi, compute_nepm_aqi_fixed(   500000, pm10_24h));
+  aqi = max(aqi, compute_nepm_aqi_fixed(   250000, pm2_5_24h));
+  return aqi;
+} // end australia_aqi_fixed
+
+/* Canada (AQHI)
+ *
+ * Coefficients as k / (100 * ln(2)) in Q48, see canada_aqhi().
+ */
+AQI_API
+int canada_aqhi_fixed(aqi_fixed_t no2_3h, aqi_fixed_t o3_3h,
+                      aqi_fixed_t pm2_5_3h)
+{
+  int64_t sum = (fixed_exp(1110769790, o3_3h)    - AQI_FIXED_EXP_ONE)  // 0.000273533
+              + (fixed_exp(1879772381, no2_3h)   - AQI_FIXED_EXP_ONE)  // 0.000462904
+              + (fixed_exp(1977622033, pm2_5_3h) - AQI_FIXED_EXP_ONE); // 0.000487
+  // 1000 / 10.4 = 1250 / 13
+  return max(1, (int) fixed_div_round(sum * 1250, 13 * AQI_FIXED_EXP_ONE));
+} // end canada_aqhi_fixed
+
+/* China (AQI)
+ */
+static const breakpoint_fixed_t CHINA_AQI_CO_1H_FIXED = {
+  7, 501,
+  /* c_lt */ {   500001,   1000001,   3500001,   6000001,   9000001,   12000001,   15000001 },
+  /* i_lo */ {        0,        51,       101,       151,       201,        301,        401 },
+  /* i_hi */ {       50,       100,       150,       200,       300,        400,        500 },
+  /* c_lo */ {        0,  50000000, 100000000, 350000000, 600000000,  900000000, 1200000000 },
+  /* c_hi */ { 50000000, 100000000, 350000000, 600000000, 900000000, 1200000000, 1500000000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_CO_24H_FIXED = {
+  7, 501,
+  /* c_lt */ {   200001,   400001,   1400001,   2400001,   3600001,   4800001,   6000001 },
+  /* i_lo */ {        0,       51,       101,       151,       201,       301,       401 },
+  /* i_hi */ {       50,      100,       150,       200,       300,       400,       500 },
+  /* c_lo */ {        0, 20000000,  40000000, 140000000, 240000000, 360000000, 480000000 },
+  /* c_hi */ { 20000000, 40000000, 140000000, 240000000, 360000000, 480000000, 600000000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_NO2_1H_FIXED = {
+  7, 501,
+  /* c_lt */ {   10001,   20001,   70001,   120001,   234001,   309001,   384001 },
+  /* i_lo */ {       0,      51,     101,      151,      201,      301,      401 },
+  /* i_hi */ {      50,     100,     150,      200,      300,      400,      500 },
+  /* c_lo */ {       0, 1000000, 2000000,  7000000, 12000000, 23400000, 30900000 },
+  /* c_hi */ { 1000000, 2000000, 7000000, 12000000, 23400000, 30900000, 38400000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_NO2_24H_FIXED = {
+  7, 501,
+  /* c_lt */ {   4001,   8001,   18001,   28001,   56501,   75001,   94001 },
+  /* i_lo */ {      0,     51,     101,     151,     201,     301,     401 },
+  /* i_hi */ {     50,    100,     150,     200,     300,     400,     500 },
+  /* c_lo */ {      0, 400000,  800000, 1800000, 2800000, 5650000, 7500000 },
+  /* c_hi */ { 400000, 800000, 1800000, 2800000, 5650000, 7500000, 9400000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_O3_1H_FIXED = {
+  7, 501,
+  /* c_lt */ {   16001,   20001,   30001,   40001,   80001,   100001,   120001 },
+  /* i_lo */ {       0,      51,     101,     151,     201,      301,      401 },
+  /* i_hi */ {      50,     100,     150,     200,     300,      400,      500 },
+  /* c_lo */ {       0, 1600000, 2000000, 3000000, 4000000,  8000000, 10000000 },
+  /* c_hi */ { 1600000, 2000000, 3000000, 4000000, 8000000, 10000000, 12000000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_O3_8H_FIXED = {
+  5, 501,
+  /* c_lt */ {   10001,   16001,   21501,   26501,   80001 },
+  /* i_lo */ {       0,      51,     101,     151,     201 },
+  /* i_hi */ {      50,     100,     150,     200,     300 },
+  /* c_lo */ {       0, 1000000, 1600000, 2150000, 2650000 },
+  /* c_hi */ { 1000000, 1600000, 2150000, 2650000, 8000000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_SO2_1H_FIXED = {
+  4, 501,
+  /* c_lt */ {   15001,   50001,   65001,   80001 },
+  /* i_lo */ {       0,      51,     101,     151 },
+  /* i_hi */ {      50,     100,     150,     200 },
+  /* c_lo */ {       0, 1500000, 5000000, 6500000 },
+  /* c_hi */ { 1500000, 5000000, 6500000, 8000000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_SO2_24H_FIXED = {
+  7, 501,
+  /* c_lt */ {   5001,   15001,   47501,   80001,   160001,   210001,   262001 },
+  /* i_lo */ {      0,      51,     101,     151,      201,      301,      401 },
+  /* i_hi */ {     50,     100,     150,     200,      300,      400,      500 },
+  /* c_lo */ {      0,  500000, 1500000, 4750000,  8000000, 16000000, 21000000 },
+  /* c_hi */ { 500000, 1500000, 4750000, 8000000, 16000000, 21000000, 26200000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_PM10_24H_FIXED = {
+  7, 501,
+  /* c_lt */ {   5001,   15001,   25001,   35001,   42001,   50001,   60001 },
+  /* i_lo */ {      0,      51,     101,     151,     201,     301,     401 },
+  /* i_hi */ {     50,     100,     150,     200,     300,     400,     500 },
+  /* c_lo */ {      0,  500000, 1500000, 2500000, 3500000, 4200000, 5000000 },
+  /* c_hi */ { 500000, 1500000, 2500000, 3500000, 4200000, 5000000, 6000000 },
+};
+
+static const breakpoint_fixed_t CHINA_AQI_PM2_5_24H_FIXED = {
+  7, 501,
+  /* c_lt */ {   3501,   7501,   11501,   15001,   25001,   35001,   50001 },
+  /* i_lo */ {      0,     51,     101,     151,     201,     301,     401 },
+  /* i_hi */ {     50,    100,     150,     200,     300,     400,     500 },
+  /* c_lo */ {      0, 350000,  750000, 1150000, 1500000, 2500000, 3500000 },
+  /* c_hi */ { 350000, 750000, 1150000, 1500000, 2500000, 3500000, 5000000 },
+};
+AQI_API
+int china_aqi_fixed(aqi_fixed_t co_1h,    aqi_fixed_t co_24h,
+                    aqi_fixed_t no2_1h,   aqi_fixed_t no2_24h,
+                    aqi_fixed_t o3_1h,    aqi_fixed_t o3_8h,
+                    aqi_fixed_t so2_1h,   aqi_fixed_t so2_24h,
+                    aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h)
+{
+  int aqi = 0;
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_CO_1H_FIXED, co_1h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_CO_24H_FIXED, co_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_NO2_1H_FIXED, no2_1h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_NO2_24H_FIXED, no2_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_O3_1H_FIXED, o3_1h));
+  if (o3_8h <= 80000)
   {
-    return SOUTH_KOREA_CAI_TXT[1];
+    aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_O3_8H_FIXED, o3_8h));
   }
-  else if (cai <= 250)
+  if (so2_1h <= 80000)
   {
-    return SOUTH_KOREA_CAI_TXT[2];
+    aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_SO2_1H_FIXED, so2_1h));
   }
-  else
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_SO2_24H_FIXED, so2_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_PM10_24H_FIXED, pm10_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&CHINA_AQI_PM2_5_24H_FIXED, pm2_5_24h));
+  return aqi;
+} // end china_aqi_fixed
+
+/* European Union (CAQI)
+ */
+static const breakpoint_fixed_t EUROPEAN_UNION_CAQI_NO2_1H_FIXED = {
+  4, 101,
+  /* c_lt */ {   5001,   10001,   20001,   40001 },
+  /* i_lo */ {      0,      26,      51,      76 },
+  /* i_hi */ {     25,      50,      75,     100 },
+  /* c_lo */ {      0,  500000, 1000000, 2000000 },
+  /* c_hi */ { 500000, 1000000, 2000000, 4000000 },
+};
+
+static const breakpoint_fixed_t EUROPEAN_UNION_CAQI_O3_1H_FIXED = {
+  4, 101,
+  /* c_lt */ {   6001,   12001,   18001,   24001 },
+  /* i_lo */ {      0,      25,      51,      76 },
+  /* i_hi */ {     25,      50,      75,     100 },
+  /* c_lo */ {      0,  600000, 1200000, 1800000 },
+  /* c_hi */ { 600000, 1200000, 1800000, 2400000 },
+};
+
+static const breakpoint_fixed_t EUROPEAN_UNION_CAQI_PM10_1H_FIXED = {
+  4, 101,
+  /* c_lt */ {   2501,   5001,   9001,   18001 },
+  /* i_lo */ {      0,     26,     51,      76 },
+  /* i_hi */ {     25,     50,     75,     100 },
+  /* c_lo */ {      0, 250000, 500000,  900000 },
+  /* c_hi */ { 250000, 500000, 900000, 1800000 },
+};
+
+static const breakpoint_fixed_t EUROPEAN_UNION_CAQI_PM2_5_1H_FIXED = {
+  4, 101,
+  /* c_lt */ {   1501,   3001,   5501,   11001 },
+  /* i_lo */ {      0,     26,     51,      76 },
+  /* i_hi */ {     25,     50,     75,     100 },
+  /* c_lo */ {      0, 150000, 300000,  550000 },
+  /* c_hi */ { 150000, 300000, 550000, 1100000 },
+};
+AQI_API
+int european_union_caqi_fixed(aqi_fixed_t no2_1h,  aqi_fixed_t o3_1h,
+                              aqi_fixed_t pm10_1h, aqi_fixed_t pm2_5_1h)
+{
+  int caqi = 0;
+  caqi = max(caqi, breakpoint_aqi_fixed(&EUROPEAN_UNION_CAQI_NO2_1H_FIXED,
+                                        no2_1h));
+  caqi = max(caqi, breakpoint_aqi_fixed(&EUROPEAN_UNION_CAQI_O3_1H_FIXED,
+                                        o3_1h));
+  caqi = max(caqi, breakpoint_aqi_fixed(&EUROPEAN_UNION_CAQI_PM10_1H_FIXED,
+                                        pm10_1h));
+  caqi = max(caqi, breakpoint_aqi_fixed(&EUROPEAN_UNION_CAQI_PM2_5_1H_FIXED,
+                                        pm2_5_1h));
+  return caqi;
+} // end european_union_caqi_fixed
+
+/* Hong Kong (AQHI)
+ *
+ * Upper bounds of AQHI 1 to 10 as floor(AR * 2^30), see hong_kong_aqhi().
+ */
+static const int64_t HONG_KONG_AQHI_FIXED_AR[10] = {
+   2018634629,  4037269258,  6055903887,  8074538516, 10103910563,
+  12122545192, 13862006947, 16181289287, 18489834209, 20798379130,
+};
+
+AQI_API
+int hong_kong_aqhi_fixed(aqi_fixed_t no2_3h,  aqi_fixed_t o3_3h,
+                         aqi_fixed_t so2_3h,  aqi_fixed_t pm10_3h,
+                         aqi_fixed_t pm2_5_3h)
+{
+  // coefficients as k / (100 * ln(2)) in Q48
+  int64_t pm10  = fixed_exp(1145863850, pm10_3h);  // 0.0002821751
+  int64_t pm2_5 = fixed_exp( 885490214, pm2_5_3h); // 0.0002180567
+  int64_t ar = 100 * ((fixed_exp(1812167352, no2_3h) - AQI_FIXED_EXP_ONE)  // 0.0004462559
+                    + (fixed_exp( 565768426, so2_3h) - AQI_FIXED_EXP_ONE)  // 0.0001393235
+                    + (fixed_exp(2077651536, o3_3h)  - AQI_FIXED_EXP_ONE)  // 0.0005116328
+                    + ((pm10 >= pm2_5 ? pm10 : pm2_5) - AQI_FIXED_EXP_ONE));
+
+  int aqhi = 1;
+  for (int b = 0; b < 10; ++b)
   {
-    return SOUTH_KOREA_CAI_TXT[3];
+    aqhi += (ar > HONG_KONG_AQHI_FIXED_AR[b]);
   }
-} // end south_korea_cai_desc
+  return aqhi;
+} // end hong_kong_aqhi_fixed
 
-/*
- * Indicates Air Pollution
+/* India (AQI)
  */
-const char *united_kingdom_daqi_desc(int daqi)
+static const breakpoint_fixed_t INDIA_AQI_CO_8H_FIXED = {
+  5, 401,
+  /* c_lt */ {   105000,   205000,   1005000,   1705000,   3405000 },
+  /* i_lo */ {        0,       51,       101,       201,       301 },
+  /* i_hi */ {       50,      100,       200,       300,       400 },
+  /* c_lo */ {        0, 11000000,  21000000, 101000000, 171000000 },
+  /* c_hi */ { 10000000, 20000000, 100000000, 170000000, 340000000 },
+};
+
+static const breakpoint_fixed_t INDIA_AQI_NH3_24H_FIXED = {
+  5, 401,
+  /* c_lt */ {   20050,   40050,   80050,   120050,   180050 },
+  /* i_lo */ {       0,      51,     101,      201,      301 },
+  /* i_hi */ {      50,     100,     200,      300,      400 },
+  /* c_lo */ {       0, 2010000, 4010000,  8010000, 12010000 },
+  /* c_hi */ { 2000000, 4000000, 8000000, 12000000, 18000000 },
+};
+
+static const breakpoint_fixed_t INDIA_AQI_NO2_24H_FIXED = {
+  5, 401,
+  /* c_lt */ {   4050,   8050,   18050,   28050,   40050 },
+  /* i_lo */ {      0,     51,     101,     201,     301 },
+  /* i_hi */ {     50,    100,     200,     300,     400 },
+  /* c_lo */ {      0, 410000,  810000, 1810000, 2810000 },
+  /* c_hi */ { 400000, 800000, 1800000, 2800000, 4000000 },
+};
+
+static const breakpoint_fixed_t INDIA_AQI_O3_8H_FIXED = {
+  5, 401,
+  /* c_lt */ {   5050,   10050,   16850,   20850,   74850 },
+  /* i_lo */ {      0,      51,     101,     201,     301 },
+  /* i_hi */ {     50,     100,     200,     300,     400 },
+  /* c_lo */ {      0,  510000, 1010000, 1690000, 2090000 },
+  /* c_hi */ { 500000, 1000000, 1680000, 2080000, 7480000 },
+};
+
+static const breakpoint_fixed_t INDIA_AQI_PB_24H_FIXED = {
+  5, 401,
+  /* c_lt */ {   55,   106,   206,   306,   356 },
+  /* i_lo */ {    0,    51,   101,   201,   301 },
+  /* i_hi */ {   50,   100,   200,   300,   400 },
+  /* c_lo */ {    0,  6000, 11000, 21000, 31000 },
+  /* c_hi */ { 5000, 10000, 20000, 30000, 35000 },
+};
+
+static const breakpoint_fixed_t INDIA_AQI_SO2_24H_FIXED = {
+  5, 401,
+  /* c_lt */ {   4050,   8050,   38050,   80050,   160050 },
+  /* i_lo */ {      0,     51,     101,     201,      301 },
+  /* i_hi */ {     50,    100,     200,     300,      400 },
+  /* c_lo */ {      0, 410000,  810000, 3810000,  8010000 },
+  /* c_hi */ { 400000, 800000, 3800000, 8000000, 16000000 },
+};
+
+static const breakpoint_fixed_t INDIA_AQI_PM10_24H_FIXED = {
+  5, 401,
+  /* c_lt */ {   5050,   10050,   25050,   35050,   43050 },
+  /* i_lo */ {      0,      51,     101,     201,     301 },
+  /* i_hi */ {     50,     100,     200,     300,     400 },
+  /* c_lo */ {      0,  510000, 1010000, 2510000, 3510000 },
+  /* c_hi */ { 500000, 1000000, 2500000, 3500000, 4300000 },
+};
+
+static const breakpoint_fixed_t INDIA_AQI_PM2_5_24H_FIXED = {
+  5, 401,
+  /* c_lt */ {   3050,   6050,   9050,   12050,   25050 },
+  /* i_lo */ {      0,     51,    101,     201,     301 },
+  /* i_hi */ {     50,    100,    200,     300,     400 },
+  /* c_lo */ {      0, 310000, 610000,  910000, 1210000 },
+  /* c_hi */ { 300000, 600000, 900000, 1200000, 2500000 },
+};
+AQI_API
+int india_aqi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t nh3_24h,
+                    aqi_fixed_t no2_24h,  aqi_fixed_t o3_8h,
+                    aqi_fixed_t pb_24h,   aqi_fixed_t so2_24h,
+                    aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h)
+{
+  int aqi = 0;
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_CO_8H_FIXED, co_8h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_NH3_24H_FIXED, nh3_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_NO2_24H_FIXED, no2_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_O3_8H_FIXED, o3_8h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_PB_24H_FIXED, pb_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_SO2_24H_FIXED, so2_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_PM10_24H_FIXED, pm10_24h));
+  aqi = max(aqi, breakpoint_aqi_fixed(&INDIA_AQI_PM2_5_24H_FIXED, pm2_5_24h));
+  return aqi;
+} // end india_aqi_fixed
+
+/* Singapore (PSI)
+ */
+static const breakpoint_fixed_t SINGAPORE_PSI_CO_8H_FIXED = {
+  6, 501,
+  /* c_lt */ {   505000,   1005000,   1705000,   3405000,   4605000,   5755000 },
+  /* i_lo */ {        0,        51,       101,       201,       301,       401 },
+  /* i_hi */ {       50,       100,       200,       300,       400,       500 },
+  /* c_lo */ {        0,  51000000, 101000000, 171000000, 341000000, 461000000 },
+  /* c_hi */ { 50000000, 100000000, 170000000, 340000000, 460000000, 575000000 },
+};
+
+static const breakpoint_fixed_t SINGAPORE_PSI_NO2_1H_FIXED = {
+  3, 501,
+  /* c_lt */ {   226050,   300050,   375050 },
+  /* i_lo */ {      201,      301,      401 },
+  /* i_hi */ {      300,      400,      500 },
+  /* c_lo */ { 11310000, 22610000, 30010000 },
+  /* c_hi */ { 22600000, 30000000, 37500000 },
+};
+
+static const breakpoint_fixed_t SINGAPORE_PSI_O3_FIXED = {
+  6, 501,
+  /* c_lt */ {   11850,   15750,   23550,   78550,   98050,   118050 },
+  /* i_lo */ {       0,      51,     101,     201,     301,      401 },
+  /* i_hi */ {      50,     100,     200,     300,     400,      500 },
+  /* c_lo */ {       0, 1190000, 1580000, 2360000, 7860000,  9810000 },
+  /* c_hi */ { 1180000, 1570000, 2350000, 7850000, 9800000, 11800000 },
+};
+
+static const breakpoint_fixed_t SINGAPORE_PSI_SO2_24H_FIXED = {
+  6, 501,
+  /* c_lt */ {   8050,   36550,   80050,   160050,   210050,   262050 },
+  /* i_lo */ {      0,      51,     101,      201,      301,      401 },
+  /* i_hi */ {     50,     100,     200,      300,      400,      500 },
+  /* c_lo */ {      0,  810000, 3660000,  8010000, 16010000, 21010000 },
+  /* c_hi */ { 800000, 3650000, 8000000, 16000000, 21000000, 26200000 },
+};
+
+static const breakpoint_fixed_t SINGAPORE_PSI_PM10_24H_FIXED = {
+  6, 501,
+  /* c_lt */ {   5050,   15050,   35050,   42050,   50050,   60050 },
+  /* i_lo */ {      0,      51,     101,     201,     301,     401 },
+  /* i_hi */ {     50,     100,     200,     300,     400,     500 },
+  /* c_lo */ {      0,  510000, 1510000, 3510000, 4210000, 5010000 },
+  /* c_hi */ { 500000, 1500000, 3500000, 4200000, 5000000, 6000000 },
+};
+
+static const breakpoint_fixed_t SINGAPORE_PSI_PM2_5_24H_FIXED = {
+  6, 501,
+  /* c_lt */ {   1250,   5550,   15050,   25050,   35050,   50050 },
+  /* i_lo */ {      0,     51,     101,     201,     301,     401 },
+  /* i_hi */ {     50,    100,     200,     300,     400,     500 },
+  /* c_lo */ {      0, 130000,  560000, 1510000, 2510000, 3510000 },
+  /* c_hi */ { 120000, 550000, 1500000, 2500000, 3500000, 5000000 },
+};
+AQI_API
+int singapore_psi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t no2_1h,
+                        aqi_fixed_t o3_1h,    aqi_fixed_t o3_8h,
+                        aqi_fixed_t so2_24h,  aqi_fixed_t pm10_24h,
+                        aqi_fixed_t pm2_5_24h)
 {
-  if (daqi <= 3)
+  int psi = 0;
+  psi = max(psi, breakpoint_aqi_fixed(&SINGAPORE_PSI_CO_8H_FIXED, co_8h));
+
+  // no2 only calculated if >= 1130 μg/m^3
+  if (no2_1h >= 112950 && no2_1h < 113050)
   {
-    return UNITED_KINGDOM_DAQI_TXT[0];
+    psi = max(psi, 200);
   }
-  else if (daqi <= 6)
+  else if (no2_1h >= 112950)
   {
-    return UNITED_KINGDOM_DAQI_TXT[1];
+    psi = max(psi, breakpoint_aqi_fixed(&SINGAPORE_PSI_NO2_1H_FIXED, no2_1h));
   }
-  else if (daqi <= 9)
+
+  // o3 uses the 1 hour concentration when the 8 hour one is > 785 μg/m^3
+  if (o3_8h <= 78500)
   {
-    return UNITED_KINGDOM_DAQI_TXT[2];
+    psi = max(psi, breakpoint_aqi_fixed(&SINGAPORE_PSI_O3_FIXED, o3_8h));
   }
   else
   {
-    return UNITED_KINGDOM_DAQI_TXT[3];
+    psi = max(psi, breakpoint_aqi_fixed(&SINGAPORE_PSI_O3_FIXED, o3_1h));
   }
-} // end united_kingdom_daqi_desc
 
-/*
- * Indicates Health Risk
+  psi = max(psi, breakpoint_aqi_fixed(&SINGAPORE_PSI_SO2_24H_FIXED, so2_24h));
+  psi = max(psi, breakpoint_aqi_fixed(&SINGAPORE_PSI_PM10_24H_FIXED,
+                                      pm10_24h));
+  psi = max(psi, breakpoint_aqi_fixed(&SINGAPORE_PSI_PM2_5_24H_FIXED,
+                                      pm2_5_24h));
+  return psi;
+} // end singapore_psi_fixed
+
+/* South Korea (CAI)
  */
-const char *united_states_aqi_desc(int aqi)
+static const breakpoint_fixed_t SOUTH_KOREA_CAI_CO_1H_FIXED = {
+  4, 501,
+  /* c_lt */ {   234849,   1036769,   1724129,   5733728 },
+  /* i_lo */ {        0,        51,       101,       251 },
+  /* i_hi */ {       50,       100,       250,       500 },
+  /* c_lo */ {        0,  24057600, 104249600, 172985600 },
+  /* c_hi */ { 22912000, 103104000, 171840000, 572800000 },
+};
+
+static const breakpoint_fixed_t SOUTH_KOREA_CAI_NO2_1H_FIXED = {
+  4, 501,
+  /* c_lt */ {   5739,   11384,   37727,   377261 },
+  /* i_lo */ {      0,      51,     101,      251 },
+  /* i_hi */ {     50,     100,     250,      500 },
+  /* c_lo */ {      0,  583296, 1147776,  3782016 },
+  /* c_hi */ { 564480, 1128960, 3763200, 37632000 },
+};
+
+static const breakpoint_fixed_t SOUTH_KOREA_CAI_O3_1H_FIXED = {
+  4, 501,
+  /* c_lt */ {   5988,   17767,   29547,   117891 },
+  /* i_lo */ {      0,      51,     101,      251 },
+  /* i_hi */ {     50,     100,     250,      500 },
+  /* c_lo */ {      0,  608592, 1786512,  2964432 },
+  /* c_hi */ { 588960, 1766880, 2944800, 11779200 },
+};
+
+static const breakpoint_fixed_t SOUTH_KOREA_CAI_SO2_1H_FIXED = {
+  4, 501,
+  /* c_lt */ {   17373,   42796,   127116,   847864 },
+  /* i_lo */ {       0,      51,      101,      251 },
+  /* i_hi */ {      50,     100,      250,      500 },
+  /* c_lo */ {       0, 1779624,  4321944, 12796344 },
+  /* c_hi */ { 1694880, 4237200, 12711600, 84744000 },
+};
+
+static const breakpoint_fixed_t SOUTH_KOREA_CAI_PM10_24H_FIXED = {
+  4, 501,
+  /* c_lt */ {   3050,   8050,   15050,   60050 },
+  /* i_lo */ {      0,     51,     101,     251 },
+  /* i_hi */ {     50,    100,     250,     500 },
+  /* c_lo */ {      0, 310000,  810000, 1510000 },
+  /* c_hi */ { 300000, 800000, 1500000, 6000000 },
+};
+
+static const breakpoint_fixed_t SOUTH_KOREA_CAI_PM2_5_24H_FIXED = {
+  4, 501,
+  /* c_lt */ {   1550,   3550,   7550,   50050 },
+  /* i_lo */ {      0,     51,    101,     251 },
+  /* i_hi */ {     50,    100,    250,     500 },
+  /* c_lo */ {      0, 160000, 360000,  760000 },
+  /* c_hi */ { 150000, 350000, 750000, 5000000 },
+};
+AQI_API
+int south_korea_cai_fixed(aqi_fixed_t co_1h,    aqi_fixed_t no2_1h,
+                          aqi_fixed_t o3_1h,    aqi_fixed_t so2_1h,
+                          aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h)
 {
-  if (aqi <= 50)
-  {
-    return UNITED_STATES_AQI_TXT[0];
-  }
-  else if (aqi <= 100)
+  int cai = 0;
+  cai = max(cai, breakpoint_aqi_fixed(&SOUTH_KOREA_CAI_CO_1H_FIXED, co_1h));
+  cai = max(cai, breakpoint_aqi_fixed(&SOUTH_KOREA_CAI_NO2_1H_FIXED, no2_1h));
+  cai = max(cai, breakpoint_aqi_fixed(&SOUTH_KOREA_CAI_O3_1H_FIXED, o3_1h));
+  cai = max(cai, breakpoint_aqi_fixed(&SOUTH_KOREA_CAI_SO2_1H_FIXED, so2_1h));
+  cai = max(cai, breakpoint_aqi_fixed(&SOUTH_KOREA_CAI_PM10_24H_FIXED,
+                                      pm10_24h));
+  cai = max(cai, breakpoint_aqi_fixed(&SOUTH_KOREA_CAI_PM2_5_24H_FIXED,
+                                      pm2_5_24h));
+  return cai;
+} // end south_korea_cai_fixed
+
+/* United Kingdom (DAQI)
+ *
+ * Lowest concentration (hundredths of a μg/m^3) of DAQI 2 to 10, per
+ * pollutant. Same order as the parameters of united_kingdom_daqi_fixed().
+ */
+static const int32_t UNITED_KINGDOM_DAQI_FIXED[5][9] = {
+  /* no2_1h    */ { 6750, 13450, 20050, 26750, 33450, 40050, 46750, 53450,  60050 },
+  /* o3_8h     */ { 3350,  6650, 10050, 12050, 14050, 16050, 18750, 21350,  24050 },
+  /* so2_15min */ { 8850, 17750, 26650, 35450, 44350, 53250, 71050, 88750, 106450 },
+  /* pm10_24h  */ { 1650,  3350,  5050,  5850,  6650,  7550,  8350,  9150,  10050 },
+  /* pm2_5_24h */ { 1150,  2350,  3550,  4150,  4750,  5350,  5850,  6450,   7050 },
+};
+
+AQI_API
+int united_kingdom_daqi_fixed(aqi_fixed_t no2_1h,   aqi_fixed_t o3_8h,
+                              aqi_fixed_t so2_15min, aqi_fixed_t pm10_24h,
+                              aqi_fixed_t pm2_5_24h)
+{
+  const aqi_fixed_t c[5] = { no2_1h, o3_8h, so2_15min, pm10_24h, pm2_5_24h };
+  int daqi = 1;
+  for (int p = 0; p < 5; ++p)
   {
-    return UNITED_STATES_AQI_TXT[1];
+    int band = 1;
+    for (int b = 0; b < 9; ++b)
+    {
+      band += (c[p] >= UNITED_KINGDOM_DAQI_FIXED[p][b]);
+    }
+    daqi = max(daqi, band);
   }
-  else if (aqi <= 150)
+  return daqi;
+} // end united_kingdom_daqi_fixed
+
+/* United States (AQI)
+ *
+ * Pollutant averages are truncated with integer division into the units of
+ * the lookup tables of united_states_aqi(), so both versions give the same
+ * sub-index of every truncated value. The tables below cover the rest: o3 1
+ * hour averages past the end of its lookup table (0.001 ppm), and the so2 24
+ * hour average (hundredths, as given).
+ */
+static const breakpoint_fixed_t UNITED_STATES_AQI_O3_1H_FIXED = {
+  5, 501,
+  /* c_lt */ {   164,   205,   404,   1649001,   2049001 },
+  /* i_lo */ {   101,   151,   201,       301,       401 },
+  /* i_hi */ {   150,   200,   300,       400,       500 },
+  /* c_lo */ { 12500, 16500, 20500, 125000000, 165000000 },
+  /* c_hi */ { 16400, 20400, 40400, 164900000, 204900000 },
+};
+
+static const breakpoint_fixed_t UNITED_STATES_AQI_SO2_FIXED = {
+  7, 501,
+  /* c_lt */ {   3501,   7501,   18501,   30401,   60401,   80401,   100401 },
+  /* i_lo */ {      0,     51,     101,     151,     201,     301,      401 },
+  /* i_hi */ {     50,    100,     150,     200,     300,     400,      500 },
+  /* c_lo */ {      0, 360000,  760000, 1860000, 3050000, 6050000,  8050000 },
+  /* c_hi */ { 350000, 750000, 1850000, 3040000, 6040000, 8040000, 10040000 },
+};
+
+/* Returns entry k of a lookup table whose last entry covers everything above.
+ * Equivalent to united_states_aqi_lookup().
+ */
+static inline int united_states_aqi_lookup_fixed(const uint16_t *lut, int len,
+                                                 int32_t k)
+{
+  return lut[k <= 0 ? 0 : min(k, len - 1)];
+} // end united_states_aqi_lookup_fixed
+
+#define UNITED_STATES_AQI_LOOKUP_FIXED(lut, k) \
+  united_states_aqi_lookup_fixed((lut), sizeof(lut) / sizeof((lut)[0]), (k))
+
+AQI_API
+int united_states_aqi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t no2_1h,
+                            aqi_fixed_t o3_1h,    aqi_fixed_t o3_8h,
+                            aqi_fixed_t so2_1h,   aqi_fixed_t so2_24h,
+                            aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h)
+{
+  int aqi = 0;
+
+  // Pollutant averages are truncated
+  int32_t co    = (int32_t) fixed_div_floor(co_8h, 11456);                  // (0.1 ppm)
+  int32_t no2   = (int32_t)((int64_t) no2_1h * 100 / 18816);                // (ppb)
+  int32_t o3_1  = (int32_t) fixed_div_floor((int64_t) o3_1h * 100, 19632);  // (0.001 ppm)
+  int32_t o3_8  = (int32_t) fixed_div_floor((int64_t) o3_8h * 100, 19632);  // (0.001 ppm)
+  int32_t so2   = (int32_t)((int64_t) so2_1h * 100 / 84744);                // (ppb)
+  int32_t pm10  = pm10_24h / 100;                                           // (μg/m^3)
+  int32_t pm2_5 = (int32_t) fixed_div_floor(pm2_5_24h, 10);                 // (0.1 μg/m^3)
+
+  aqi = max(aqi, UNITED_STATES_AQI_LOOKUP_FIXED(UNITED_STATES_AQI_CO_8H_LUT,
+                                                co));
+  aqi = max(aqi, UNITED_STATES_AQI_LOOKUP_FIXED(UNITED_STATES_AQI_NO2_1H_LUT,
+                                                no2));
+  if (o3_1 < (int32_t)(sizeof(UNITED_STATES_AQI_O3_1H_LUT)
+                       / sizeof(UNITED_STATES_AQI_O3_1H_LUT[0])))
   {
-    return UNITED_STATES_AQI_TXT[2];
+    aqi = max(aqi, UNITED_STATES_AQI_LOOKUP_FIXED(UNITED_STATES_AQI_O3_1H_LUT,
+                                                  o3_1));
   }
-  else if (aqi <= 200)
+  else
   {
-    return UNITED_STATES_AQI_TXT[3];
+    aqi = max(aqi, breakpoint_aqi_fixed(&UNITED_STATES_AQI_O3_1H_FIXED, o3_1));
   }
-  else if (aqi <= 300)
+  aqi = max(aqi, UNITED_STATES_AQI_LOOKUP_FIXED(UNITED_STATES_AQI_O3_8H_LUT,
+                                                o3_8));
+
+  // The 24 hour average is only used above 185 ppb, and (as in
+  // united_states_aqi()) is not converted to ppb.
+  if (so2 <= 185)
   {
-    return UNITED_STATES_AQI_TXT[4];
+    aqi = max(aqi, UNITED_STATES_AQI_LOOKUP_FIXED(UNITED_STATES_AQI_SO2_1H_LUT,
+                                                  so2));
   }
   else
   {
-    return UNITED_STATES_AQI_TXT[5];
+    aqi = max(aqi, breakpoint_aqi_fixed(&UNITED_STATES_AQI_SO2_FIXED,
+                                        so2_24h));
   }
-} // end united_states_aqi_desc
 
-/* Returns the average pollutant concentration over a given number of previous
- * hours.
- *
- * 'pollutant' is an array of hourly concentrations. The last element in
- * pollutant is the most recent hourly concentration. 'hours' must be a positive
- * integer.
- *
- * Passing NULL will return 0.
+  aqi = max(aqi, UNITED_STATES_AQI_LOOKUP_FIXED(
+                   UNITED_STATES_AQI_PM10_24H_LUT, pm10));
+  aqi = max(aqi, UNITED_STATES_AQI_LOOKUP_FIXED(
+                   UNITED_STATES_AQI_PM2_5_24H_LUT, pm2_5));
+  return aqi;
+} // end united_states_aqi_fixed
+
+/* Fixed-point version of avg_conc(), rounded to the nearest hundredth.
  */
-float avg_conc(const float pollutant[24], int hours)
+static aqi_fixed_t avg_conc_fixed(const aqi_fixed_t pollutant[24], int hours)
 {
   if (pollutant == NULL)
   {
-    return 0.f;
+    return 0;
   }
 
-  float avg = 0;
-  // index (size - 1) is most recent hourly concentration
-  for (int h = (24 - 1) - (hours - 1) ; h < 24 ; ++h)
+  int64_t sum = 0;
+  for (int h = 24 - hours; h < 24; ++h)
   {
-    avg += pollutant[h];
+    sum += pollutant[h];
   }
+  return (aqi_fixed_t) fixed_div_round(sum, hours);
+} // end avg_conc_fixed
 
-  avg = avg / (float) hours;
-  return avg;
-}
-
-int calc_australia_aqi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+/* Evaluate a scale from the averages listed in its windows table.
+ */
+static int eval_australia_aqi_fixed(const aqi_fixed_t c[])
 {
-  float co_8h     = avg_conc(co,     8);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_4h     = avg_conc(o3,     4);
-  float so2_1h    = avg_conc(so2,    1);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return australia_aqi(co_8h, no2_1h, o3_1h, o3_4h, so2_1h, pm10_24h,
-                       pm2_5_24h);
-} // end calc_australia_aqi
+  return australia_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+} // end eval_australia_aqi_fixed
 
-int calc_canada_aqhi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_canada_aqhi_fixed(const aqi_fixed_t c[])
 {
-  float no2_3h    = avg_conc(no2,    3);
-  float o3_3h     = avg_conc(o3,     3);
-  float pm2_5_3h  = avg_conc(pm2_5,  3);
-  return canada_aqhi(no2_3h, o3_3h, pm2_5_3h);
-} // end calc_canada_aqhi
+  return canada_aqhi_fixed(c[0], c[1], c[2]);
+} // end eval_canada_aqhi_fixed
 
-int calc_china_aqi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_china_aqi_fixed(const aqi_fixed_t c[])
 {
-  float co_1h     = avg_conc(co,     1);
-  float co_24h    = avg_conc(co,    24);
-  float no2_1h    = avg_conc(no2,    1);
-  float no2_24h   = avg_conc(no2,   24);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_1h    = avg_conc(so2,    1);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return china_aqi(co_1h, co_24h, no2_1h, no2_24h, o3_1h, o3_8h, so2_1h,
-                   so2_24h, pm10_24h, pm2_5_24h);
-} // end calc_china_aqi
+  return china_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8],
+                         c[9]);
+} // end eval_china_aqi_fixed
 
-int calc_european_union_caqi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_european_union_caqi_fixed(const aqi_fixed_t c[])
 {
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float pm10_1h   = avg_conc(pm10,   1);
-  float pm2_5_1h  = avg_conc(pm2_5,  1);
-  return european_union_caqi(no2_1h, o3_1h, pm10_1h, pm2_5_1h);
-} // end calc_european_union_caqi
+  return european_union_caqi_fixed(c[0], c[1], c[2], c[3]);
+} // end eval_european_union_caqi_fixed
 
-int calc_hong_kong_aqhi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_hong_kong_aqhi_fixed(const aqi_fixed_t c[])
 {
-  float no2_3h    = avg_conc(no2,    3);
-  float o3_3h     = avg_conc(o3,     3);
-  float so2_3h    = avg_conc(so2,    3);
-  float pm10_3h   = avg_conc(pm10,   3);
-  float pm2_5_3h  = avg_conc(pm2_5,  3);
-  return hong_kong_aqhi(no2_3h,  o3_3h, so2_3h, pm10_3h, pm2_5_3h);
-} // end calc_hong_kong_aqhi
+  return hong_kong_aqhi_fixed(c[0], c[1], c[2], c[3], c[4]);
+} // end eval_hong_kong_aqhi_fixed
 
-int calc_india_aqi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_india_aqi_fixed(const aqi_fixed_t c[])
 {
-  float co_8h     = avg_conc(co,     8);
-  float nh3_24h   = avg_conc(nh3,   24);
-  float no2_24h   = avg_conc(no2,   24);
-  float o3_8h     = avg_conc(o3,     8);
-  float pb_24h    = avg_conc(pb,    24);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return india_aqi(co_8h, nh3_24h, no2_24h, o3_8h, pb_24h, so2_24h, pm10_24h,
-                   pm2_5_24h);
-} // end calc_india_aqi
+  return india_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]);
+} // end eval_india_aqi_fixed
 
-int calc_singapore_psi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_singapore_psi_fixed(const aqi_fixed_t c[])
 {
-  float co_8h     = avg_conc(co,     8);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return singapore_psi(co_8h, no2_1h, o3_1h, o3_8h, so2_24h, pm10_24h,
-                       pm2_5_24h);
-} // end calc_singapore_psi
+  return singapore_psi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+} // end eval_singapore_psi_fixed
 
-int calc_south_korea_cai(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_south_korea_cai_fixed(const aqi_fixed_t c[])
 {
-  float co_1h     = avg_conc(co,     1);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float so2_1h    = avg_conc(so2,    1);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return south_korea_cai(co_1h, no2_1h, o3_1h, so2_1h, pm10_24h, pm2_5_24h);
-} // end calc_south_korea_cai
+  return south_korea_cai_fixed(c[0], c[1], c[2], c[3], c[4], c[5]);
+} // end eval_south_korea_cai_fixed
 
-int calc_united_kingdom_daqi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_united_kingdom_daqi_fixed(const aqi_fixed_t c[])
 {
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_15min = avg_conc(so2,    1); // USING LAST HOURLY CONCENTRATION!!!
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return united_kingdom_daqi(no2_1h, o3_8h, so2_15min, pm10_24h, pm2_5_24h);
-} // end calc_united_kingdom_daqi
+  return united_kingdom_daqi_fixed(c[0], c[1], c[2], c[3], c[4]);
+} // end eval_united_kingdom_daqi_fixed
 
-int calc_united_states_aqi(
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+static int eval_united_states_aqi_fixed(const aqi_fixed_t c[])
 {
-  float co_8h     = avg_conc(co,     8);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_1h    = avg_conc(so2,    1);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return united_states_aqi(co_8h, no2_1h, o3_1h, o3_8h, so2_1h, so2_24h,
-                           pm10_24h, pm2_5_24h);
-} // end calc_united_states_aqi
+  return united_states_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+                                 c[7]);
+} // end eval_united_states_aqi_fixed
 
-/* Fast lookup for calc_aqi functions. Organized alphabetically
+/* Fast lookup for fixed-point eval functions. Organized alphabetically
  * (same order as aqi_scale_t enums).
  */
-static int (*CALC_AQI_LOOKUP_TABLE[NUM_AQI_SCALES])(
-                          const float[24], const float[24], const float[24],
-                          const float[24], const float[24], const float[24],
-                          const float[24], const float[24], const float[24]) = {
-  calc_australia_aqi,
-  calc_canada_aqhi,
-  calc_china_aqi,
-  calc_european_union_caqi,
-  calc_hong_kong_aqhi,
-  calc_india_aqi,
-  calc_singapore_psi,
-  calc_south_korea_cai,
-  calc_united_kingdom_daqi,
-  calc_united_states_aqi,
+static int (*EVAL_AQI_FIXED_LOOKUP_TABLE[NUM_AQI_SCALES])(
+              const aqi_fixed_t[]) = {
+  eval_australia_aqi_fixed,
+  eval_canada_aqhi_fixed,
+  eval_china_aqi_fixed,
+  eval_european_union_caqi_fixed,
+  eval_hong_kong_aqhi_fixed,
+  eval_india_aqi_fixed,
+  eval_singapore_psi_fixed,
+  eval_south_korea_cai_fixed,
+  eval_united_kingdom_daqi_fixed,
+  eval_united_states_aqi_fixed,
 };
 
-int calc_aqi(aqi_scale_t scale,
-             const float co[24],  const float nh3[24],  const float no[24],
-             const float no2[24], const float o3[24],   const float pb[24],
-             const float so2[24], const float pm10[24], const float pm2_5[24])
+AQI_API
+int calc_aqi_fixed(aqi_scale_t scale,
+             const aqi_fixed_t co[24],  const aqi_fixed_t nh3[24],
+             const aqi_fixed_t no[24],  const aqi_fixed_t no2[24],
+             const aqi_fixed_t o3[24],  const aqi_fixed_t pb[24],
+             const aqi_fixed_t so2[24], const aqi_fixed_t pm10[24],
+             const aqi_fixed_t pm2_5[24])
 {
-  return CALC_AQI_LOOKUP_TABLE[scale](co, nh3, no, no2, o3, pb, so2, pm10,
-                                      pm2_5);
-} // end calc_aqi
+  const aqi_fixed_t *pollutant[NUM_AQI_POLLUTANTS] = {
+    co, nh3, no, no2, o3, pb, so2, pm10, pm2_5
+  };
+  const aqi_windows_t *windows = &AQI_WINDOWS_LOOKUP_TABLE[scale];
+  aqi_fixed_t c[AQI_MAX_WINDOWS];
+  for (int w = 0; w < windows->count; ++w)
+  {
+    const aqi_window_t *window = &windows->window[w];
+    c[w] = avg_conc_fixed(pollutant[window->pollutant], window_hours(window));
+  }
+  return EVAL_AQI_FIXED_LOOKUP_TABLE[scale](c);
+} // end calc_aqi_fixed
+#endif // AQI_FIXED_POINT
 
 /* Fast lookup for AQI scale max values. Organized alphabetically
  * (same order as aqi_scale_t enums).
@@ -2873,6 +6432,7 @@ static const int AQI_MAX_LOOKUP_TABLE[NUM_AQI_SCALES] = {
   UNITED_STATES_AQI_MAX,
 };
 
+AQI_API
 int aqi_scale_max(aqi_scale_t scale) {
   return AQI_MAX_LOOKUP_TABLE[scale];
 } // end aqi_scale_max
@@ -2893,6 +6453,7 @@ static const char *(*AQI_DESC_LOOKUP_TABLE[NUM_AQI_SCALES])(int) = {
   united_states_aqi_desc,
 };
 
+AQI_API
 const char *aqi_desc(aqi_scale_t scale, int val)
 {
   return AQI_DESC_LOOKUP_TABLE[scale](val);
@@ -2914,6 +6475,7 @@ static const aqi_desc_type_t AQI_DESC_TYPE_LOOKUP_TABLE[NUM_AQI_SCALES] = {
   UNITED_STATES_AQI_DESC_TYPE,
 };
 
+AQI_API
 aqi_desc_type_t aqi_desc_type(aqi_scale_t scale)
 {
   return AQI_DESC_TYPE_LOOKUP_TABLE[scale];
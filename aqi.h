@@ -20,6 +20,27 @@
 #ifndef __AQI_H__
 #define __AQI_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+/* Define the AQI_HEADER_ONLY macro below (or pass -DAQI_HEADER_ONLY when
+ * compiling your sources) to compile the library into every translation unit
+ * that includes aqi.h instead of linking aqi.c. Every function then has
+ * internal linkage and is declared inline, so the compiler can inline the scale
+ * functions into their callers and fold a constant scale passed to
+ * calc_aqi_const(). aqi.c must be next to aqi.h, and the mode is for C sources
+ * only.
+ */
+// #define AQI_HEADER_ONLY
+
+#ifdef AQI_HEADER_ONLY
+#define AQI_API static inline
+#define AQI_DATA static
+#else
+#define AQI_API
+#define AQI_DATA
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -43,6 +64,19 @@ typedef enum {
   AIR_POLLUTION_DESC,
 } aqi_desc_type_t;
 
+typedef enum {
+  POLLUTANT_CO,
+  POLLUTANT_NH3,
+  POLLUTANT_NO,
+  POLLUTANT_NO2,
+  POLLUTANT_O3,
+  POLLUTANT_PB,
+  POLLUTANT_SO2,
+  POLLUTANT_PM10,
+  POLLUTANT_PM2_5,
+  NUM_AQI_POLLUTANTS
+} aqi_pollutant_t;
+
 
 /* Returns the Air Quality Index, rounded to the nearest integer
  *
@@ -71,38 +105,138 @@ typedef enum {
  * https://en.wikipedia.org/wiki/Air_quality_index
  * https://atmotube.com/blog/standards-for-air-quality-indices-in-different-countries-aqi
  */
+AQI_API
 int australia_aqi(float co_8h,  float no2_1h,   float o3_1h, float o3_4h,
                   float so2_1h, float pm10_24h, float pm2_5_24h);
 
+AQI_API
 int canada_aqhi(float no2_3h, float o3_3h, float pm2_5_3h);
 
+AQI_API
 int china_aqi(float co_1h,    float co_24h, float no2_1h, float no2_24h,
               float o3_1h,    float o3_8h,  float so2_1h, float so2_24h,
               float pm10_24h, float pm2_5_24h);
 
+AQI_API
 int european_union_caqi(float no2_1h, float o3_1h, float pm10_1h, float pm2_5_1h);
 
+AQI_API
 int hong_kong_aqhi(float no2_3h,  float o3_3h, float so2_3h,
                    float pm10_3h, float pm2_5_3h);
 
+AQI_API
 int india_aqi(float co_8h,  float nh3_24h, float no2_24h,  float o3_8h,
               float pb_24h, float so2_24h, float pm10_24h, float pm2_5_24h);
 
 
+AQI_API
 int singapore_psi(float co_8h,   float no2_1h,   float o3_1h, float o3_8h,
                   float so2_24h, float pm10_24h, float pm2_5_24h);
 
+AQI_API
 int south_korea_cai(float co_1h,  float no2_1h,   float o3_1h,
                     float so2_1h, float pm10_24h, float pm2_5_24h);
 
+AQI_API
 int united_kingdom_daqi(float no2_1h,   float o3_8h, float so2_15min,
                         float pm10_24h, float pm2_5_24h);
 
+AQI_API
 int united_states_aqi(float co_8h,    float no2_1h,
                       float o3_1h,    float o3_8h,
                       float so2_1h,   float so2_24h,
                       float pm10_24h, float pm2_5_24h);
 
+/* Returns the index between i_lo and i_hi that concentration c maps to on the
+ * line through (c_lo, i_lo) and (c_hi, i_hi), rounded to the nearest integer.
+ * This is the interpolation the breakpoint-based scales use within a band.
+ */
+AQI_API
+int compute_piecewise_aqi(float i_lo, float i_hi,
+                          float c_lo, float c_hi, float c);
+
+/* Per-pollutant sub-indices of a scale.
+ *
+ * 'aqi' is the index the scale function returns. sub[] holds the sub-index of
+ * each pollutant, indexed by aqi_pollutant_t, and is 0 for pollutants the scale
+ * does not use. When a pollutant is averaged over more than one period (e.g.
+ * o3_1h and o3_8h), its sub-index is the larger of the two.
+ *
+ * 'dominant' is the pollutant responsible for the index: the first one whose
+ * sub-index equals 'aqi', or NUM_AQI_POLLUTANTS when no pollutant raises the
+ * index above the lowest value of the scale (e.g. every concentration is 0).
+ *
+ * The AQHI scales (Canada and Hong Kong) add up the risk of every pollutant
+ * instead of taking the largest sub-index. For them sub[] holds the AQHI of
+ * each pollutant on its own and 'dominant' is the pollutant adding the largest
+ * risk.
+ */
+typedef struct {
+  int             aqi;
+  int             sub[NUM_AQI_POLLUTANTS];
+  aqi_pollutant_t dominant;
+} aqi_detail_t;
+
+/* Variants of the scale functions above that also write the sub-index of every
+ * pollutant to 'detail', from the same single evaluation. The returned index
+ * is identical to the one of the matching scale function.
+ */
+AQI_API
+int australia_aqi_detail(float co_8h,  float no2_1h,   float o3_1h,
+                         float o3_4h,  float so2_1h,   float pm10_24h,
+                         float pm2_5_24h, aqi_detail_t *detail);
+
+AQI_API
+int canada_aqhi_detail(float no2_3h, float o3_3h, float pm2_5_3h,
+                       aqi_detail_t *detail);
+
+AQI_API
+int china_aqi_detail(float co_1h, float co_24h, float no2_1h, float no2_24h,
+                     float o3_1h, float o3_8h,  float so2_1h, float so2_24h,
+                     float pm10_24h, float pm2_5_24h, aqi_detail_t *detail);
+
+AQI_API
+int european_union_caqi_detail(float no2_1h,  float o3_1h, float pm10_1h,
+                               float pm2_5_1h, aqi_detail_t *detail);
+
+AQI_API
+int hong_kong_aqhi_detail(float no2_3h,  float o3_3h, float so2_3h,
+                          float pm10_3h, float pm2_5_3h, aqi_detail_t *detail);
+
+AQI_API
+int india_aqi_detail(float co_8h,  float nh3_24h, float no2_24h,  float o3_8h,
+                     float pb_24h, float so2_24h, float pm10_24h,
+                     float pm2_5_24h, aqi_detail_t *detail);
+
+AQI_API
+int singapore_psi_detail(float co_8h,   float no2_1h,   float o3_1h,
+                         float o3_8h,   float so2_24h,  float pm10_24h,
+                         float pm2_5_24h, aqi_detail_t *detail);
+
+AQI_API
+int south_korea_cai_detail(float co_1h,  float no2_1h,   float o3_1h,
+                           float so2_1h, float pm10_24h, float pm2_5_24h,
+                           aqi_detail_t *detail);
+
+AQI_API
+int united_kingdom_daqi_detail(float no2_1h,   float o3_8h, float so2_15min,
+                               float pm10_24h, float pm2_5_24h,
+                               aqi_detail_t *detail);
+
+AQI_API
+int united_states_aqi_detail(float co_8h,    float no2_1h,
+                             float o3_1h,    float o3_8h,
+                             float so2_1h,   float so2_24h,
+                             float pm10_24h, float pm2_5_24h,
+                             aqi_detail_t *detail);
+
+/* Returns the average of the most recent 'hours' hourly samples of a
+ * pollutant, or 0 if it is not available (NULL). Samples are ordered as for the
+ * calc_* functions below.
+ */
+AQI_API
+float avg_conc(const float pollutant[24], int hours);
+
 /* Given an hourly pollutant concentration samples, will return the Air Quality
  * Index, rounded to the nearest integer. The array of pollutant concentration
  * samples should be organized from least recent (index 0) to most recent
@@ -115,44 +249,55 @@ int united_states_aqi(float co_8h,    float no2_1h,
  * Warning: The United Kingdom DAQI requires a 15min average concentration for
  *          so2. The UK's DAQI is the only scale that requires a 15min average
  *          concentration. (why!?) In this case the most recent hourly
- *          concentration will be used instead.
+ *          concentration will be used instead. Use aqi_minute_state_t when
+ *          per-minute samples are available.
  */
+AQI_API
 int calc_australia_aqi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_canada_aqhi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_china_aqi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_european_union_caqi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_hong_kong_aqhi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_india_aqi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_singapore_psi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_south_korea_cai(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_united_kingdom_daqi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
+AQI_API
 int calc_united_states_aqi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
@@ -161,11 +306,749 @@ int calc_united_states_aqi(
 /* Given a scale and hourly pollutant concentrations returns the Air Quality
  * Index.
  */
+AQI_API
 int calc_aqi(aqi_scale_t scale,
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24]);
 
+/* Same as calc_aqi(), for a scale known at compile time.
+ *
+ * The scale is dispatched with a switch rather than a table of function
+ * pointers, so a constant scale reduces to a direct call to its calc_*
+ * function, which AQI_HEADER_ONLY then allows to be inlined. Returns 0 for an
+ * unknown scale.
+ */
+static inline int calc_aqi_const(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  switch (scale)
+  {
+    case AUSTRALIA_AQI:
+      return calc_australia_aqi(co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+    case CANADA_AQHI:
+      return calc_canada_aqhi(co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+    case CHINA_AQI:
+      return calc_china_aqi(co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+    case EUROPEAN_UNION_CAQI:
+      return calc_european_union_caqi(co, nh3, no, no2, o3, pb, so2, pm10,
+                                      pm2_5);
+    case HONG_KONG_AQHI:
+      return calc_hong_kong_aqhi(co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+    case INDIA_AQI:
+      return calc_india_aqi(co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+    case SINGAPORE_PSI:
+      return calc_singapore_psi(co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+    case SOUTH_KOREA_CAI:
+      return calc_south_korea_cai(co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+    case UNITED_KINGDOM_DAQI:
+      return calc_united_kingdom_daqi(co, nh3, no, no2, o3, pb, so2, pm10,
+                                      pm2_5);
+    case UNITED_STATES_AQI:
+      return calc_united_states_aqi(co, nh3, no, no2, o3, pb, so2, pm10,
+                                    pm2_5);
+    default:
+      return 0;
+  }
+} // end calc_aqi_const
+
+/* Given hourly pollutant concentrations, writes the Air Quality Index of every
+ * scale to aqi[], indexed by aqi_scale_t.
+ *
+ * Each distinct average (e.g. the 24 hour average of pm2_5) is computed once
+ * and shared between the scales that need it. The results are identical to
+ * calling calc_aqi() once per scale.
+ */
+AQI_API
+void calc_aqi_all(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24],
+             int aqi[NUM_AQI_SCALES]);
+
+/* Read-only view of the hourly samples of one pollutant, so the calc_*_view
+ * functions can read straight from a ring buffer or an array of records
+ * without copying into a float[24].
+ *
+ * Slot k holds the sample at (const char *) base + k * stride, for k in
+ * [0, capacity). 'head' is the slot of the most recent sample; the slots before
+ * it (wrapping around at capacity) hold progressively older samples. capacity
+ * must be at least 24 and head less than capacity. stride is in bytes, so
+ * sizeof(float) for a plain array or sizeof(record) for an array of records.
+ *
+ * A float[24] organized as for calc_aqi() is AQI_VIEW_ARRAY(array).
+ */
+typedef struct {
+  const float *base;
+  size_t head;
+  size_t capacity;
+  size_t stride;
+} aqi_view_t;
+
+#define AQI_VIEW_ARRAY(array) \
+  ((aqi_view_t){ (array), 23, 24, sizeof(float) })
+
+/* Returns the average of the most recent 'hours' samples of a view, summed
+ * in the same order as calc_aqi() does. Passing NULL (or a view with a NULL
+ * base) will return 0.
+ */
+AQI_API
+float avg_conc_view(const aqi_view_t *view, int hours);
+
+/* Equivalents of calc_aqi() and calc_aqi_all() that read each pollutant from a
+ * view. Pass NULL to indicate that a concentration is not available.
+ *
+ * The results are identical to copying each view into a float[24] and calling
+ * calc_aqi() or calc_aqi_all().
+ */
+AQI_API
+int calc_aqi_view(aqi_scale_t scale,
+             const aqi_view_t *co,  const aqi_view_t *nh3,
+             const aqi_view_t *no,  const aqi_view_t *no2,
+             const aqi_view_t *o3,  const aqi_view_t *pb,
+             const aqi_view_t *so2, const aqi_view_t *pm10,
+             const aqi_view_t *pm2_5);
+
+AQI_API
+void calc_aqi_all_view(
+             const aqi_view_t *co,  const aqi_view_t *nh3,
+             const aqi_view_t *no,  const aqi_view_t *no2,
+             const aqi_view_t *o3,  const aqi_view_t *pb,
+             const aqi_view_t *so2, const aqi_view_t *pm10,
+             const aqi_view_t *pm2_5,
+             int aqi[NUM_AQI_SCALES]);
+
+/* Validity masks
+ *
+ * A validity mask marks which of the 24 hourly samples of a pollutant are
+ * valid: bit h is set when sample h is, so bit 23 is the most recent hour.
+ * AQI_ALL_VALID marks every hour as valid.
+ *
+ * Averages divide by the number of valid hours in the window rather than the
+ * window length, and an average is only available when at least 75% of the
+ * hours in its window are valid (e.g. 18 of 24, 6 of 8, or the last hour for
+ * a 1 hour average). An average that is not available counts as a
+ * concentration that is not available.
+ */
+#define AQI_ALL_VALID 0xffffffu
+
+/* Returns the average pollutant concentration over the valid hours among the
+ * previous 'hours' hours, or 0 if fewer than 75% of them are valid. Identical
+ * to avg_conc() when every hour of the window is valid.
+ */
+AQI_API
+float avg_conc_masked(const float pollutant[24], uint32_t valid, int hours);
+
+/* Equivalent of calc_aqi() with a validity mask for each pollutant, indexed
+ * by aqi_pollutant_t. Passing NULL for 'valid' marks every hour as valid.
+ */
+AQI_API
+int calc_aqi_masked(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24],
+             const uint32_t valid[NUM_AQI_POLLUTANTS]);
+
+/* Equivalent of calc_aqi() that also writes the sub-index of every pollutant
+ * and the dominant pollutant to 'detail'.
+ */
+AQI_API
+int calc_aqi_detail(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24],
+             aqi_detail_t *detail);
+
+/* Hourly pollutant concentrations for many stations, organized as a
+ * structure-of-arrays.
+ *
+ * Each member points to a column of 24 * n samples, where n is the number of
+ * stations. Samples are stored hour-major, so the concentration of station i
+ * at hour h is column[h * n + i]. As with the calc_* functions, hour 0 is the
+ * least recent and hour 23 is the most recent sample.
+ *
+ * Set a member to NULL to indicate that a concentration is not available for
+ * any station.
+ */
+typedef struct {
+  const float *co;
+  const float *nh3;
+  const float *no;
+  const float *no2;
+  const float *o3;
+  const float *pb;
+  const float *so2;
+  const float *pm10;
+  const float *pm2_5;
+} aqi_columns_t;
+
+/* Given a scale and hourly pollutant concentrations for n stations, writes the
+ * Air Quality Index of each station to out[0..n-1].
+ *
+ * The results are identical to calling calc_aqi() once per station.
+ */
+AQI_API
+void calc_aqi_batch(aqi_scale_t scale, size_t n, const aqi_columns_t *in,
+                    int *out);
+
+/* Returns the name of the instruction set the batch kernels run on: "scalar",
+ * "sse4.2", "avx2" or "avx512".
+ *
+ * On x86 the widest set the CPU supports is chosen when the library is loaded.
+ * Set the AQI_FORCE_ISA environment variable to one of these names to use a
+ * narrower set instead, e.g. to benchmark or validate each path on one
+ * machine; a set the CPU does not support is ignored. Results are identical
+ * on every instruction set.
+ */
+AQI_API
+const char *aqi_isa(void);
+
+/* Hourly pollutant concentrations on a grid, such as the output of a
+ * chemical-transport forecast.
+ *
+ * Each species member points to a stack of hourly planes of a rows x cols
+ * grid. The concentration of cell (r, c) at hour h is
+ * species[h * plane_stride + r * row_stride + c], with both strides counted in
+ * floats, so one plane can be a window into a larger grid and the hours of
+ * a 3D grid can follow each other in memory. Hour 0 is the least recent.
+ *
+ * Set a species to NULL to indicate that it is not available anywhere on the
+ * grid.
+ */
+typedef struct {
+  const float *co;
+  const float *nh3;
+  const float *no;
+  const float *no2;
+  const float *o3;
+  const float *pb;
+  const float *so2;
+  const float *pm10;
+  const float *pm2_5;
+  size_t rows;
+  size_t cols;
+  size_t row_stride;
+  size_t plane_stride;
+} aqi_raster_t;
+
+/* Given a scale, writes the Air Quality Index at hour 'hour' of every cell in
+ * rows [row_begin, row_end) of a raster to out[r * out_stride + c], using
+ * hours hour - 23 to hour of each cell. 'hour' must be at least 23.
+ *
+ * Rows are evaluated in tiles by the same kernels as calc_aqi_batch(), so the
+ * results are identical to calling calc_aqi() once per cell, except that
+ * indices outside the range of int16_t are saturated to INT16_MIN or
+ * INT16_MAX (only the unbounded scales, Australia and Canada, can exceed
+ * INT16_MAX with valid inputs). Calls on disjoint
+ * row ranges are independent, so a raster can be split across threads by
+ * rows.
+ */
+AQI_API
+void calc_aqi_raster(aqi_scale_t scale, const aqi_raster_t *in, size_t hour,
+                     size_t row_begin, size_t row_end,
+                     int16_t *out, size_t out_stride);
+
+/* Executor for the *_parallel functions.
+ *
+ * run(ctx, count, task, arg) must call task(arg, i) exactly once for every i
+ * in [0, count), in any order and on any threads, and return once all calls
+ * have finished. Each task writes a disjoint part of the output, so results
+ * never depend on the executor or on the number of threads it uses.
+ *
+ * Plug in your own executor to share an existing thread pool, or define
+ * AQI_THREADS to use the built-in aqi_pool_t.
+ */
+typedef void (*aqi_task_fn)(void *arg, size_t index);
+
+typedef struct {
+  void (*run)(void *ctx, size_t count, aqi_task_fn task, void *arg);
+  void *ctx;
+} aqi_executor_t;
+
+/* Same as calc_aqi_batch(), with the stations split into chunks of
+ * consecutive stations that are evaluated as tasks of 'executor'. A NULL
+ * executor evaluates every chunk on the calling thread.
+ *
+ * The results are identical to calc_aqi_batch().
+ */
+AQI_API
+void calc_aqi_batch_parallel(aqi_scale_t scale, size_t n,
+                             const aqi_columns_t *in, int *out,
+                             const aqi_executor_t *executor);
+
+/* Same as calc_aqi_raster() over every row of the raster, with the rows split
+ * into bands that are evaluated as tasks of 'executor'. A NULL executor
+ * evaluates every band on the calling thread.
+ *
+ * The results are identical to calc_aqi_raster().
+ */
+AQI_API
+void calc_aqi_raster_parallel(aqi_scale_t scale, const aqi_raster_t *in,
+                              size_t hour, int16_t *out, size_t out_stride,
+                              const aqi_executor_t *executor);
+
+/* Define the AQI_THREADS macro below (or pass -DAQI_THREADS when compiling
+ * aqi.c and your sources, and link with -pthread) to enable aqi_pool_t, a
+ * POSIX threads executor.
+ */
+// #define AQI_THREADS
+
+#ifdef AQI_THREADS
+#include <pthread.h>
+
+/* Maximum number of threads of an aqi_pool_t, including the calling thread.
+ */
+#define AQI_POOL_MAX_THREADS 64
+
+typedef struct aqi_pool aqi_pool_t;
+
+/* Tasks not yet started by one thread of an aqi_pool_t.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  size_t next;
+  size_t end;
+} aqi_pool_queue_t;
+
+typedef struct {
+  pthread_t thread;
+  aqi_pool_t *pool;
+  int index;
+} aqi_pool_worker_t;
+
+/* Work-stealing thread pool.
+ *
+ * Each call starts by giving every thread an equal range of consecutive
+ * tasks, so neighbouring chunks of input stay on one core. A thread that runs
+ * out of tasks steals the later half of the remaining range of another
+ * thread. The calling thread works alongside the pool's threads.
+ *
+ * Treat the members as private. Calls through one pool are serialized; use a
+ * pool per calling thread to run several calls at once.
+ */
+struct aqi_pool {
+  int threads;
+  aqi_pool_worker_t workers[AQI_POOL_MAX_THREADS];
+  aqi_pool_queue_t queues[AQI_POOL_MAX_THREADS];
+  pthread_mutex_t run_lock;
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  unsigned long generation;
+  int busy;
+  int quit;
+  aqi_task_fn task;
+  void *arg;
+};
+
+/* Starts a pool of 'threads' threads, counting the calling thread, or one per
+ * online processor if 'threads' is less than 1. At most AQI_POOL_MAX_THREADS
+ * are used.
+ *
+ * Returns the number of threads of the pool, which is less than requested if
+ * the system could not start them all. The pool is usable either way.
+ */
+AQI_API
+int aqi_pool_init(aqi_pool_t *pool, int threads);
+
+/* Stops the threads of a pool. The pool must not be running a call.
+ */
+AQI_API
+void aqi_pool_destroy(aqi_pool_t *pool);
+
+/* Returns an executor that runs tasks on a pool.
+ */
+AQI_API
+aqi_executor_t aqi_pool_executor(aqi_pool_t *pool);
+#endif // AQI_THREADS
+
+/* Returns the number of bytes of scratch memory calc_aqi_mixed() needs for n
+ * stations.
+ */
+AQI_API
+size_t calc_aqi_mixed_scratch_size(size_t n);
+
+/* Given the scale of each of n stations and their hourly pollutant
+ * concentrations, writes the index of station i in its own scale to out[i].
+ *
+ * Stations are grouped by scale with a stable counting sort and every group is
+ * evaluated by the batch kernel of its scale, so fleets that mix scales avoid
+ * switching between scale functions station by station. 'scratch' must point
+ * to calc_aqi_mixed_scratch_size(n) bytes aligned as by malloc(); it is the
+ * only memory used beyond the stack.
+ *
+ * The results are identical to calling calc_aqi() once per station.
+ */
+AQI_API
+void calc_aqi_mixed(size_t n, const aqi_scale_t *scales,
+                    const aqi_columns_t *in, int *out, void *scratch);
+
+/* Rolling hourly state of a single station.
+ *
+ * Keeps the last 24 hourly samples of every pollutant in a ring buffer along
+ * with running sums over the 1, 3, 4, 8 and 24 hour windows used by the AQI
+ * scales, so adding an hour and evaluating a scale each take a constant number
+ * of operations.
+ *
+ * Treat the members as private; use the aqi_state_* functions below.
+ */
+#define AQI_STATE_WINDOWS 5
+
+typedef struct {
+  float  hist[NUM_AQI_POLLUTANTS][24];
+  double sum[NUM_AQI_POLLUTANTS][AQI_STATE_WINDOWS];
+  int    head;
+} aqi_state_t;
+
+/* Resets the state to 24 hours of 0 concentrations.
+ */
+AQI_API
+void aqi_state_init(aqi_state_t *state);
+
+/* Adds the most recent hourly concentrations (μg/m^3) to the state, dropping
+ * the least recent hour.
+ *
+ * Pass 0 for a concentration that is not available. As with passing NULL (or
+ * an array of 0's) to the calc_* functions, the pollutant then averages to 0.
+ */
+AQI_API
+void aqi_push_hour(aqi_state_t *state,
+                   float co,  float nh3, float no,   float no2,  float o3,
+                   float pb,  float so2, float pm10, float pm2_5);
+
+/* Returns the average concentration of a pollutant over the previous 'hours'
+ * hours, where 'hours' is one of 1, 3, 4, 8 or 24.
+ *
+ * Sums are kept in double precision, so the result agrees with avg_conc() over
+ * the same samples to within float rounding.
+ */
+AQI_API
+float aqi_state_avg(const aqi_state_t *state, aqi_pollutant_t pollutant,
+                    int hours);
+
+/* Given a scale, returns the Air Quality Index of the hours held in the state.
+ * Equivalent to calling calc_aqi() on the last 24 pushed hours, except when an
+ * average differing in the last bit from avg_conc() falls across a breakpoint.
+ */
+AQI_API
+int aqi_state_eval(const aqi_state_t *state, aqi_scale_t scale);
+
+/* Histories of any length
+ *
+ * The functions below take 'count' hourly samples per pollutant instead of 24,
+ * organized from least recent (index 0) to most recent (index count - 1). As
+ * with the calc_* functions, pass NULL to indicate that a concentration is not
+ * available.
+ */
+
+/* Returns the average of the most recent 'hours' of 'count' hourly samples,
+ * summed in the same order as avg_conc(). 'hours' must be between 1 and count.
+ *
+ * Passing NULL will return 0.
+ */
+AQI_API
+float avg_conc_n(const float *pollutant, size_t count, int hours);
+
+/* Given a scale, returns the Air Quality Index of the most recent hour of
+ * histories of 'count' samples. 'count' must be at least 24.
+ *
+ * The result is identical to calling calc_aqi() on the last 24 samples.
+ */
+AQI_API
+int calc_aqi_n(aqi_scale_t scale, size_t count,
+             const float *co,  const float *nh3,  const float *no,
+             const float *no2, const float *o3,   const float *pb,
+             const float *so2, const float *pm10, const float *pm2_5);
+
+/* Given a scale, evaluates the Air Quality Index at every hour of histories of
+ * 'count' samples that has 24 hours of samples behind it, writing the index of
+ * the 24 hours ending at hour i + 23 to out[i], for i in [0, count - 23).
+ * Nothing is written when count is less than 24.
+ *
+ * 24 hour averages are kept as running sums that slide along the histories,
+ * so the cost grows with 'count' alone rather than with count * 24. As with
+ * aqi_state_eval(), those sums are kept in double precision and the results
+ * equal calc_aqi() on each 24 hour slice, except when a 24 hour average
+ * differing in the last bit from avg_conc() falls across a breakpoint.
+ */
+AQI_API
+void calc_aqi_series(aqi_scale_t scale, size_t count,
+             const float *co,  const float *nh3,  const float *no,
+             const float *no2, const float *o3,   const float *pb,
+             const float *so2, const float *pm10, const float *pm2_5,
+             int *out);
+
+/* Prefix sums of the hourly samples of one pollutant, built once per history
+ * so that the average over any window is two loads and a subtract.
+ *
+ * sum[k] is the sum of the first k samples, for k in [0, count], so 'sum' must
+ * have room for count + 1 values. Each running sum is accumulated with
+ * compensated summation, so it stays accurate to double precision rounding
+ * however long the history is.
+ */
+typedef struct {
+  const double *sum;
+  size_t count;
+} aqi_prefix_t;
+
+/* Builds the prefix sums of 'count' hourly samples of a pollutant into
+ * sum[0..count] and points 'prefix' at them.
+ */
+AQI_API
+void aqi_prefix_build(aqi_prefix_t *prefix, double *sum,
+                      const float *pollutant, size_t count);
+
+/* Returns the average concentration over the 'hours' hours ending at (and
+ * including) sample 'hour', for any window length from 1 to hour + 1. Passing
+ * NULL (or a prefix with a NULL sum) will return 0.
+ */
+AQI_API
+float aqi_prefix_avg(const aqi_prefix_t *prefix, size_t hour, int hours);
+
+/* Given a scale, returns the Air Quality Index of the 24 hours ending at (and
+ * including) sample 'hour' of histories held as prefix sums. 'hour' must be at
+ * least 23. Pass NULL to indicate that a concentration is not available.
+ *
+ * As with aqi_state_eval(), the result equals calc_aqi() on the same 24
+ * samples, except when an average differing in the last bit from avg_conc()
+ * falls across a breakpoint.
+ */
+AQI_API
+int calc_aqi_prefix(aqi_scale_t scale, size_t hour,
+             const aqi_prefix_t *co,  const aqi_prefix_t *nh3,
+             const aqi_prefix_t *no,  const aqi_prefix_t *no2,
+             const aqi_prefix_t *o3,  const aqi_prefix_t *pb,
+             const aqi_prefix_t *so2, const aqi_prefix_t *pm10,
+             const aqi_prefix_t *pm2_5);
+
+/* US EPA NowCast
+ *
+ * The United States publishes hourly AQI values for particulate matter using
+ * the NowCast, a weighted average over the last 12 hours that reacts faster
+ * than the 24 hour average to changing concentrations. With c1 the most recent
+ * hourly concentration and c12 the least recent,
+ *
+ *   w = max(min(c1..c12) / max(c1..c12), 0.5)
+ *   NowCast = sum(w^(i-1) * ci) / sum(w^(i-1))
+ *
+ * where hours without a sample are left out of both sums. The NowCast is not
+ * available unless at least 2 of the 3 most recent hours have a sample.
+ *
+ * Mark an hour without a sample with NaN. Unlike the calc_* functions, a
+ * concentration of 0 is treated as a sample.
+ */
+#define AQI_NOWCAST_HOURS 12
+
+/* Returns the NowCast of an array of 24 hourly samples organized as for the
+ * calc_* functions, computed from the most recent 12 hours, or NaN if it is
+ * not available. Passing NULL will return 0.
+ */
+AQI_API
+float nowcast_conc(const float pollutant[24]);
+
+/* Equivalent of calc_united_states_aqi() that uses the NowCast of pm10 and
+ * pm2_5 in place of their 24 hour averages, as for the hourly values the US EPA
+ * publishes. A NowCast that is not available counts as a concentration that is
+ * not available.
+ */
+AQI_API
+int calc_united_states_aqi_nowcast(
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24]);
+
+/* Rolling NowCast state of one pollutant at a single station.
+ *
+ * Adding an hour takes a constant number of operations. Every sample is stored
+ * twice, AQI_NOWCAST_HOURS slots apart, so the last 12 hours are always
+ * contiguous and evaluating needs no copy.
+ *
+ * Treat the members as private; use the aqi_nowcast_* functions below.
+ */
+typedef struct {
+  float hist[2 * AQI_NOWCAST_HOURS];
+  int   head;
+} aqi_nowcast_t;
+
+/* Resets the state to 12 hours without a sample.
+ */
+AQI_API
+void aqi_nowcast_init(aqi_nowcast_t *nowcast);
+
+/* Adds the most recent hourly concentration (μg/m^3), or NaN if there is no
+ * sample for the hour, dropping the least recent hour.
+ */
+AQI_API
+void aqi_nowcast_push(aqi_nowcast_t *nowcast, float conc);
+
+/* Returns the NowCast of the last 12 pushed hours, or NaN if it is not
+ * available.
+ */
+AQI_API
+float aqi_nowcast_value(const aqi_nowcast_t *nowcast);
+
+/* Returns the United States AQI of a station using the averages held in
+ * 'state' for gases and the NowCast of pm10 and pm2_5. Pass NULL to indicate
+ * that a NowCast is not kept for a pollutant.
+ */
+AQI_API
+int aqi_state_eval_nowcast(const aqi_state_t *state,
+                           const aqi_nowcast_t *pm10,
+                           const aqi_nowcast_t *pm2_5);
+
+/* Rolling minute-resolution state of a single station.
+ *
+ * Keeps the last 24 hours of per-minute samples of every pollutant in a ring
+ * buffer along with running sums over the 15 minute and 1, 3, 4, 8 and 24 hour
+ * windows, so adding a minute and evaluating a scale each take a constant
+ * number of operations. Unlike aqi_state_t, the United Kingdom DAQI is given
+ * the true 15 minute mean of so2.
+ *
+ * Treat the members as private; use the aqi_minute_state_* functions below.
+ */
+#define AQI_MINUTES_PER_DAY      (24 * 60)
+#define AQI_MINUTE_STATE_WINDOWS 6
+
+typedef struct {
+  float  hist[NUM_AQI_POLLUTANTS][AQI_MINUTES_PER_DAY];
+  double sum[NUM_AQI_POLLUTANTS][AQI_MINUTE_STATE_WINDOWS];
+  int    head;
+} aqi_minute_state_t;
+
+/* Resets the state to 24 hours of 0 concentrations.
+ */
+AQI_API
+void aqi_minute_state_init(aqi_minute_state_t *state);
+
+/* Adds the most recent per-minute concentrations (μg/m^3) to the state,
+ * dropping the least recent minute. Pass 0 for a concentration that is not
+ * available.
+ */
+AQI_API
+void aqi_push_minute(aqi_minute_state_t *state,
+                     float co,  float nh3, float no,   float no2,  float o3,
+                     float pb,  float so2, float pm10, float pm2_5);
+
+/* Returns the average concentration of a pollutant over the previous
+ * 'minutes' minutes, where 'minutes' is one of 15, 60, 180, 240, 480 or 1440.
+ * Sums are kept in double precision.
+ */
+AQI_API
+float aqi_minute_state_avg(const aqi_minute_state_t *state,
+                           aqi_pollutant_t pollutant, int minutes);
+
+/* Given a scale, returns the Air Quality Index of the minutes held in the
+ * state, with each '_Xh' average taken over the previous X * 60 minutes.
+ */
+AQI_API
+int aqi_minute_state_eval(const aqi_minute_state_t *state, aqi_scale_t scale);
+
+/* Define the AQI_FIXED_POINT macro below (or pass -DAQI_FIXED_POINT when
+ * compiling aqi.c and your sources) to enable the integer-only *_fixed
+ * functions.
+ */
+// #define AQI_FIXED_POINT
+
+#ifdef AQI_FIXED_POINT
+/* Fixed-point concentrations, in hundredths of a μg/m^3.
+ *
+ * Ex: 12.34 μg/m^3 is represented as 1234.
+ */
+typedef int32_t aqi_fixed_t;
+
+#define AQI_FIXED_ONE 100
+
+/* Integer-only versions of the scale functions, for targets without a
+ * hardware FPU. Concentrations are given as aqi_fixed_t. No floating point
+ * arithmetic is performed.
+ *
+ * Breakpoints are compared as the float versions compare them, and the United
+ * States AQI reads the same lookup tables, so the results match the float
+ * versions except where float rounding error decides those, i.e. where moving
+ * a float argument by a few units in the last place changes the result:
+ *
+ *   - A sub-index exactly halfway between two index values, e.g. 27.5 for
+ *     6.60 μg/m^3 of pm2_5 (Singapore PSI). The fixed-point versions round
+ *     half up.
+ *   - (United States AQI) A concentration exactly on a truncation step, e.g.
+ *     343.68 μg/m^3 of co (0.3 ppm), which the float version may truncate to
+ *     the step below.
+ *   - (Canada and Hong Kong AQHI) An index within about 1e-6 of a rounding or
+ *     band boundary, where the fixed-point exponential and libm may disagree.
+ *
+ * calc_aqi_fixed() has the same exceptions. Its averages are rounded to the
+ * nearest hundredth, where calc_aqi() keeps the float average, so those
+ * exceptions may also come from averaging. test/aqi_fixed_test.c checks that
+ * every difference is one of them.
+ */
+AQI_API
+int australia_aqi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t no2_1h,
+                        aqi_fixed_t o3_1h,    aqi_fixed_t o3_4h,
+                        aqi_fixed_t so2_1h,   aqi_fixed_t pm10_24h,
+                        aqi_fixed_t pm2_5_24h);
+
+AQI_API
+int canada_aqhi_fixed(aqi_fixed_t no2_3h, aqi_fixed_t o3_3h,
+                      aqi_fixed_t pm2_5_3h);
+
+AQI_API
+int china_aqi_fixed(aqi_fixed_t co_1h,    aqi_fixed_t co_24h,
+                    aqi_fixed_t no2_1h,   aqi_fixed_t no2_24h,
+                    aqi_fixed_t o3_1h,    aqi_fixed_t o3_8h,
+                    aqi_fixed_t so2_1h,   aqi_fixed_t so2_24h,
+                    aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h);
+
+AQI_API
+int european_union_caqi_fixed(aqi_fixed_t no2_1h,  aqi_fixed_t o3_1h,
+                              aqi_fixed_t pm10_1h, aqi_fixed_t pm2_5_1h);
+
+AQI_API
+int hong_kong_aqhi_fixed(aqi_fixed_t no2_3h,  aqi_fixed_t o3_3h,
+                         aqi_fixed_t so2_3h,  aqi_fixed_t pm10_3h,
+                         aqi_fixed_t pm2_5_3h);
+
+AQI_API
+int india_aqi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t nh3_24h,
+                    aqi_fixed_t no2_24h,  aqi_fixed_t o3_8h,
+                    aqi_fixed_t pb_24h,   aqi_fixed_t so2_24h,
+                    aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h);
+
+AQI_API
+int singapore_psi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t no2_1h,
+                        aqi_fixed_t o3_1h,    aqi_fixed_t o3_8h,
+                        aqi_fixed_t so2_24h,  aqi_fixed_t pm10_24h,
+                        aqi_fixed_t pm2_5_24h);
+
+AQI_API
+int south_korea_cai_fixed(aqi_fixed_t co_1h,    aqi_fixed_t no2_1h,
+                          aqi_fixed_t o3_1h,    aqi_fixed_t so2_1h,
+                          aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h);
+
+AQI_API
+int united_kingdom_daqi_fixed(aqi_fixed_t no2_1h,   aqi_fixed_t o3_8h,
+                              aqi_fixed_t so2_15min, aqi_fixed_t pm10_24h,
+                              aqi_fixed_t pm2_5_24h);
+
+AQI_API
+int united_states_aqi_fixed(aqi_fixed_t co_8h,    aqi_fixed_t no2_1h,
+                            aqi_fixed_t o3_1h,    aqi_fixed_t o3_8h,
+                            aqi_fixed_t so2_1h,   aqi_fixed_t so2_24h,
+                            aqi_fixed_t pm10_24h, aqi_fixed_t pm2_5_24h);
+
+/* Fixed-point version of calc_aqi(). Pass NULL (or an array of 0's) to
+ * indicate that a concentration is not available.
+ */
+AQI_API
+int calc_aqi_fixed(aqi_scale_t scale,
+             const aqi_fixed_t co[24],  const aqi_fixed_t nh3[24],
+             const aqi_fixed_t no[24],  const aqi_fixed_t no2[24],
+             const aqi_fixed_t o3[24],  const aqi_fixed_t pb[24],
+             const aqi_fixed_t so2[24], const aqi_fixed_t pm10[24],
+             const aqi_fixed_t pm2_5[24]);
+#endif // AQI_FIXED_POINT
+
 /* Each AQI scale has a maximum value, above which AQI is typically denoted by
  * ">{AQI_MAX}" or "{AQI_MAX}+".
  */
@@ -182,6 +1065,7 @@ int calc_aqi(aqi_scale_t scale,
 
 /* Returns the maximum value for the given AQI scale.
  */
+AQI_API
 int aqi_scale_max(aqi_scale_t scale);
 
 /* Returns the descriptor/category of an AQI value.
@@ -190,22 +1074,66 @@ int aqi_scale_max(aqi_scale_t scale);
  *   united_states_aqi_desc(52);
  *   returns "Moderate"
  */
+AQI_API
 const char *australia_aqi_desc(      int aqi);
+AQI_API
 const char *canada_aqhi_desc(        int aqhi);
+AQI_API
 const char *china_aqi_desc(          int aqi);
+AQI_API
 const char *european_union_caqi_desc(int caqi);
+AQI_API
 const char *hong_kong_aqhi_desc(     int aqhi);
+AQI_API
 const char *india_aqi_desc(          int aqi);
+AQI_API
 const char *singapore_psi_desc(      int psi);
+AQI_API
 const char *south_korea_cai_desc(    int cai);
+AQI_API
 const char *united_kingdom_daqi_desc(int daqi);
+AQI_API
 const char *united_states_aqi_desc(  int aqi);
 
 /* Given an AQI scale and an index value, returns a pointer the corresponding
  * descriptor.
  */
+AQI_API
 const char *aqi_desc(aqi_scale_t scale, int val);
 
+/* Largest number of descriptor categories of any AQI scale.
+ */
+#define AQI_MAX_CATEGORIES 6
+
+/* Given an AQI scale and an index value, returns its descriptor category: the
+ * position of aqi_desc(scale, val) among the descriptors of the scale, from 0
+ * up to aqi_num_categories(scale) - 1.
+ *
+ * Computed without branches from a table of category thresholds, for uses
+ * that only need the category, e.g. picking a colour.
+ */
+AQI_API
+int aqi_category(aqi_scale_t scale, int val);
+
+/* Returns the number of descriptor categories of an AQI scale.
+ */
+AQI_API
+int aqi_num_categories(aqi_scale_t scale);
+
+/* Given an AQI scale, writes the descriptor category of values[0..n-1] to
+ * out[0..n-1], using vector compares on CPUs that support them.
+ */
+AQI_API
+void aqi_category_batch(aqi_scale_t scale, size_t n, const int *values,
+                        uint8_t *out);
+
+/* Returns the descriptor of a category of an AQI scale, so that
+ * aqi_category_desc(scale, aqi_category(scale, val)) is aqi_desc(scale, val).
+ * Returns NULL for a category outside 0 to aqi_num_categories(scale) - 1.
+ */
+AQI_API
+const char *aqi_category_desc(aqi_scale_t scale, int category);
+
 /* The descriptors for an AQI scale generally describe either
  *   (0) Air Quality
  * or
@@ -225,6 +1153,7 @@ const char *aqi_desc(aqi_scale_t scale, int val);
 /* Given a AQI scale, returns what the descriptor text indicates air quality or
  * air pollution.
  */
+AQI_API
 aqi_desc_type_t aqi_desc_type(aqi_scale_t scale);
 
 /* If you do not want to use the default descriptors, you may define the
@@ -237,4 +1166,8 @@ aqi_desc_type_t aqi_desc_type(aqi_scale_t scale);
 }
 #endif
 
+#ifdef AQI_HEADER_ONLY
+#include "aqi.c"
+#endif
+
 #endif
@@ -0,0 +1,538 @@
+/* C++ interface for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* C++20 wrapper around aqi.h. Every function forwards to the C library, so
+ * results are the ones aqi.c computes; link aqi.c as usual.
+ *
+ * Scales can be chosen at compile time, but indices are always computed at
+ * run time: the breakpoint tables and scale rules live only in aqi.c, and
+ * are not mirrored here as constexpr tables. Only the properties of a scale
+ * (scale_traits, max_index, desc_type) are compile-time constants.
+ *
+ * Ex:
+ *   int us = aqi::evaluate<aqi::scale::us>({ .o3 = o3, .pm2_5 = pm2_5 });
+ */
+
+#ifndef __AQI_HPP__
+#define __AQI_HPP__
+
+#include "aqi.h"
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace aqi
+{
+
+enum class scale : int {
+  australia   = AUSTRALIA_AQI,
+  canada      = CANADA_AQHI,
+  china       = CHINA_AQI,
+  eu          = EUROPEAN_UNION_CAQI,
+  hong_kong   = HONG_KONG_AQHI,
+  india       = INDIA_AQI,
+  singapore   = SINGAPORE_PSI,
+  south_korea = SOUTH_KOREA_CAI,
+  uk          = UNITED_KINGDOM_DAQI,
+  us          = UNITED_STATES_AQI,
+};
+
+/* 24 hourly samples of a pollutant, from least recent (index 0) to most recent
+ * (index 23).
+ */
+using hours = std::span<const float, 24>;
+
+/* Hourly samples of a station, as passed to calc_aqi(). An empty member means
+ * the concentration is not available.
+ */
+struct hourly {
+  std::optional<hours> co{};
+  std::optional<hours> nh3{};
+  std::optional<hours> no{};
+  std::optional<hours> no2{};
+  std::optional<hours> o3{};
+  std::optional<hours> pb{};
+  std::optional<hours> so2{};
+  std::optional<hours> pm10{};
+  std::optional<hours> pm2_5{};
+};
+
+/* Hour-major samples of n stations, as in aqi_columns_t. Each non-empty span
+ * must hold 24 * n samples; an empty span means the concentration is not
+ * available for any station.
+ */
+struct columns {
+  std::span<const float> co{};
+  std::span<const float> nh3{};
+  std::span<const float> no{};
+  std::span<const float> no2{};
+  std::span<const float> o3{};
+  std::span<const float> pb{};
+  std::span<const float> so2{};
+  std::span<const float> pm10{};
+  std::span<const float> pm2_5{};
+};
+
+namespace detail
+{
+
+constexpr const float *samples(const std::optional<hours> &s)
+{
+  return s ? s->data() : nullptr;
+} // end samples
+
+// Precondition: a non-empty column holds 24 samples of each of n stations.
+inline const float *column(std::span<const float> s, std::size_t n)
+{
+  assert(s.empty() || s.size() == 24 * n);
+  return s.empty() ? nullptr : s.data();
+} // end column
+
+inline aqi_columns_t to_c(const columns &in, std::size_t n)
+{
+  return aqi_columns_t{
+    column(in.co, n),  column(in.nh3, n), column(in.no, n),
+    column(in.no2, n), column(in.o3, n),  column(in.pb, n),
+    column(in.so2, n), column(in.pm10, n), column(in.pm2_5, n),
+  };
+} // end to_c
+
+} // namespace detail
+
+constexpr aqi_scale_t to_c(scale s)
+{
+  return static_cast<aqi_scale_t>(s);
+} // end to_c
+
+/* Compile-time properties of a scale, and its calc_* function.
+ *
+ * 'calc' calls the scale's calc_* function directly, so evaluate<S>() does not
+ * go through calc_aqi()'s table of function pointers.
+ */
+template <scale S>
+struct scale_traits;
+
+template <>
+struct scale_traits<scale::australia>
+{
+  static constexpr aqi_scale_t c_scale = AUSTRALIA_AQI;
+  static constexpr int max = AUSTRALIA_AQI_MAX;
+  static constexpr aqi_desc_type_t desc_type = AUSTRALIA_AQI_DESC_TYPE;
+  static constexpr auto calc = calc_australia_aqi;
+  static constexpr auto desc = australia_aqi_desc;
+};
+
+template <>
+struct scale_traits<scale::canada>
+{
+  static constexpr aqi_scale_t c_scale = CANADA_AQHI;
+  static constexpr int max = CANADA_AQHI_MAX;
+  static constexpr aqi_desc_type_t desc_type = CANADA_AQHI_DESC_TYPE;
+  static constexpr auto calc = calc_canada_aqhi;
+  static constexpr auto desc = canada_aqhi_desc;
+};
+
+template <>
+struct scale_traits<scale::china>
+{
+  static constexpr aqi_scale_t c_scale = CHINA_AQI;
+  static constexpr int max = CHINA_AQI_MAX;
+  static constexpr aqi_desc_type_t desc_type = CHINA_AQI_DESC_TYPE;
+  static constexpr auto calc = calc_china_aqi;
+  static constexpr auto desc = china_aqi_desc;
+};
+
+template <>
+struct scale_traits<scale::eu>
+{
+  static constexpr aqi_scale_t c_scale = EUROPEAN_UNION_CAQI;
+  static constexpr int max = EUROPEAN_UNION_CAQI_MAX;
+  static constexpr aqi_desc_type_t desc_type = EUROPEAN_UNION_CAQI_DESC_TYPE;
+  static constexpr auto calc = calc_european_union_caqi;
+  static constexpr auto desc = european_union_caqi_desc;
+};
+
+template <>
+struct scale_traits<scale::hong_kong>
+{
+  static constexpr aqi_scale_t c_scale = HONG_KONG_AQHI;
+  static constexpr int max = HONG_KONG_AQHI_MAX;
+  static constexpr aqi_desc_type_t desc_type = HONG_KONG_AQHI_DESC_TYPE;
+  static constexpr auto calc = calc_hong_kong_aqhi;
+  static constexpr auto desc = hong_kong_aqhi_desc;
+};
+
+template <>
+struct scale_traits<scale::india>
+{
+  static constexpr aqi_scale_t c_scale = INDIA_AQI;
+  static constexpr int max = INDIA_AQI_MAX;
+  static constexpr aqi_desc_type_t desc_type = INDIA_AQI_DESC_TYPE;
+  static constexpr auto calc = calc_india_aqi;
+  static constexpr auto desc = india_aqi_desc;
+};
+
+template <>
+struct scale_traits<scale::singapore>
+{
+  static constexpr aqi_scale_t c_scale = SINGAPORE_PSI;
+  static constexpr int max = SINGAPORE_PSI_MAX;
+  static constexpr aqi_desc_type_t desc_type = SINGAPORE_PSI_DESC_TYPE;
+  static constexpr auto calc = calc_singapore_psi;
+  static constexpr auto desc = singapore_psi_desc;
+};
+
+template <>
+struct scale_traits<scale::south_korea>
+{
+  static constexpr aqi_scale_t c_scale = SOUTH_KOREA_CAI;
+  static constexpr int max = SOUTH_KOREA_CAI_MAX;
+  static constexpr aqi_desc_type_t desc_type = SOUTH_KOREA_CAI_DESC_TYPE;
+  static constexpr auto calc = calc_south_korea_cai;
+  static constexpr auto desc = south_korea_cai_desc;
+};
+
+template <>
+struct scale_traits<scale::uk>
+{
+  static constexpr aqi_scale_t c_scale = UNITED_KINGDOM_DAQI;
+  static constexpr int max = UNITED_KINGDOM_DAQI_MAX;
+  static constexpr aqi_desc_type_t desc_type = UNITED_KINGDOM_DAQI_DESC_TYPE;
+  static constexpr auto calc = calc_united_kingdom_daqi;
+  static constexpr auto desc = united_kingdom_daqi_desc;
+};
+
+template <>
+struct scale_traits<scale::us>
+{
+  static constexpr aqi_scale_t c_scale = UNITED_STATES_AQI;
+  static constexpr int max = UNITED_STATES_AQI_MAX;
+  static constexpr aqi_desc_type_t desc_type = UNITED_STATES_AQI_DESC_TYPE;
+  static constexpr auto calc = calc_united_states_aqi;
+  static constexpr auto desc = united_states_aqi_desc;
+};
+
+/* Highest index of a scale, known at compile time.
+ */
+template <scale S>
+inline constexpr int max_index = scale_traits<S>::max;
+
+/* Whether the descriptors of a scale describe air quality or air pollution,
+ * known at compile time.
+ */
+template <scale S>
+inline constexpr aqi_desc_type_t desc_type = scale_traits<S>::desc_type;
+
+/* Given a scale known at compile time, returns the Air Quality Index of a
+ * station. Same as calc_aqi().
+ */
+template <scale S>
+int evaluate(const hourly &in)
+{
+  return scale_traits<S>::calc(
+      detail::samples(in.co),  detail::samples(in.nh3),
+      detail::samples(in.no),  detail::samples(in.no2),
+      detail::samples(in.o3),  detail::samples(in.pb),
+      detail::samples(in.so2), detail::samples(in.pm10),
+      detail::samples(in.pm2_5));
+} // end evaluate
+
+/* Given a scale, returns the Air Quality Index of a station. Same as
+ * calc_aqi().
+ */
+inline int evaluate(scale s, const hourly &in)
+{
+  return calc_aqi(to_c(s),
+      detail::samples(in.co),  detail::samples(in.nh3),
+      detail::samples(in.no),  detail::samples(in.no2),
+      detail::samples(in.o3),  detail::samples(in.pb),
+      detail::samples(in.so2), detail::samples(in.pm10),
+      detail::samples(in.pm2_5));
+} // end evaluate
+
+/* Given a scale known at compile time, writes the Air Quality Index of each of
+ * out.size() stations to 'out'. Same as calc_aqi_batch(). Each non-empty
+ * column of 'in' must hold 24 * out.size() samples, which is checked with
+ * assert().
+ */
+template <scale S>
+void evaluate(const columns &in, std::span<int> out)
+{
+  const aqi_columns_t c = detail::to_c(in, out.size());
+  calc_aqi_batch(scale_traits<S>::c_scale, out.size(), &c, out.data());
+} // end evaluate
+
+/* Given a scale, writes the Air Quality Index of each of out.size() stations
+ * to 'out'. Same as calc_aqi_batch(), with the same precondition on 'in' as
+ * evaluate<S>(in, out).
+ */
+inline void evaluate(scale s, const columns &in, std::span<int> out)
+{
+  const aqi_columns_t c = detail::to_c(in, out.size());
+  calc_aqi_batch(to_c(s), out.size(), &c, out.data());
+} // end evaluate
+
+/* Same as evaluate(s, in, out), with the stations evaluated as tasks of
+ * 'executor' (NULL runs them on the calling thread). Same as
+ * calc_aqi_batch_parallel().
+ */
+inline void evaluate(scale s, const columns &in, std::span<int> out,
+                     const aqi_executor_t *executor)
+{
+  const aqi_columns_t c = detail::to_c(in, out.size());
+  calc_aqi_batch_parallel(to_c(s), out.size(), &c, out.data(), executor);
+} // end evaluate
+
+/* Returns the descriptor of an index on a scale known at compile time.
+ */
+template <scale S>
+std::string_view desc(int value)
+{
+  return scale_traits<S>::desc(value);
+} // end desc
+
+/* Returns the descriptor of an index on a scale.
+ */
+inline std::string_view desc(scale s, int value)
+{
+  return aqi_desc(to_c(s), value);
+} // end desc
+
+/* Concentrations (μg/m^3) of a station for one hour, as passed to
+ * aqi_push_hour(). 0 means the concentration is not available.
+ */
+struct sample {
+  float co = 0;
+  float nh3 = 0;
+  float no = 0;
+  float no2 = 0;
+  float o3 = 0;
+  float pb = 0;
+  float so2 = 0;
+  float pm10 = 0;
+  float pm2_5 = 0;
+};
+
+/* View of the hourly Air Quality Index of a range of samples, one hour at a
+ * time. Created by aqi::views::hourly.
+ *
+ * Element i is the index of hours i to i + 23 of the underlying range, so a
+ * range of n >= 24 hours has n - 23 elements, as with calc_aqi_series(). Each
+ * iterator carries an aqi_state_t, so advancing pushes one hour and
+ * dereferencing evaluates the scale, both in constant time, and nothing is
+ * allocated. Values are those of aqi_state_eval().
+ *
+ * The view is a forward range if the underlying range is one, so it works with
+ * algorithms such as std::ranges::max_element() and std::ranges::count_if(),
+ * and a common range if the underlying range is a common forward range.
+ * Iterators are about 1.3 KB; prefer algorithms that do not copy them often.
+ */
+template <std::ranges::input_range V>
+  requires std::ranges::view<V>
+        && std::convertible_to<std::ranges::range_reference_t<V>, sample>
+class hourly_view : public std::ranges::view_interface<hourly_view<V>>
+{
+public:
+  class iterator;
+
+  hourly_view() requires std::default_initializable<V> = default;
+
+  hourly_view(V base, scale s) : base_(std::move(base)), scale_(s)
+  {
+  }
+
+  V base() const & requires std::copy_constructible<V>
+  {
+    return base_;
+  }
+
+  V base() &&
+  {
+    return std::move(base_);
+  }
+
+  iterator begin()
+  {
+    return iterator(std::ranges::begin(base_), std::ranges::end(base_),
+                    to_c(scale_));
+  }
+
+  auto end()
+  {
+    if constexpr (std::ranges::common_range<V>
+                  && std::ranges::forward_range<V>)
+    {
+      return iterator(std::ranges::end(base_), std::ranges::end(base_),
+                      to_c(scale_));
+    }
+    else
+    {
+      return std::default_sentinel;
+    }
+  }
+
+  auto size() requires std::ranges::sized_range<V>
+  {
+    auto n = std::ranges::size(base_);
+    return n < 24 ? decltype(n){0} : n - 23;
+  }
+
+private:
+  V base_ = V();
+  scale scale_ = scale::us;
+};
+
+template <std::ranges::input_range V>
+  requires std::ranges::view<V>
+        && std::convertible_to<std::ranges::range_reference_t<V>, sample>
+class hourly_view<V>::iterator
+{
+public:
+  using iterator_concept = std::conditional_t<std::ranges::forward_range<V>,
+                                              std::forward_iterator_tag,
+                                              std::input_iterator_tag>;
+  using value_type = int;
+  using difference_type = std::ranges::range_difference_t<V>;
+
+  iterator() = default;
+
+  // Pushes the first 24 hours, or all of them if there are fewer.
+  iterator(std::ranges::iterator_t<V> current,
+           std::ranges::sentinel_t<V> end, aqi_scale_t s)
+    : current_(std::move(current)), end_(std::move(end)), scale_(s)
+  {
+    aqi_state_init(&state_);
+    for (int h = 0; h < 24 && current_ != end_; ++h)
+    {
+      if (h > 0)
+      {
+        ++current_;
+        if (current_ == end_)
+        {
+          return;
+        }
+      }
+      push();
+    }
+  }
+
+  int operator*() const
+  {
+    return aqi_state_eval(&state_, scale_);
+  }
+
+  iterator &operator++()
+  {
+    ++current_;
+    if (current_ != end_)
+    {
+      push();
+    }
+    return *this;
+  }
+
+  void operator++(int)
+  {
+    ++*this;
+  }
+
+  iterator operator++(int) requires std::ranges::forward_range<V>
+  {
+    iterator prev = *this;
+    ++*this;
+    return prev;
+  }
+
+  friend bool operator==(const iterator &a, const iterator &b)
+    requires std::ranges::forward_range<V>
+  {
+    return a.current_ == b.current_;
+  }
+
+  friend bool operator==(const iterator &it, std::default_sentinel_t)
+  {
+    return it.current_ == it.end_;
+  }
+
+private:
+  void push()
+  {
+    const sample s = *current_;
+    aqi_push_hour(&state_, s.co, s.nh3, s.no, s.no2, s.o3, s.pb, s.so2,
+                  s.pm10, s.pm2_5);
+  }
+
+  std::ranges::iterator_t<V> current_ = std::ranges::iterator_t<V>();
+  std::ranges::sentinel_t<V> end_ = std::ranges::sentinel_t<V>();
+  aqi_scale_t scale_ = UNITED_STATES_AQI;
+  aqi_state_t state_ = {};
+};
+
+template <class R>
+hourly_view(R &&, scale) -> hourly_view<std::views::all_t<R>>;
+
+namespace views
+{
+
+struct hourly_closure
+{
+  scale s;
+
+  template <std::ranges::viewable_range R>
+  friend auto operator|(R &&r, const hourly_closure &c)
+  {
+    return hourly_view(std::views::all(std::forward<R>(r)), c.s);
+  }
+};
+
+/* Range adaptor for hourly_view.
+ *
+ * Ex: hours above 150 on the China AQI, without allocating:
+ *   std::ranges::count_if(series | aqi::views::hourly(aqi::scale::china),
+ *                         [](int v) { return v > 150; });
+ */
+struct hourly_fn
+{
+  constexpr hourly_closure operator()(scale s) const
+  {
+    return hourly_closure{s};
+  }
+
+  template <std::ranges::viewable_range R>
+  auto operator()(R &&r, scale s) const
+  {
+    return hourly_view(std::views::all(std::forward<R>(r)), s);
+  }
+};
+
+inline constexpr hourly_fn hourly{};
+
+} // namespace views
+
+} // namespace aqi
+
+#endif
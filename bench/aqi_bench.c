@@ -0,0 +1,369 @@
+/* Benchmarks for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Times every scale function, calc_* function, calc_aqi() dispatch and
+ * descriptor function, and calc_aqi_batch() and calc_aqi_raster() for every
+ * scale, over several input distributions, and prints the results as JSON to
+ * stdout. Batch and raster times are per station.
+ *
+ * Build and run from the repository root:
+ *   cc -O2 -I. bench/aqi_bench.c aqi.c -lm -o aqi_bench
+ *   ./aqi_bench [min_ms_per_benchmark] > bench_output.json
+ *
+ * Set AQI_FORCE_ISA to scalar, sse4.2, avx2 or avx512 to time the batch and
+ * raster kernels of one instruction set; "isa" in the output names the one
+ * used.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "aqi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Number of distinct stations each benchmark cycles through. Small enough to
+ * stay in cache, large enough to defeat branch history.
+ */
+#define NUM_SAMPLES 4096
+
+typedef enum {
+  CLEAN_AIR,
+  REALISTIC_CITY,
+  WILDFIRE_SMOKE,
+  UNIFORM_RANDOM,
+  BOUNDARY_HEAVY,
+  NUM_DISTRIBUTIONS
+} distribution_t;
+
+static const char *DISTRIBUTION_NAME[NUM_DISTRIBUTIONS] = {
+  "clean_air",
+  "realistic_city",
+  "wildfire_smoke",
+  "uniform_random",
+  "boundary_heavy",
+};
+
+/* Concentration ranges (μg/m^3) of each distribution, ordered as
+ * aqi_pollutant_t. UNIFORM_RANDOM spans every band of every scale.
+ */
+static const float RANGE[NUM_DISTRIBUTIONS][NUM_AQI_POLLUTANTS][2] = {
+  // co             nh3           no            no2           o3
+  // pb             so2           pm10          pm2_5
+  { {100, 500},     {1, 20},      {1, 10},      {2, 20},      {20, 60},
+    {0, 0.05f},     {1, 10},      {5, 20},      {2, 10} },
+  { {300, 3000},    {10, 80},     {10, 100},    {20, 120},    {30, 150},
+    {0.05f, 0.3f},  {5, 60},      {20, 120},    {10, 60} },
+  { {2000, 20000},  {50, 300},    {20, 200},    {30, 200},    {50, 300},
+    {0.1f, 1},      {10, 100},    {150, 800},   {100, 600} },
+  { {0, 160000},    {0, 2000},    {0, 500},     {0, 4000},    {0, 1300},
+    {0, 4},         {0, 3000},    {0, 700},     {0, 550} },
+  { {0, 0},         {0, 0},       {0, 0},       {0, 0},       {0, 0},
+    {0, 0},         {0, 0},       {0, 0},       {0, 0} },
+};
+
+/* A selection of breakpoints (μg/m^3) from the scales, ordered as
+ * aqi_pollutant_t. BOUNDARY_HEAVY samples land on or right next to these.
+ */
+#define NUM_BOUNDARIES 8
+static const float BOUNDARY[NUM_AQI_POLLUTANTS][NUM_BOUNDARIES] = {
+  { 1000,  2000,  5000,  5041,  10000, 10310.4f, 14000, 35000 }, // co
+  { 200,   200.5f, 400,  400.5f, 800,  800.5f,   1200,  1800  }, // nh3
+  { 10,    20,    40,    80,    120,   160,      200,   250   }, // no
+  { 40,    50,    80,    100,   101.6f, 188.2f,  200,   400   }, // no2
+  { 60,    100,   106,   118.5f, 120,  160,      167.9f, 200  }, // o3
+  { 0.5f,  0.55f, 1,     1.05f, 2,     2.05f,    3,     3.5f  }, // pb
+  { 40,    50,    80.5f, 150,   296.6f, 475,     500,   800   }, // so2
+  { 25,    50,    54,    90,    100,   150,      154,   250   }, // pm10
+  { 9,     12,    15,    30,    35,    35.4f,    55.4f, 75    }, // pm2_5
+};
+
+typedef struct {
+  float hist[NUM_AQI_POLLUTANTS][24];
+  // averages for the scale functions
+  float co_1h, co_8h, co_24h, nh3_24h;
+  float no2_1h, no2_3h, no2_24h;
+  float o3_1h, o3_3h, o3_4h, o3_8h, pb_24h;
+  float so2_1h, so2_3h, so2_24h;
+  float pm10_1h, pm10_3h, pm10_24h;
+  float pm2_5_1h, pm2_5_3h, pm2_5_24h;
+  int   aqi[NUM_AQI_SCALES];
+} sample_t;
+
+static sample_t samples[NUM_SAMPLES];
+
+/* The hourly samples again as hour-major columns, for calc_aqi_batch(). Read
+ * as a raster, they are a RASTER_COLS wide grid with one plane per hour.
+ */
+static float columns[NUM_AQI_POLLUTANTS][24 * NUM_SAMPLES];
+static int batch_out[NUM_SAMPLES];
+static int16_t raster_out[NUM_SAMPLES];
+#define RASTER_COLS 64
+static volatile int sink;
+
+static unsigned long long rng_state = 0x9e3779b97f4a7c15ull;
+
+static float rand_unit(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (float)(rng_state >> 40) / (float)(1 << 24);
+} // end rand_unit
+
+static float rand_conc(distribution_t dist, int p)
+{
+  if (dist == BOUNDARY_HEAVY)
+  {
+    float b = BOUNDARY[p][(int)(rand_unit() * NUM_BOUNDARIES)];
+    // half on the boundary itself, half within +/-0.1%
+    return rand_unit() < 0.5f ? b : b * (0.999f + rand_unit() * 0.002f);
+  }
+  float lo = RANGE[dist][p][0];
+  float hi = RANGE[dist][p][1];
+  return lo + rand_unit() * (hi - lo);
+} // end rand_conc
+
+static float avg(const float hist[24], int hours)
+{
+  float sum = 0;
+  for (int h = 24 - hours; h < 24; ++h)
+  {
+    sum += hist[h];
+  }
+  return sum / (float) hours;
+} // end avg
+
+static void generate(distribution_t dist)
+{
+  for (int i = 0; i < NUM_SAMPLES; ++i)
+  {
+    sample_t *s = &samples[i];
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int h = 0; h < 24; ++h)
+      {
+        s->hist[p][h] = rand_conc(dist, p);
+      }
+    }
+    s->co_1h     = avg(s->hist[POLLUTANT_CO],     1);
+    s->co_8h     = avg(s->hist[POLLUTANT_CO],     8);
+    s->co_24h    = avg(s->hist[POLLUTANT_CO],    24);
+    s->nh3_24h   = avg(s->hist[POLLUTANT_NH3],   24);
+    s->no2_1h    = avg(s->hist[POLLUTANT_NO2],    1);
+    s->no2_3h    = avg(s->hist[POLLUTANT_NO2],    3);
+    s->no2_24h   = avg(s->hist[POLLUTANT_NO2],   24);
+    s->o3_1h     = avg(s->hist[POLLUTANT_O3],     1);
+    s->o3_3h     = avg(s->hist[POLLUTANT_O3],     3);
+    s->o3_4h     = avg(s->hist[POLLUTANT_O3],     4);
+    s->o3_8h     = avg(s->hist[POLLUTANT_O3],     8);
+    s->pb_24h    = avg(s->hist[POLLUTANT_PB],    24);
+    s->so2_1h    = avg(s->hist[POLLUTANT_SO2],    1);
+    s->so2_3h    = avg(s->hist[POLLUTANT_SO2],    3);
+    s->so2_24h   = avg(s->hist[POLLUTANT_SO2],   24);
+    s->pm10_1h   = avg(s->hist[POLLUTANT_PM10],   1);
+    s->pm10_3h   = avg(s->hist[POLLUTANT_PM10],   3);
+    s->pm10_24h  = avg(s->hist[POLLUTANT_PM10],  24);
+    s->pm2_5_1h  = avg(s->hist[POLLUTANT_PM2_5],  1);
+    s->pm2_5_3h  = avg(s->hist[POLLUTANT_PM2_5],  3);
+    s->pm2_5_24h = avg(s->hist[POLLUTANT_PM2_5], 24);
+    calc_aqi_all(s->hist[0], s->hist[1], s->hist[2], s->hist[3], s->hist[4],
+                 s->hist[5], s->hist[6], s->hist[7], s->hist[8], s->aqi);
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int h = 0; h < 24; ++h)
+      {
+        columns[p][h * NUM_SAMPLES + i] = s->hist[p][h];
+      }
+    }
+  }
+} // end generate
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+} // end now_ns
+
+static int first_result = 1;
+
+static void report(const char *function, distribution_t dist, double ns,
+                   double calls)
+{
+  double ns_per_call = ns / calls;
+  printf("%s\n    {\"function\": \"%s\", \"distribution\": \"%s\", "
+         "\"ns_per_call\": %.3f, \"calls_per_sec\": %.0f}",
+         first_result ? "" : ",", function, DISTRIBUTION_NAME[dist],
+         ns_per_call, 1e9 / ns_per_call);
+  first_result = 0;
+} // end report
+
+/* Repeats 'expr' over every sample until at least min_ns have elapsed, then
+ * reports the time per evaluation. 's' names the current sample in 'expr'.
+ */
+#define BENCH(function, dist, min_ns, expr)                                    \
+  do {                                                                         \
+    double calls = 0, start = now_ns(), elapsed;                               \
+    int acc = 0;                                                               \
+    do {                                                                       \
+      for (int i = 0; i < NUM_SAMPLES; ++i)                                    \
+      {                                                                        \
+        const sample_t *s = &samples[i];                                       \
+        acc += (expr);                                                         \
+      }                                                                        \
+      calls += NUM_SAMPLES;                                                    \
+      elapsed = now_ns() - start;                                              \
+    } while (elapsed < (min_ns));                                              \
+    sink = acc;                                                                \
+    report((function), (dist), elapsed, calls);                                \
+  } while (0)
+
+/* Repeats 'stmt', which evaluates every sample at once, until at least min_ns
+ * have elapsed, then reports the time per sample.
+ */
+#define BENCH_ALL(function, dist, min_ns, stmt)                                \
+  do {                                                                         \
+    double calls = 0, start = now_ns(), elapsed;                               \
+    do {                                                                       \
+      stmt;                                                                    \
+      calls += NUM_SAMPLES;                                                    \
+      elapsed = now_ns() - start;                                              \
+    } while (elapsed < (min_ns));                                              \
+    report((function), (dist), elapsed, calls);                                \
+  } while (0)
+
+#define HIST(s) (s)->hist[0], (s)->hist[1], (s)->hist[2], (s)->hist[3],        \
+                (s)->hist[4], (s)->hist[5], (s)->hist[6], (s)->hist[7],        \
+                (s)->hist[8]
+
+static const char *SCALE_NAME[NUM_AQI_SCALES] = {
+  "australia_aqi",
+  "canada_aqhi",
+  "china_aqi",
+  "european_union_caqi",
+  "hong_kong_aqhi",
+  "india_aqi",
+  "singapore_psi",
+  "south_korea_cai",
+  "united_kingdom_daqi",
+  "united_states_aqi",
+};
+
+static void bench_distribution(distribution_t d, double min_ns)
+{
+  char name[64];
+  const aqi_columns_t cols = {
+    columns[0], columns[1], columns[2], columns[3], columns[4],
+    columns[5], columns[6], columns[7], columns[8]
+  };
+  const aqi_raster_t raster = {
+    columns[0], columns[1], columns[2], columns[3], columns[4],
+    columns[5], columns[6], columns[7], columns[8],
+    NUM_SAMPLES / RASTER_COLS, RASTER_COLS, RASTER_COLS, NUM_SAMPLES
+  };
+
+  generate(d);
+
+  // scale functions, given pre-computed averages
+  BENCH("australia_aqi", d, min_ns,
+        australia_aqi(s->co_8h, s->no2_1h, s->o3_1h, s->o3_4h, s->so2_1h,
+                      s->pm10_24h, s->pm2_5_24h));
+  BENCH("canada_aqhi", d, min_ns,
+        canada_aqhi(s->no2_3h, s->o3_3h, s->pm2_5_3h));
+  BENCH("china_aqi", d, min_ns,
+        china_aqi(s->co_1h, s->co_24h, s->no2_1h, s->no2_24h, s->o3_1h,
+                  s->o3_8h, s->so2_1h, s->so2_24h, s->pm10_24h,
+                  s->pm2_5_24h));
+  BENCH("european_union_caqi", d, min_ns,
+        european_union_caqi(s->no2_1h, s->o3_1h, s->pm10_1h, s->pm2_5_1h));
+  BENCH("hong_kong_aqhi", d, min_ns,
+        hong_kong_aqhi(s->no2_3h, s->o3_3h, s->so2_3h, s->pm10_3h,
+                       s->pm2_5_3h));
+  BENCH("india_aqi", d, min_ns,
+        india_aqi(s->co_8h, s->nh3_24h, s->no2_24h, s->o3_8h, s->pb_24h,
+                  s->so2_24h, s->pm10_24h, s->pm2_5_24h));
+  BENCH("singapore_psi", d, min_ns,
+        singapore_psi(s->co_8h, s->no2_1h, s->o3_1h, s->o3_8h, s->so2_24h,
+                      s->pm10_24h, s->pm2_5_24h));
+  BENCH("south_korea_cai", d, min_ns,
+        south_korea_cai(s->co_1h, s->no2_1h, s->o3_1h, s->so2_1h,
+                        s->pm10_24h, s->pm2_5_24h));
+  BENCH("united_kingdom_daqi", d, min_ns,
+        united_kingdom_daqi(s->no2_1h, s->o3_8h, s->so2_1h, s->pm10_24h,
+                            s->pm2_5_24h));
+  BENCH("united_states_aqi", d, min_ns,
+        united_states_aqi(s->co_8h, s->no2_1h, s->o3_1h, s->o3_8h, s->so2_1h,
+                          s->so2_24h, s->pm10_24h, s->pm2_5_24h));
+
+  // calc_* functions, given hourly samples
+  BENCH("calc_australia_aqi",       d, min_ns, calc_australia_aqi(HIST(s)));
+  BENCH("calc_canada_aqhi",         d, min_ns, calc_canada_aqhi(HIST(s)));
+  BENCH("calc_china_aqi",           d, min_ns, calc_china_aqi(HIST(s)));
+  BENCH("calc_european_union_caqi", d, min_ns,
+        calc_european_union_caqi(HIST(s)));
+  BENCH("calc_hong_kong_aqhi",      d, min_ns, calc_hong_kong_aqhi(HIST(s)));
+  BENCH("calc_india_aqi",           d, min_ns, calc_india_aqi(HIST(s)));
+  BENCH("calc_singapore_psi",       d, min_ns, calc_singapore_psi(HIST(s)));
+  BENCH("calc_south_korea_cai",     d, min_ns, calc_south_korea_cai(HIST(s)));
+  BENCH("calc_united_kingdom_daqi", d, min_ns,
+        calc_united_kingdom_daqi(HIST(s)));
+  BENCH("calc_united_states_aqi",   d, min_ns,
+        calc_united_states_aqi(HIST(s)));
+
+  // calc_aqi() dispatch, cycling through every scale
+  BENCH("calc_aqi", d, min_ns,
+        calc_aqi((aqi_scale_t)(i % NUM_AQI_SCALES), HIST(s)));
+
+  // calc_aqi_batch() and calc_aqi_raster(), every sample per call
+  for (int scale = 0; scale < NUM_AQI_SCALES; ++scale)
+  {
+    snprintf(name, sizeof(name), "calc_aqi_batch_%s", SCALE_NAME[scale]);
+    BENCH_ALL(name, d, min_ns,
+              calc_aqi_batch((aqi_scale_t)scale, NUM_SAMPLES, &cols,
+                             batch_out));
+    snprintf(name, sizeof(name), "calc_aqi_raster_%s", SCALE_NAME[scale]);
+    BENCH_ALL(name, d, min_ns,
+              calc_aqi_raster((aqi_scale_t)scale, &raster, 23, 0,
+                              raster.rows, raster_out, RASTER_COLS));
+  }
+  sink = batch_out[0] + raster_out[0];
+
+  // descriptors of the values produced by each scale
+  for (int scale = 0; scale < NUM_AQI_SCALES; ++scale)
+  {
+    snprintf(name, sizeof(name), "%s_desc", SCALE_NAME[scale]);
+    BENCH(name, d, min_ns,
+          aqi_desc((aqi_scale_t)scale, s->aqi[scale])[0]);
+  }
+} // end bench_distribution
+
+int main(int argc, char *argv[])
+{
+  double min_ns = (argc > 1 ? atof(argv[1]) : 50) * 1e6;
+
+  printf("{\n  \"benchmark\": \"aqi_bench\",\n  \"samples\": %d,\n"
+         "  \"isa\": \"%s\",\n  \"results\": [", NUM_SAMPLES, aqi_isa());
+  for (int d = 0; d < NUM_DISTRIBUTIONS; ++d)
+  {
+    bench_distribution((distribution_t)d, min_ns);
+  }
+  printf("\n  ]\n}\n");
+  return 0;
+} // end main
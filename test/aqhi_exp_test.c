@@ -0,0 +1,284 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks that the fast_expf() paths of the Canada and Hong Kong AQHI never
+ * give a different index than the libm formula (canada_aqhi_exact() and
+ * hong_kong_aqhi_exact()). Sweeps a grid of concentrations, including negative,
+ * out of range and NaN values, through canada_aqhi(), hong_kong_aqhi() and the
+ * column kernel of every instruction set the CPU supports. A kernel lane may
+ * only be undecided (0), never wrong.
+ *
+ * Includes aqi.c to reach its kernels. Build and run from the repository root:
+ *   cc -O2 -I. test/aqhi_exp_test.c -lm -o aqhi_exp_test
+ *   ./aqhi_exp_test
+ *
+ * Exits with 0 if every index matches. Leave AQI_FORCE_ISA unset, as it limits
+ * the kernels checked.
+ */
+
+#include "aqi.c"
+
+#include <stdio.h>
+
+#define CHUNK 4096
+
+/* A chunk of grid points, one column per pollutant.
+ */
+typedef struct {
+  int   len;
+  float no2[CHUNK];
+  float o3[CHUNK];
+  float so2[CHUNK];
+  float pm10[CHUNK];
+  float pm2_5[CHUNK];
+} points_t;
+
+/* Counts of the points checked, failed, and left undecided by the kernels.
+ */
+typedef struct {
+  long points;
+  long failures;
+  long undecided[NUM_AQI_ISAS];
+} tally_t;
+
+static aqi_isa_t best_isa;
+
+static void report_failure(const char *scale, const char *path,
+                           const points_t *pts, int j, int got, int want)
+{
+  printf("%s %s: no2 %.9g o3 %.9g so2 %.9g pm10 %.9g pm2_5 %.9g: "
+         "%d, libm %d\n", scale, path, pts->no2[j], pts->o3[j], pts->so2[j],
+         pts->pm10[j], pts->pm2_5[j], got, want);
+} // end report_failure
+
+static void check_canada(const points_t *pts, tally_t *tally)
+{
+  int want[CHUNK];
+  int got[CHUNK];
+  for (int j = 0; j < pts->len; ++j)
+  {
+    want[j] = canada_aqhi_exact(pts->no2[j], pts->o3[j], pts->pm2_5[j]);
+    int aqhi = canada_aqhi(pts->no2[j], pts->o3[j], pts->pm2_5[j]);
+    if (aqhi != want[j] && tally->failures++ < 20)
+    {
+      report_failure("canada", "scalar", pts, j, aqhi, want[j]);
+    }
+  }
+  tally->points += pts->len;
+
+  for (int isa = 0; isa <= (int) best_isa; ++isa)
+  {
+    kernel_isa = (aqi_isa_t) isa;
+    canada_aqhi_column(pts->len, pts->no2, pts->o3, pts->pm2_5, got);
+    for (int j = 0; j < pts->len; ++j)
+    {
+      if (got[j] == 0)
+      {
+        ++tally->undecided[isa];
+      }
+      else if (got[j] != want[j] && tally->failures++ < 20)
+      {
+        report_failure("canada", AQI_ISA_NAMES[isa], pts, j, got[j], want[j]);
+      }
+    }
+  }
+  kernel_isa = best_isa;
+} // end check_canada
+
+static void check_hong_kong(const points_t *pts, tally_t *tally)
+{
+  int want[CHUNK];
+  int got[CHUNK];
+  for (int j = 0; j < pts->len; ++j)
+  {
+    want[j] = hong_kong_aqhi_exact(pts->no2[j], pts->o3[j], pts->so2[j],
+                                   pts->pm10[j], pts->pm2_5[j]);
+    int aqhi = hong_kong_aqhi(pts->no2[j], pts->o3[j], pts->so2[j],
+                              pts->pm10[j], pts->pm2_5[j]);
+    if (aqhi != want[j] && tally->failures++ < 20)
+    {
+      report_failure("hong kong", "scalar", pts, j, aqhi, want[j]);
+    }
+  }
+  tally->points += pts->len;
+
+  for (int isa = 0; isa <= (int) best_isa; ++isa)
+  {
+    kernel_isa = (aqi_isa_t) isa;
+    hong_kong_aqhi_column(pts->len, pts->no2, pts->o3, pts->so2, pts->pm10,
+                          pts->pm2_5, got);
+    for (int j = 0; j < pts->len; ++j)
+    {
+      if (got[j] == 0)
+      {
+        ++tally->undecided[isa];
+      }
+      else if (got[j] != want[j] && tally->failures++ < 20)
+      {
+        report_failure("hong kong", AQI_ISA_NAMES[isa], pts, j, got[j],
+                       want[j]);
+      }
+    }
+  }
+  kernel_isa = best_isa;
+} // end check_hong_kong
+
+/* Adds a point to the chunk, checking and emptying it once full.
+ */
+static void add_point(points_t *pts, tally_t *tally,
+                      void (*check)(const points_t *, tally_t *),
+                      float no2, float o3, float so2, float pm10, float pm2_5)
+{
+  pts->no2[pts->len]   = no2;
+  pts->o3[pts->len]    = o3;
+  pts->so2[pts->len]   = so2;
+  pts->pm10[pts->len]  = pm10;
+  pts->pm2_5[pts->len] = pm2_5;
+  if (++pts->len == CHUNK)
+  {
+    check(pts, tally);
+    pts->len = 0;
+  }
+} // end add_point
+
+static void flush_points(points_t *pts, tally_t *tally,
+                         void (*check)(const points_t *, tally_t *))
+{
+  if (pts->len > 0)
+  {
+    check(pts, tally);
+    pts->len = 0;
+  }
+} // end flush_points
+
+/* Values beyond the grid: negative, past AQI_FAST_EXP_MAX_ARG for every
+ * pollutant, infinite and NaN.
+ */
+static const float EDGE_VALUES[] = {
+  -1000.f, -0.5f, 0.f, 25000.f, 50000.f, 75000.f, 1e30f, INFINITY, NAN,
+};
+#define NUM_EDGE_VALUES ((int)(sizeof(EDGE_VALUES) / sizeof(EDGE_VALUES[0])))
+
+/* Sweeps no2, o3 and pm2_5 in steps that are not multiples of each other, so
+ * that their sum crosses each rounding boundary at many offsets.
+ */
+static void sweep_canada(points_t *pts, tally_t *tally)
+{
+  for (float no2 = 0; no2 < 2000; no2 += 2.3f)
+  {
+    for (float o3 = 0; o3 < 2000; o3 += 2.9f)
+    {
+      for (float pm2_5 = 0; pm2_5 < 1000; pm2_5 += 4.1f)
+      {
+        add_point(pts, tally, check_canada, no2, o3, 0, 0, pm2_5);
+      }
+    }
+  }
+
+  // each pollutant alone, finely
+  for (float c = 0; c < 20000; c += 0.01f)
+  {
+    add_point(pts, tally, check_canada, c, 0, 0, 0, 0);
+    add_point(pts, tally, check_canada, 0, c, 0, 0, 0);
+    add_point(pts, tally, check_canada, 0, 0, 0, 0, c);
+  }
+
+  for (int a = 0; a < NUM_EDGE_VALUES; ++a)
+  {
+    for (float c = 0; c < 2000; c += 0.37f)
+    {
+      add_point(pts, tally, check_canada, EDGE_VALUES[a], c, 0, 0, c);
+      add_point(pts, tally, check_canada, c, EDGE_VALUES[a], 0, 0, c);
+      add_point(pts, tally, check_canada, c, c, 0, 0, EDGE_VALUES[a]);
+    }
+  }
+  flush_points(pts, tally, check_canada);
+} // end sweep_canada
+
+/* Sweeps no2, o3 and so2 in steps that are not multiples of each other, with
+ * pm10 and pm2_5 taking turns as the larger of the two.
+ */
+static void sweep_hong_kong(points_t *pts, tally_t *tally)
+{
+  for (float no2 = 0; no2 < 1500; no2 += 11.3f)
+  {
+    for (float o3 = 0; o3 < 1000; o3 += 7.9f)
+    {
+      for (float so2 = 0; so2 < 2000; so2 += 23.1f)
+      {
+        for (float pm = 0; pm < 1500; pm += 61.3f)
+        {
+          add_point(pts, tally, check_hong_kong, no2, o3, so2, pm, pm * 0.6f);
+          add_point(pts, tally, check_hong_kong, no2, o3, so2, pm * 0.6f, pm);
+        }
+      }
+    }
+  }
+
+  // each pollutant alone, finely
+  for (float c = 0; c < 20000; c += 0.01f)
+  {
+    add_point(pts, tally, check_hong_kong, c, 0, 0, 0, 0);
+    add_point(pts, tally, check_hong_kong, 0, c, 0, 0, 0);
+    add_point(pts, tally, check_hong_kong, 0, 0, c, 0, 0);
+    add_point(pts, tally, check_hong_kong, 0, 0, 0, c, 0);
+    add_point(pts, tally, check_hong_kong, 0, 0, 0, 0, c);
+  }
+
+  for (int a = 0; a < NUM_EDGE_VALUES; ++a)
+  {
+    float e = EDGE_VALUES[a];
+    for (float c = 0; c < 2000; c += 0.37f)
+    {
+      add_point(pts, tally, check_hong_kong, e, c, c, c, c);
+      add_point(pts, tally, check_hong_kong, c, e, c, c, c);
+      add_point(pts, tally, check_hong_kong, c, c, e, c, c);
+      add_point(pts, tally, check_hong_kong, c, c, c, e, c);
+      add_point(pts, tally, check_hong_kong, c, c, c, c, e);
+    }
+  }
+  flush_points(pts, tally, check_hong_kong);
+} // end sweep_hong_kong
+
+static int print_tally(const char *scale, const tally_t *tally)
+{
+  printf("%s: %ld points, %ld failures; undecided lanes:", scale,
+         tally->points, tally->failures);
+  for (int isa = 0; isa <= (int) best_isa; ++isa)
+  {
+    printf(" %s %ld", AQI_ISA_NAMES[isa], tally->undecided[isa]);
+  }
+  printf("\n");
+  return tally->failures == 0;
+} // end print_tally
+
+int main(void)
+{
+  static points_t pts;
+  tally_t canada = { 0 };
+  tally_t hong_kong = { 0 };
+
+  best_isa = kernel_isa;
+  sweep_canada(&pts, &canada);
+  sweep_hong_kong(&pts, &hong_kong);
+
+  int ok = print_tally("canada", &canada);
+  ok &= print_tally("hong kong", &hong_kong);
+  return ok ? 0 : 1;
+} // end main
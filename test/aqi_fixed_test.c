@@ -0,0 +1,350 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks the AQI_FIXED_POINT functions against the float versions, over random
+ * concentrations: uniform over every band, realistic, and near round numbers
+ * (where exact ties are common). Every scale function is checked, and
+ * calc_aqi_fixed() with the same value in every hour.
+ *
+ * A result may only differ where the float version is decided by the rounding
+ * of its float arguments (see AQI_FIXED_POINT in aqi.h): moving one argument
+ * by at most FLOAT_ULPS units in the last place must give the fixed-point
+ * result. Any other difference is a failure.
+ *
+ * Build and run from the repository root:
+ *   cc -O2 -DAQI_FIXED_POINT -I. test/aqi_fixed_test.c aqi.c -lm -o aqi_fixed_test
+ *   ./aqi_fixed_test [iterations]
+ *
+ * Exits with 0 if every difference is explained.
+ */
+
+#include "aqi.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef AQI_FIXED_POINT
+#error "build with -DAQI_FIXED_POINT"
+#endif
+
+#define FLOAT_ULPS 8
+
+#define MAX_ARGS 10
+
+static const char *SCALE_NAME[NUM_AQI_SCALES] = {
+  "australia_aqi",
+  "canada_aqhi",
+  "china_aqi",
+  "european_union_caqi",
+  "hong_kong_aqhi",
+  "india_aqi",
+  "singapore_psi",
+  "south_korea_cai",
+  "united_kingdom_daqi",
+  "united_states_aqi",
+};
+
+/* Pollutant of each argument of the scale functions. Organized alphabetically
+ * (same order as aqi_scale_t enums).
+ */
+static const struct {
+  int             num_args;
+  aqi_pollutant_t arg[MAX_ARGS];
+} SCALE_ARGS[NUM_AQI_SCALES] = {
+  { 7, { POLLUTANT_CO, POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_O3,
+         POLLUTANT_SO2, POLLUTANT_PM10, POLLUTANT_PM2_5 } },
+  { 3, { POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_PM2_5 } },
+  { 10, { POLLUTANT_CO, POLLUTANT_CO, POLLUTANT_NO2, POLLUTANT_NO2,
+          POLLUTANT_O3, POLLUTANT_O3, POLLUTANT_SO2, POLLUTANT_SO2,
+          POLLUTANT_PM10, POLLUTANT_PM2_5 } },
+  { 4, { POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_PM10, POLLUTANT_PM2_5 } },
+  { 5, { POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_SO2, POLLUTANT_PM10,
+         POLLUTANT_PM2_5 } },
+  { 8, { POLLUTANT_CO, POLLUTANT_NH3, POLLUTANT_NO2, POLLUTANT_O3,
+         POLLUTANT_PB, POLLUTANT_SO2, POLLUTANT_PM10, POLLUTANT_PM2_5 } },
+  { 7, { POLLUTANT_CO, POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_O3,
+         POLLUTANT_SO2, POLLUTANT_PM10, POLLUTANT_PM2_5 } },
+  { 6, { POLLUTANT_CO, POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_SO2,
+         POLLUTANT_PM10, POLLUTANT_PM2_5 } },
+  { 5, { POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_SO2, POLLUTANT_PM10,
+         POLLUTANT_PM2_5 } },
+  { 8, { POLLUTANT_CO, POLLUTANT_NO2, POLLUTANT_O3, POLLUTANT_O3,
+         POLLUTANT_SO2, POLLUTANT_SO2, POLLUTANT_PM10, POLLUTANT_PM2_5 } },
+};
+
+static int scale_float(aqi_scale_t scale, const float c[])
+{
+  switch (scale)
+  {
+    case AUSTRALIA_AQI:
+      return australia_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+    case CANADA_AQHI:
+      return canada_aqhi(c[0], c[1], c[2]);
+    case CHINA_AQI:
+      return china_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8],
+                       c[9]);
+    case EUROPEAN_UNION_CAQI:
+      return european_union_caqi(c[0], c[1], c[2], c[3]);
+    case HONG_KONG_AQHI:
+      return hong_kong_aqhi(c[0], c[1], c[2], c[3], c[4]);
+    case INDIA_AQI:
+      return india_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]);
+    case SINGAPORE_PSI:
+      return singapore_psi(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+    case SOUTH_KOREA_CAI:
+      return south_korea_cai(c[0], c[1], c[2], c[3], c[4], c[5]);
+    case UNITED_KINGDOM_DAQI:
+      return united_kingdom_daqi(c[0], c[1], c[2], c[3], c[4]);
+    default:
+      return united_states_aqi(c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+                               c[7]);
+  }
+} // end scale_float
+
+static int scale_fixed(aqi_scale_t scale, const aqi_fixed_t c[])
+{
+  switch (scale)
+  {
+    case AUSTRALIA_AQI:
+      return australia_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+    case CANADA_AQHI:
+      return canada_aqhi_fixed(c[0], c[1], c[2]);
+    case CHINA_AQI:
+      return china_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7],
+                             c[8], c[9]);
+    case EUROPEAN_UNION_CAQI:
+      return european_union_caqi_fixed(c[0], c[1], c[2], c[3]);
+    case HONG_KONG_AQHI:
+      return hong_kong_aqhi_fixed(c[0], c[1], c[2], c[3], c[4]);
+    case INDIA_AQI:
+      return india_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]);
+    case SINGAPORE_PSI:
+      return singapore_psi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6]);
+    case SOUTH_KOREA_CAI:
+      return south_korea_cai_fixed(c[0], c[1], c[2], c[3], c[4], c[5]);
+    case UNITED_KINGDOM_DAQI:
+      return united_kingdom_daqi_fixed(c[0], c[1], c[2], c[3], c[4]);
+    default:
+      return united_states_aqi_fixed(c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+                                     c[7]);
+  }
+} // end scale_fixed
+
+/* Largest concentration sampled, in hundredths of a μg/m^3. Past the top band
+ * of every scale that uses the pollutant. Organized in the same order as
+ * aqi_pollutant_t enums.
+ */
+static const int32_t MAX_CONC[NUM_AQI_POLLUTANTS] = {
+  16000000, 200000, 50000, 400000, 130000, 400, 300000, 70000, 55000,
+};
+
+static uint64_t rng_state = 12345;
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (uint32_t)(rng_state >> 16);
+} // end rng
+
+static aqi_fixed_t sample(aqi_pollutant_t p, int mode)
+{
+  switch (mode)
+  {
+    case 0: // uniform over every band
+      return rng() % (MAX_CONC[p] + 1);
+    case 1: // realistic
+      return rng() % (MAX_CONC[p] / 20 + 1);
+    default: // a hundredth around multiples of 0.5
+      return (aqi_fixed_t)(rng() % 2000) * 50 + (int)(rng() % 3) - 1;
+  }
+} // end sample
+
+static float to_float(aqi_fixed_t c)
+{
+  return c / (float) AQI_FIXED_ONE;
+} // end to_float
+
+/* Returns whether moving one of the float arguments by at most FLOAT_ULPS
+ * units in the last place gives 'want'.
+ */
+static int float_decided(aqi_scale_t scale, const float c[], int want)
+{
+  float moved[MAX_ARGS];
+  for (int a = 0; a < SCALE_ARGS[scale].num_args; ++a)
+  {
+    moved[a] = c[a];
+  }
+  for (int a = 0; a < SCALE_ARGS[scale].num_args; ++a)
+  {
+    float up = c[a];
+    float down = c[a];
+    for (int u = 0; u < FLOAT_ULPS; ++u)
+    {
+      up = nextafterf(up, INFINITY);
+      down = nextafterf(down, -INFINITY);
+      moved[a] = up;
+      if (scale_float(scale, moved) == want)
+      {
+        return 1;
+      }
+      moved[a] = down;
+      if (scale_float(scale, moved) == want)
+      {
+        return 1;
+      }
+    }
+    moved[a] = c[a];
+  }
+  return 0;
+} // end float_decided
+
+/* Same as float_decided(), for calc_aqi() of constant hourly values.
+ */
+static int calc_float_decided(aqi_scale_t scale, float h[][24], int want)
+{
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    float c = h[p][0];
+    float up = c;
+    float down = c;
+    for (int u = 0; u < FLOAT_ULPS; ++u)
+    {
+      up = nextafterf(up, INFINITY);
+      down = nextafterf(down, -INFINITY);
+      float moved[2] = { up, down };
+      for (int m = 0; m < 2; ++m)
+      {
+        for (int t = 0; t < 24; ++t)
+        {
+          h[p][t] = moved[m];
+        }
+        int aqi = calc_aqi(scale, h[0], h[1], h[2], h[3], h[4], h[5], h[6],
+                           h[7], h[8]);
+        if (aqi == want)
+        {
+          for (int t = 0; t < 24; ++t)
+          {
+            h[p][t] = c;
+          }
+          return 1;
+        }
+      }
+    }
+    for (int t = 0; t < 24; ++t)
+    {
+      h[p][t] = c;
+    }
+  }
+  return 0;
+} // end calc_float_decided
+
+static void print_args(const aqi_fixed_t c[], int num_args)
+{
+  for (int a = 0; a < num_args; ++a)
+  {
+    printf(" %ld", (long) c[a]);
+  }
+  printf("\n");
+} // end print_args
+
+int main(int argc, char **argv)
+{
+  long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+  long differences[NUM_AQI_SCALES] = { 0 };
+  long failures[NUM_AQI_SCALES] = { 0 };
+
+  for (long it = 0; it < iterations; ++it)
+  {
+    int mode = (int)(it % 3);
+
+    // scale functions
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      aqi_fixed_t c[MAX_ARGS];
+      float f[MAX_ARGS];
+      for (int a = 0; a < SCALE_ARGS[s].num_args; ++a)
+      {
+        c[a] = sample(SCALE_ARGS[s].arg[a], mode);
+        f[a] = to_float(c[a]);
+      }
+      int want = scale_float((aqi_scale_t) s, f);
+      int got = scale_fixed((aqi_scale_t) s, c);
+      if (got == want)
+      {
+        continue;
+      }
+      ++differences[s];
+      if (!float_decided((aqi_scale_t) s, f, got) && failures[s]++ < 5)
+      {
+        printf("%s: fixed %d, float %d, args", SCALE_NAME[s], got, want);
+        print_args(c, SCALE_ARGS[s].num_args);
+      }
+    }
+
+    // calc_aqi_fixed(), the same value in every hour so both averages are
+    // exact
+    aqi_fixed_t hx[NUM_AQI_POLLUTANTS][24];
+    float hf[NUM_AQI_POLLUTANTS][24];
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      aqi_fixed_t c = sample((aqi_pollutant_t) p, mode);
+      for (int t = 0; t < 24; ++t)
+      {
+        hx[p][t] = c;
+        hf[p][t] = to_float(c);
+      }
+    }
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      int want = calc_aqi((aqi_scale_t) s, hf[0], hf[1], hf[2], hf[3], hf[4],
+                          hf[5], hf[6], hf[7], hf[8]);
+      int got = calc_aqi_fixed((aqi_scale_t) s, hx[0], hx[1], hx[2], hx[3],
+                               hx[4], hx[5], hx[6], hx[7], hx[8]);
+      if (got == want)
+      {
+        continue;
+      }
+      ++differences[s];
+      if (!calc_float_decided((aqi_scale_t) s, hf, got) && failures[s]++ < 5)
+      {
+        printf("calc_aqi_fixed %s: fixed %d, float %d, hourly",
+               SCALE_NAME[s], got, want);
+        aqi_fixed_t c[NUM_AQI_POLLUTANTS];
+        for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+        {
+          c[p] = hx[p][0];
+        }
+        print_args(c, NUM_AQI_POLLUTANTS);
+      }
+    }
+  }
+
+  long total = 0;
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
+  {
+    printf("%s: %ld float-decided differences, %ld failures\n",
+           SCALE_NAME[s], differences[s] - failures[s], failures[s]);
+    total += failures[s];
+  }
+  return total == 0 ? 0 : 1;
+} // end main
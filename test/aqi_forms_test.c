@@ -0,0 +1,1105 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks every input form of the library against per-station calc_aqi(), over
+ * rounds of random stations. Concentrations range past the top of every scale
+ * and include zeros, round numbers, negative values and NaN. Each round leaves
+ * out a random set of pollutants, as NULL for every station.
+ *
+ * Forms that keep running sums in double precision are documented to match
+ * calc_aqi() only up to the last bit of an average, so every other round holds
+ * exact samples: multiples of 0.25 without NaN, whose sums are exact in float
+ * and double alike. Those forms are checked on exact rounds only.
+ *
+ * Forms with vector kernels are checked on every instruction set the CPU
+ * supports, as are the descriptor categories of the results.
+ *
+ * Includes aqi.c to select its kernels. The *_parallel functions also run on
+ * thread pools when built with AQI_THREADS. Build and run from the repository
+ * root:
+ *   cc -O2 -DAQI_THREADS -I. test/aqi_forms_test.c -lm -pthread -o aqi_forms_test
+ *   ./aqi_forms_test [rounds]
+ *
+ * Exits with 0 if every result matches.
+ */
+
+#include "aqi.c"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Stations per round, not a multiple of any vector width so that every kernel
+ * also runs its tail.
+ */
+#define NUM_STATIONS 1003
+
+/* Concentration (μg/m^3) past the top of every scale, per pollutant. Ordered
+ * as aqi_pollutant_t.
+ */
+static const float CONC_MAX[NUM_AQI_POLLUTANTS] = {
+  60000, 2500, 1000, 4500, 1500, 5, 3500, 700, 600
+};
+
+// Hours in the long histories of a round
+#define SERIES_HOURS 2000
+
+typedef struct {
+  int   exact;
+  int   present[NUM_AQI_POLLUTANTS];
+  float hist[NUM_STATIONS][NUM_AQI_POLLUTANTS][24];
+  // the same samples as hour-major columns, as in aqi_columns_t
+  float col[NUM_AQI_POLLUTANTS][24 * NUM_STATIONS];
+  // calc_aqi() of each station
+  int   want[NUM_STATIONS][NUM_AQI_SCALES];
+  // one long history, and calc_aqi() of the 24 hours ending at each hour
+  float series[NUM_AQI_POLLUTANTS][SERIES_HOURS];
+  int   series_want[SERIES_HOURS][NUM_AQI_SCALES];
+} round_t;
+
+static round_t round_data;
+static aqi_isa_t best_isa;
+static long checks = 0;
+static long failures = 0;
+
+static unsigned long long rng_state = 0x9e3779b97f4a7c15ull;
+
+static float rand_unit(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (float)(rng_state >> 40) / (float)(1 << 24);
+} // end rand_unit
+
+static float rand_any_conc(int p)
+{
+  float u = rand_unit();
+  float c = rand_unit() * CONC_MAX[p];
+  if (u < 0.70f)
+  {
+    return c;
+  }
+  if (u < 0.80f)
+  {
+    return 0;
+  }
+  if (u < 0.93f)
+  {
+    // on an integer or a half, where breakpoints and rounding sit
+    return floorf(c) + (rand_unit() < 0.5f ? 0 : 0.5f);
+  }
+  if (u < 0.98f)
+  {
+    return -c / 100;
+  }
+  return NAN;
+} // end rand_any_conc
+
+static float rand_conc(int p, int exact)
+{
+  float c = rand_any_conc(p);
+  if (exact)
+  {
+    return c == c ? roundf(c * 4) / 4 : 0;
+  }
+  return c;
+} // end rand_conc
+
+/* Returns the samples of pollutant p at station i, or NULL if not available.
+ */
+static const float *station(const round_t *r, int i, int p)
+{
+  return r->present[p] ? r->hist[i][p] : NULL;
+} // end station
+
+#define STATION(r, i) \
+  station((r), (i), 0), station((r), (i), 1), station((r), (i), 2), \
+  station((r), (i), 3), station((r), (i), 4), station((r), (i), 5), \
+  station((r), (i), 6), station((r), (i), 7), station((r), (i), 8)
+
+/* Returns sample h of pollutant p at station i, or 0 if not available.
+ */
+static float sample(const round_t *r, int i, int p, int h)
+{
+  return r->present[p] ? r->hist[i][p][h] : 0;
+} // end sample
+
+/* Returns the long history of pollutant p from hour t on, or NULL if not
+ * available.
+ */
+static const float *series(const round_t *r, int p, int t)
+{
+  return r->present[p] ? r->series[p] + t : NULL;
+} // end series
+
+#define SERIES(r, t) \
+  series((r), 0, (t)), series((r), 1, (t)), series((r), 2, (t)), \
+  series((r), 3, (t)), series((r), 4, (t)), series((r), 5, (t)), \
+  series((r), 6, (t)), series((r), 7, (t)), series((r), 8, (t))
+
+static void generate(round_t *r, int all_present, int exact)
+{
+  r->exact = exact;
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    r->present[p] = all_present || rand_unit() < 0.75f;
+  }
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int h = 0; h < 24; ++h)
+      {
+        r->hist[i][p][h] = rand_conc(p, exact);
+        r->col[p][h * NUM_STATIONS + i] = r->hist[i][p][h];
+      }
+    }
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      r->want[i][s] = calc_aqi((aqi_scale_t) s, STATION(r, i));
+    }
+  }
+
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    for (int t = 0; t < SERIES_HOURS; ++t)
+    {
+      r->series[p][t] = rand_conc(p, exact);
+    }
+  }
+  for (int t = 23; t < SERIES_HOURS; ++t)
+  {
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      r->series_want[t][s] = calc_aqi((aqi_scale_t) s, SERIES(r, t - 23));
+    }
+  }
+} // end generate
+
+static void check(const char *form, int scale, int i, int got, int want)
+{
+  ++checks;
+  if (got != want && failures++ < 20)
+  {
+    printf("%s, scale %d, station %d: %d, calc_aqi() %d\n", form, scale, i,
+           got, want);
+  }
+} // end check
+
+/* Returns the columns of a round, NULL where a pollutant is not available.
+ */
+static aqi_columns_t columns(const round_t *r)
+{
+  const float *c[NUM_AQI_POLLUTANTS];
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    c[p] = r->present[p] ? r->col[p] : NULL;
+  }
+  aqi_columns_t in = { c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8] };
+  return in;
+} // end columns
+
+/* calc_aqi_batch() on every instruction set.
+ */
+static void check_batch(const round_t *r)
+{
+  static int out[NUM_STATIONS];
+  char form[64];
+  const aqi_columns_t in = columns(r);
+  for (int isa = 0; isa <= (int) best_isa; ++isa)
+  {
+    kernel_isa = (aqi_isa_t) isa;
+    snprintf(form, sizeof(form), "calc_aqi_batch %s", AQI_ISA_NAMES[isa]);
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      calc_aqi_batch((aqi_scale_t) s, NUM_STATIONS, &in, out);
+      for (int i = 0; i < NUM_STATIONS; ++i)
+      {
+        check(form, s, i, out[i], r->want[i][s]);
+      }
+    }
+  }
+  kernel_isa = best_isa;
+} // end check_batch
+
+/* The stations of a round as the cells of a raster of RASTER_ROWS x
+ * RASTER_COLS, with padding at the end of every row and plane and two hours
+ * of NaN before the 24 of the stations.
+ */
+#define RASTER_ROWS         17
+#define RASTER_COLS         59
+#define RASTER_ROW_STRIDE   (RASTER_COLS + 5)
+#define RASTER_PLANE_STRIDE (RASTER_ROWS * RASTER_ROW_STRIDE + 7)
+#define RASTER_HOURS        26
+#define RASTER_OUT_STRIDE   (RASTER_COLS + 3)
+
+static float raster_data[NUM_AQI_POLLUTANTS]
+                        [RASTER_HOURS * RASTER_PLANE_STRIDE];
+
+/* Returns 'value' saturated to the range of int16_t.
+ */
+static int saturate(int value)
+{
+  return value < INT16_MIN ? INT16_MIN
+                           : value > INT16_MAX ? INT16_MAX : value;
+} // end saturate
+
+/* Checks the cells of rows [row_begin, row_end) of 'out' against 'want' and
+ * that the padding at the end of each row is untouched.
+ */
+static void check_raster_rows(const char *form, int scale, const int16_t *out,
+                              size_t row_begin, size_t row_end,
+                              const int (*want)[NUM_AQI_SCALES])
+{
+  for (size_t rr = row_begin; rr < row_end; ++rr)
+  {
+    for (size_t cc = 0; cc < RASTER_OUT_STRIDE; ++cc)
+    {
+      int i = (int)(rr * RASTER_COLS + cc);
+      check(form, scale, i, out[rr * RASTER_OUT_STRIDE + cc],
+            cc < RASTER_COLS ? saturate(want[i][scale]) : -1);
+    }
+  }
+} // end check_raster_rows
+
+/* Lays the stations of a round out in raster_data and returns the raster, NULL
+ * where a pollutant is not available.
+ */
+static aqi_raster_t raster(const round_t *r)
+{
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    for (size_t k = 0; k < RASTER_HOURS * RASTER_PLANE_STRIDE; ++k)
+    {
+      raster_data[p][k] = NAN;
+    }
+    for (int i = 0; i < NUM_STATIONS; ++i)
+    {
+      for (int h = 0; h < 24; ++h)
+      {
+        raster_data[p][(h + RASTER_HOURS - 24) * RASTER_PLANE_STRIDE
+                       + i / RASTER_COLS * RASTER_ROW_STRIDE
+                       + i % RASTER_COLS] = r->hist[i][p][h];
+      }
+    }
+  }
+  const float *x[NUM_AQI_POLLUTANTS];
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    x[p] = r->present[p] ? raster_data[p] : NULL;
+  }
+  const aqi_raster_t in = {
+    x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8],
+    RASTER_ROWS, RASTER_COLS, RASTER_ROW_STRIDE, RASTER_PLANE_STRIDE
+  };
+  return in;
+} // end raster
+
+/* calc_aqi_raster() on every instruction set, over all rows at once and split
+ * at a different row per scale.
+ */
+static void check_raster(const round_t *r)
+{
+  static int16_t out[RASTER_ROWS * RASTER_OUT_STRIDE];
+  char form[64];
+  const aqi_raster_t in = raster(r);
+  for (int isa = 0; isa <= (int) best_isa; ++isa)
+  {
+    kernel_isa = (aqi_isa_t) isa;
+    snprintf(form, sizeof(form), "calc_aqi_raster %s", AQI_ISA_NAMES[isa]);
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      size_t split = (size_t) s % RASTER_ROWS;
+      for (size_t k = 0; k < RASTER_ROWS * RASTER_OUT_STRIDE; ++k)
+      {
+        out[k] = -1;
+      }
+      calc_aqi_raster((aqi_scale_t) s, &in, RASTER_HOURS - 1, 0,
+                      RASTER_ROWS, out, RASTER_OUT_STRIDE);
+      check_raster_rows(form, s, out, 0, RASTER_ROWS, r->want);
+
+      for (size_t k = 0; k < RASTER_ROWS * RASTER_OUT_STRIDE; ++k)
+      {
+        out[k] = -1;
+      }
+      calc_aqi_raster((aqi_scale_t) s, &in, RASTER_HOURS - 1, split,
+                      RASTER_ROWS, out, RASTER_OUT_STRIDE);
+      calc_aqi_raster((aqi_scale_t) s, &in, RASTER_HOURS - 1, 0, split, out,
+                      RASTER_OUT_STRIDE);
+      check_raster_rows(form, s, out, 0, RASTER_ROWS, r->want);
+    }
+  }
+  kernel_isa = best_isa;
+} // end check_raster
+
+/* calc_aqi_raster() of the unbounded scales on a single row of concentrations
+ * growing far past the range of int16_t, on every instruction set.
+ */
+static void check_raster_saturation(void)
+{
+  enum { CELLS = 45 };
+  static float x[NUM_AQI_POLLUTANTS][24 * CELLS];
+  static int want[CELLS][NUM_AQI_SCALES];
+  int16_t out[CELLS];
+  const aqi_scale_t SCALES[] = { AUSTRALIA_AQI, CANADA_AQHI };
+  char form[64];
+
+  for (int c = 0; c < CELLS; ++c)
+  {
+    float conc = powf(10, c / 5.f);
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int h = 0; h < 24; ++h)
+      {
+        x[p][h * CELLS + c] = conc;
+      }
+    }
+    float station[24];
+    for (int h = 0; h < 24; ++h)
+    {
+      station[h] = conc;
+    }
+    for (int k = 0; k < 2; ++k)
+    {
+      want[c][SCALES[k]] = calc_aqi(SCALES[k], station, station, station,
+                                    station, station, station, station,
+                                    station, station);
+    }
+  }
+  const aqi_raster_t in = {
+    x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8],
+    1, CELLS, CELLS, CELLS
+  };
+
+  for (int isa = 0; isa <= (int) best_isa; ++isa)
+  {
+    kernel_isa = (aqi_isa_t) isa;
+    snprintf(form, sizeof(form), "calc_aqi_raster saturated %s",
+             AQI_ISA_NAMES[isa]);
+    for (int k = 0; k < 2; ++k)
+    {
+      calc_aqi_raster(SCALES[k], &in, 23, 0, 1, out, CELLS);
+      for (int c = 0; c < CELLS; ++c)
+      {
+        check(form, SCALES[k], c, out[c], saturate(want[c][SCALES[k]]));
+      }
+    }
+  }
+  kernel_isa = best_isa;
+} // end check_raster_saturation
+
+/* Runs the tasks of a call in reverse order on the calling thread.
+ */
+static void run_reversed(void *ctx, size_t count, aqi_task_fn task, void *arg)
+{
+  (void) ctx;
+  for (size_t k = count; k-- > 0;)
+  {
+    task(arg, k);
+  }
+} // end run_reversed
+
+/* calc_aqi_batch_parallel() and calc_aqi_raster_parallel() with the given
+ * executor.
+ */
+static void check_executor(const round_t *r, const char *name,
+                           const aqi_executor_t *executor)
+{
+  static int out[NUM_STATIONS];
+  static int16_t raster_out[RASTER_ROWS * RASTER_OUT_STRIDE];
+  char form[64];
+  const aqi_columns_t in = columns(r);
+  const aqi_raster_t raster_in = raster(r);
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
+  {
+    snprintf(form, sizeof(form), "calc_aqi_batch_parallel %s", name);
+    calc_aqi_batch_parallel((aqi_scale_t) s, NUM_STATIONS, &in, out,
+                            executor);
+    for (int i = 0; i < NUM_STATIONS; ++i)
+    {
+      check(form, s, i, out[i], r->want[i][s]);
+    }
+
+    snprintf(form, sizeof(form), "calc_aqi_raster_parallel %s", name);
+    for (size_t k = 0; k < RASTER_ROWS * RASTER_OUT_STRIDE; ++k)
+    {
+      raster_out[k] = -1;
+    }
+    calc_aqi_raster_parallel((aqi_scale_t) s, &raster_in, RASTER_HOURS - 1,
+                             raster_out, RASTER_OUT_STRIDE, executor);
+    check_raster_rows(form, s, raster_out, 0, RASTER_ROWS, r->want);
+  }
+} // end check_executor
+
+/* The *_parallel functions on the calling thread, with tasks run in reverse
+ * order, and with AQI_THREADS on pools of 1, 2, 4 and 8 threads.
+ */
+static void check_parallel(const round_t *r)
+{
+  const aqi_executor_t reversed = { run_reversed, NULL };
+  check_executor(r, "NULL", NULL);
+  check_executor(r, "reversed", &reversed);
+
+#ifdef AQI_THREADS
+  static aqi_pool_t pool;
+  char name[64];
+  for (int threads = 1; threads <= 8; threads *= 2)
+  {
+    int started = aqi_pool_init(&pool, threads);
+    const aqi_executor_t executor = aqi_pool_executor(&pool);
+    snprintf(name, sizeof(name), "pool of %d of %d threads", started,
+             threads);
+    check_executor(r, name, &executor);
+    aqi_pool_destroy(&pool);
+  }
+#endif
+} // end check_parallel
+
+static void check_all(const round_t *r)
+{
+  int aqi[NUM_AQI_SCALES];
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    calc_aqi_all(STATION(r, i), aqi);
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      check("calc_aqi_all", s, i, aqi[s], r->want[i][s]);
+    }
+  }
+} // end check_all
+
+/* calc_aqi_mixed() on every instruction set, with a random scale per station
+ * and with one scale for every station.
+ */
+static void check_mixed(const round_t *r)
+{
+  static aqi_scale_t scales[NUM_STATIONS];
+  static int out[NUM_STATIONS];
+  char form[64];
+  const aqi_columns_t in = columns(r);
+  void *scratch = malloc(calc_aqi_mixed_scratch_size(NUM_STATIONS));
+  calc_aqi_mixed(0, scales, &in, out, scratch);
+  for (int isa = 0; isa <= (int) best_isa; ++isa)
+  {
+    kernel_isa = (aqi_isa_t) isa;
+    snprintf(form, sizeof(form), "calc_aqi_mixed %s", AQI_ISA_NAMES[isa]);
+    for (int k = 0; k <= NUM_AQI_SCALES; ++k)
+    {
+      for (int i = 0; i < NUM_STATIONS; ++i)
+      {
+        scales[i] = (aqi_scale_t)(k < NUM_AQI_SCALES
+                                  ? k : (int)(rand_unit() * NUM_AQI_SCALES));
+      }
+      calc_aqi_mixed(NUM_STATIONS, scales, &in, out, scratch);
+      for (int i = 0; i < NUM_STATIONS; ++i)
+      {
+        check(form, scales[i], i, out[i], r->want[i][scales[i]]);
+      }
+    }
+  }
+  kernel_isa = best_isa;
+  free(scratch);
+} // end check_mixed
+
+/* A record of a ring buffer, as a station might keep them.
+ */
+typedef struct {
+  long  time;
+  float conc[NUM_AQI_POLLUTANTS];
+} record_t;
+
+#define MAX_CAPACITY 48
+
+/* calc_aqi_view(), calc_aqi_all_view() and avg_conc_view() of each station,
+ * read from a ring buffer of records whose capacity and head vary by station,
+ * and from AQI_VIEW_ARRAY() of its arrays.
+ */
+static void check_views(const round_t *r)
+{
+  record_t ring[MAX_CAPACITY];
+  aqi_view_t view[NUM_AQI_POLLUTANTS], array[NUM_AQI_POLLUTANTS];
+  const aqi_view_t *v[NUM_AQI_POLLUTANTS], *a[NUM_AQI_POLLUTANTS];
+  int all[NUM_AQI_SCALES];
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    size_t capacity = 24 + i % (MAX_CAPACITY - 23);
+    size_t head = (size_t) i % capacity;
+    for (size_t k = 0; k < capacity; ++k)
+    {
+      ring[k].time = -1;
+      for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+      {
+        ring[k].conc[p] = NAN;
+      }
+    }
+    for (int h = 0; h < 24; ++h)
+    {
+      record_t *rec = &ring[(head + capacity - (23 - h)) % capacity];
+      rec->time = h;
+      for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+      {
+        rec->conc[p] = r->hist[i][p][h];
+      }
+    }
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      view[p] = (aqi_view_t){ &ring[0].conc[p], head, capacity,
+                              sizeof(record_t) };
+      array[p] = AQI_VIEW_ARRAY(r->hist[i][p]);
+      v[p] = r->present[p] ? &view[p] : NULL;
+      a[p] = r->present[p] ? &array[p] : NULL;
+    }
+
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      check("calc_aqi_view", s, i,
+            calc_aqi_view((aqi_scale_t) s, v[0], v[1], v[2], v[3], v[4], v[5],
+                          v[6], v[7], v[8]), r->want[i][s]);
+      check("calc_aqi_view of arrays", s, i,
+            calc_aqi_view((aqi_scale_t) s, a[0], a[1], a[2], a[3], a[4], a[5],
+                          a[6], a[7], a[8]), r->want[i][s]);
+    }
+    calc_aqi_all_view(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
+                      all);
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      check("calc_aqi_all_view", s, i, all[s], r->want[i][s]);
+    }
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int hours = 1; hours <= 24; ++hours)
+      {
+        float want = avg_conc(station(r, i, p), hours);
+        float got = avg_conc_view(v[p], hours);
+        ++checks;
+        // NaN samples give NaN averages either way
+        if (got != want && !(got != got && want != want) && failures++ < 20)
+        {
+          printf("avg_conc_view, pollutant %d, %d hours, station %d: %.9g, "
+                 "avg_conc() %.9g\n", p, hours, i, got, want);
+        }
+      }
+    }
+  }
+} // end check_views
+
+/* calc_aqi_n() and avg_conc_n() at every hour of the long history, and on exact
+ * rounds calc_aqi_series() over all of it.
+ */
+static void check_series(const round_t *r)
+{
+  static int out[SERIES_HOURS];
+  for (int t = 23; t < SERIES_HOURS; ++t)
+  {
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      check("calc_aqi_n", s, t,
+            calc_aqi_n((aqi_scale_t) s, (size_t) t + 1, SERIES(r, 0)),
+            r->series_want[t][s]);
+    }
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      int hours = 1 + t % 24;
+      float want = avg_conc(series(r, p, t - 23), hours);
+      float got = avg_conc_n(series(r, p, 0), (size_t) t + 1, hours);
+      ++checks;
+      if (got != want && !(got != got && want != want) && failures++ < 20)
+      {
+        printf("avg_conc_n, pollutant %d, %d hours, hour %d: %.9g, "
+               "avg_conc() %.9g\n", p, hours, t, got, want);
+      }
+    }
+  }
+
+  if (!r->exact)
+  {
+    return;
+  }
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
+  {
+    out[0] = -1;
+    calc_aqi_series((aqi_scale_t) s, 23, SERIES(r, 0), out);
+    check("calc_aqi_series of 23 hours", s, 0, out[0], -1);
+    calc_aqi_series((aqi_scale_t) s, SERIES_HOURS, SERIES(r, 0), out);
+    for (int t = 23; t < SERIES_HOURS; ++t)
+    {
+      check("calc_aqi_series", s, t, out[t - 23], r->series_want[t][s]);
+    }
+  }
+} // end check_series
+
+/* calc_aqi_prefix() and aqi_prefix_avg() at every hour of the long history.
+ */
+static void check_prefix(const round_t *r)
+{
+  static double sum[NUM_AQI_POLLUTANTS][SERIES_HOURS + 1];
+  aqi_prefix_t prefix[NUM_AQI_POLLUTANTS];
+  const aqi_prefix_t *x[NUM_AQI_POLLUTANTS];
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    aqi_prefix_build(&prefix[p], sum[p], r->series[p], SERIES_HOURS);
+    x[p] = r->present[p] ? &prefix[p] : NULL;
+  }
+
+  for (int t = 23; t < SERIES_HOURS; ++t)
+  {
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      check("calc_aqi_prefix", s, t,
+            calc_aqi_prefix((aqi_scale_t) s, (size_t) t, x[0], x[1], x[2],
+                            x[3], x[4], x[5], x[6], x[7], x[8]),
+            r->series_want[t][s]);
+    }
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      int hours = 1 + t % 24;
+      float want = avg_conc(series(r, p, t - 23), hours);
+      float got = aqi_prefix_avg(x[p], (size_t) t, hours);
+      ++checks;
+      if (got != want && failures++ < 20)
+      {
+        printf("aqi_prefix_avg, pollutant %d, %d hours, hour %d: %.9g, "
+               "avg_conc() %.9g\n", p, hours, t, got, want);
+      }
+    }
+  }
+} // end check_prefix
+
+/* Added to the samples of minute m of each hour. The offsets of an hour sum to
+ * 0 and are exact in float, but the last 15 minutes of the hour are 24 above
+ * its mean.
+ */
+static float minute_offset(int m)
+{
+  return m < 45 ? -8.f : 24.f;
+} // end minute_offset
+
+/* aqi_minute_state_eval() of every tenth station, after pushing a different
+ * number of earlier minutes. The samples of the station are divided by 8, into
+ * the ranges where the United Kingdom DAQI is not yet at its top, and each
+ * hour is spread over 60 minutes that vary within the hour but average to it.
+ * So every window of whole hours matches calc_aqi(), while the United Kingdom
+ * DAQI takes the true 15 minute mean of so2.
+ */
+static void check_minute_state(const round_t *r)
+{
+  static aqi_minute_state_t state;
+  float hist[NUM_AQI_POLLUTANTS][24];
+  const float *x[NUM_AQI_POLLUTANTS];
+  float conc[NUM_AQI_POLLUTANTS];
+  for (int i = 0; i < NUM_STATIONS; i += 10)
+  {
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int h = 0; h < 24; ++h)
+      {
+        hist[p][h] = sample(r, i, p, h) / 8;
+      }
+      x[p] = r->present[p] ? hist[p] : NULL;
+    }
+
+    aqi_minute_state_init(&state);
+    for (int m = 0; m < i; ++m)
+    {
+      aqi_push_minute(&state, rand_conc(0, 1), rand_conc(1, 1),
+                      rand_conc(2, 1), rand_conc(3, 1), rand_conc(4, 1),
+                      rand_conc(5, 1), rand_conc(6, 1), rand_conc(7, 1),
+                      rand_conc(8, 1));
+    }
+    for (int m = 0; m < AQI_MINUTES_PER_DAY; ++m)
+    {
+      for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+      {
+        conc[p] = x[p] ? hist[p][m / 60] + minute_offset(m % 60) : 0;
+      }
+      aqi_push_minute(&state, conc[0], conc[1], conc[2], conc[3], conc[4],
+                      conc[5], conc[6], conc[7], conc[8]);
+    }
+
+    // the last 15 minutes are 45..59 of the last hour
+    float so2_15min = x[POLLUTANT_SO2] ? hist[POLLUTANT_SO2][23]
+                                         + minute_offset(45) : 0;
+    float so2 = aqi_minute_state_avg(&state, POLLUTANT_SO2, 15);
+    ++checks;
+    if (so2 != so2_15min && failures++ < 20)
+    {
+      printf("aqi_minute_state_avg, 15 minutes, station %d: %.9g, mean "
+             "%.9g\n", i, so2, so2_15min);
+    }
+
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      int want = s == UNITED_KINGDOM_DAQI
+        ? united_kingdom_daqi(avg_conc(x[POLLUTANT_NO2], 1),
+                              avg_conc(x[POLLUTANT_O3], 8), so2_15min,
+                              avg_conc(x[POLLUTANT_PM10], 24),
+                              avg_conc(x[POLLUTANT_PM2_5], 24))
+        : calc_aqi((aqi_scale_t) s, x[0], x[1], x[2], x[3], x[4], x[5], x[6],
+                   x[7], x[8]);
+      check("aqi_minute_state_eval", s, i,
+            aqi_minute_state_eval(&state, (aqi_scale_t) s), want);
+    }
+  }
+} // end check_minute_state
+
+/* The average of the valid hours in the window, or 0 if fewer than 75% of them
+ * are valid, summed in the same order as avg_conc().
+ */
+static float masked_reference(const float pollutant[24], uint32_t valid,
+                              int hours)
+{
+  if (pollutant == NULL)
+  {
+    return 0;
+  }
+  float sum = 0;
+  int n = 0;
+  for (int h = 24 - hours; h < 24; ++h)
+  {
+    if (valid & ((uint32_t) 1 << h))
+    {
+      sum += pollutant[h];
+      ++n;
+    }
+  }
+  return 4 * n < 3 * hours ? 0 : sum / (float) n;
+} // end masked_reference
+
+typedef struct {
+  const float *pollutant[NUM_AQI_POLLUTANTS];
+  uint32_t     valid[NUM_AQI_POLLUTANTS];
+} masked_reference_t;
+
+static float masked_reference_avg(const void *src, const aqi_window_t *window)
+{
+  const masked_reference_t *m = src;
+  return masked_reference(m->pollutant[window->pollutant],
+                          m->valid[window->pollutant], window_hours(window));
+} // end masked_reference_avg
+
+/* calc_aqi_masked() of each station against calc_aqi() with every hour valid,
+ * and with random masks against the windows of each scale taken by
+ * masked_reference(). avg_conc_masked() is checked against masked_reference()
+ * on every window length.
+ */
+static void check_masked(const round_t *r)
+{
+  static const uint32_t ALL_VALID[NUM_AQI_POLLUTANTS] = {
+    AQI_ALL_VALID, AQI_ALL_VALID, AQI_ALL_VALID, AQI_ALL_VALID, AQI_ALL_VALID,
+    AQI_ALL_VALID, AQI_ALL_VALID, AQI_ALL_VALID, AQI_ALL_VALID
+  };
+  masked_reference_t m;
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      m.pollutant[p] = station(r, i, p);
+      m.valid[p] = AQI_ALL_VALID;
+      // a third of the masks have every hour valid, a few have none
+      float u = rand_unit();
+      for (int h = 0; h < 24 && u > 0.33f; ++h)
+      {
+        if (u > 0.95f || rand_unit() < 0.15f)
+        {
+          m.valid[p] &= ~((uint32_t) 1 << h);
+        }
+      }
+    }
+
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      check("calc_aqi_masked, NULL", s, i,
+            calc_aqi_masked((aqi_scale_t) s, STATION(r, i), NULL),
+            r->want[i][s]);
+      check("calc_aqi_masked, all valid", s, i,
+            calc_aqi_masked((aqi_scale_t) s, STATION(r, i), ALL_VALID),
+            r->want[i][s]);
+      check("calc_aqi_masked", s, i,
+            calc_aqi_masked((aqi_scale_t) s, STATION(r, i), m.valid),
+            eval_scale((aqi_scale_t) s, masked_reference_avg, &m, NULL));
+    }
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int hours = 1; hours <= 24; ++hours)
+      {
+        float want = masked_reference(m.pollutant[p], m.valid[p], hours);
+        float got = avg_conc_masked(m.pollutant[p], m.valid[p], hours);
+        ++checks;
+        if (got != want && !(got != got && want != want) && failures++ < 20)
+        {
+          printf("avg_conc_masked, pollutant %d, %d hours, station %d: %.9g, "
+                 "reference %.9g\n", p, hours, i, got, want);
+        }
+      }
+    }
+  }
+} // end check_masked
+
+/* The NowCast of 12 hours, least recent first, computed in double precision
+ * straight from its definition in aqi.h.
+ */
+static double nowcast_reference(const float c[AQI_NOWCAST_HOURS])
+{
+  int recent = 0;
+  for (int h = AQI_NOWCAST_HOURS - 3; h < AQI_NOWCAST_HOURS; ++h)
+  {
+    recent += c[h] == c[h];
+  }
+  if (recent < 2)
+  {
+    return NAN;
+  }
+
+  double c_min = INFINITY;
+  double c_max = -INFINITY;
+  for (int h = 0; h < AQI_NOWCAST_HOURS; ++h)
+  {
+    if (c[h] == c[h])
+    {
+      c_min = fmin(c_min, c[h]);
+      c_max = fmax(c_max, c[h]);
+    }
+  }
+  double w = fmax(c_max > 0 ? c_min / c_max : 1, 0.5);
+
+  double num = 0;
+  double den = 0;
+  for (int i = 1; i <= AQI_NOWCAST_HOURS; ++i)
+  {
+    double ci = c[AQI_NOWCAST_HOURS - i];
+    if (ci == ci)
+    {
+      num += pow(w, i - 1) * ci;
+      den += pow(w, i - 1);
+    }
+  }
+  return num / den;
+} // end nowcast_reference
+
+/* nowcast_conc() against its definition, aqi_nowcast_value() against
+ * nowcast_conc() after pushing a different number of earlier hours per
+ * station, and on exact rounds aqi_state_eval_nowcast() against
+ * calc_united_states_aqi_nowcast(). A quarter of the particulate samples are
+ * taken out as NaN so that the NowCast is often not available.
+ */
+static void check_nowcast(const round_t *r)
+{
+  float pm[2][24];
+  aqi_nowcast_t nowcast[2];
+  aqi_state_t state;
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    for (int k = 0; k < 2; ++k)
+    {
+      int p = k == 0 ? POLLUTANT_PM10 : POLLUTANT_PM2_5;
+      aqi_nowcast_init(&nowcast[k]);
+      for (int h = 0; h < i % 30; ++h)
+      {
+        aqi_nowcast_push(&nowcast[k], rand_conc(p, 0));
+      }
+      for (int h = 0; h < 24; ++h)
+      {
+        pm[k][h] = rand_unit() < 0.25f ? NAN : r->hist[i][p][h];
+        aqi_nowcast_push(&nowcast[k], pm[k][h]);
+      }
+
+      double want = nowcast_reference(pm[k] + 24 - AQI_NOWCAST_HOURS);
+      float got = nowcast_conc(pm[k]);
+      ++checks;
+      if (!(fabs(got - want) <= 1e-5 * fabs(want) + 1e-6)
+          && !(got != got && want != want) && failures++ < 20)
+      {
+        printf("nowcast_conc, station %d: %.9g, definition %.9g\n", i, got,
+               want);
+      }
+      float value = aqi_nowcast_value(&nowcast[k]);
+      ++checks;
+      if (value != got && !(value != value && got != got) && failures++ < 20)
+      {
+        printf("aqi_nowcast_value, station %d: %.9g, nowcast_conc() %.9g\n",
+               i, value, got);
+      }
+    }
+
+    if (!r->exact)
+    {
+      continue;
+    }
+    const float *pm10 = r->present[POLLUTANT_PM10] ? pm[0] : NULL;
+    const float *pm2_5 = r->present[POLLUTANT_PM2_5] ? pm[1] : NULL;
+    aqi_state_init(&state);
+    for (int h = 0; h < 24; ++h)
+    {
+      aqi_push_hour(&state, sample(r, i, 0, h), sample(r, i, 1, h),
+                    sample(r, i, 2, h), sample(r, i, 3, h),
+                    sample(r, i, 4, h), sample(r, i, 5, h),
+                    sample(r, i, 6, h), 0, 0);
+    }
+    check("aqi_state_eval_nowcast", UNITED_STATES_AQI, i,
+          aqi_state_eval_nowcast(&state, pm10 ? &nowcast[0] : NULL,
+                                 pm2_5 ? &nowcast[1] : NULL),
+          calc_united_states_aqi_nowcast(station(r, i, 0), station(r, i, 1),
+                                         station(r, i, 2), station(r, i, 3),
+                                         station(r, i, 4), station(r, i, 5),
+                                         station(r, i, 6), pm10, pm2_5));
+  }
+} // end check_nowcast
+
+/* aqi_state_eval() and aqi_state_avg() of each station, after pushing a
+ * different number of earlier hours so that the ring buffer starts at every
+ * slot and its sums have been recomputed.
+ */
+static void check_state(const round_t *r)
+{
+  static const int HOURS[] = { 1, 3, 4, 8, 24 };
+  aqi_state_t state;
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    aqi_state_init(&state);
+    for (int k = 0; k < i % 50; ++k)
+    {
+      aqi_push_hour(&state, rand_conc(0, 1), rand_conc(1, 1), rand_conc(2, 1),
+                    rand_conc(3, 1), rand_conc(4, 1), rand_conc(5, 1),
+                    rand_conc(6, 1), rand_conc(7, 1), rand_conc(8, 1));
+    }
+    for (int h = 0; h < 24; ++h)
+    {
+      aqi_push_hour(&state, sample(r, i, 0, h), sample(r, i, 1, h),
+                    sample(r, i, 2, h), sample(r, i, 3, h),
+                    sample(r, i, 4, h), sample(r, i, 5, h),
+                    sample(r, i, 6, h), sample(r, i, 7, h),
+                    sample(r, i, 8, h));
+    }
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      check("aqi_state_eval", s, i, aqi_state_eval(&state, (aqi_scale_t) s),
+            r->want[i][s]);
+    }
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      for (int w = 0; w < 5; ++w)
+      {
+        float want = avg_conc(station(r, i, p), HOURS[w]);
+        float got = aqi_state_avg(&state, (aqi_pollutant_t) p, HOURS[w]);
+        ++checks;
+        if (got != want && failures++ < 20)
+        {
+          printf("aqi_state_avg, pollutant %d, %d hours, station %d: %.9g, "
+                 "avg_conc() %.9g\n", p, HOURS[w], i, got, want);
+        }
+      }
+    }
+  }
+} // end check_state
+
+/* Values for check_categories(): a sweep from below 0 to past the top of every
+ * scale, and the extremes of int.
+ */
+#define NUM_SWEEP_VALUES 1200
+
+/* aqi_category() against aqi_desc(), and aqi_category_batch() on every
+ * instruction set against aqi_category(), on the index values of a round and
+ * on a sweep. aqi_category_desc() of a category outside the scale is NULL.
+ */
+static void check_categories(const round_t *r)
+{
+  static int values[NUM_STATIONS + NUM_SWEEP_VALUES];
+  static uint8_t out[NUM_STATIONS + NUM_SWEEP_VALUES];
+  const int n = NUM_STATIONS + NUM_SWEEP_VALUES;
+  char form[64];
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
+  {
+    const aqi_scale_t scale = (aqi_scale_t) s;
+    for (int i = 0; i < NUM_STATIONS; ++i)
+    {
+      values[i] = r->want[i][s];
+    }
+    for (int k = 0; k < NUM_SWEEP_VALUES; ++k)
+    {
+      values[NUM_STATIONS + k] = k - 100;
+    }
+    values[n - 2] = INT_MIN;
+    values[n - 1] = INT_MAX;
+
+    int num_categories = aqi_num_categories(scale);
+    for (int i = 0; i < n; ++i)
+    {
+      int category = aqi_category(scale, values[i]);
+      const char *desc = aqi_category_desc(scale, category);
+      ++checks;
+      if ((category < 0 || category >= num_categories || desc == NULL
+           || strcmp(desc, aqi_desc(scale, values[i])) != 0)
+          && failures++ < 20)
+      {
+        printf("aqi_category, scale %d, value %d: category %d, aqi_desc() "
+               "%s\n", s, values[i], category, aqi_desc(scale, values[i]));
+      }
+    }
+    check("aqi_category_desc below 0", s, -1,
+          aqi_category_desc(scale, -1) == NULL, 1);
+    check("aqi_category_desc past the last", s, num_categories,
+          aqi_category_desc(scale, num_categories) == NULL, 1);
+
+    for (int isa = 0; isa <= (int) best_isa; ++isa)
+    {
+      kernel_isa = (aqi_isa_t) isa;
+      snprintf(form, sizeof(form), "aqi_category_batch %s",
+               AQI_ISA_NAMES[isa]);
+      aqi_category_batch(scale, (size_t) n, values, out);
+      for (int i = 0; i < n; ++i)
+      {
+        check(form, s, i, out[i], aqi_category(scale, values[i]));
+      }
+    }
+    kernel_isa = best_isa;
+  }
+} // end check_categories
+
+int main(int argc, char **argv)
+{
+  int rounds = argc > 1 ? atoi(argv[1]) : 8;
+  best_isa = kernel_isa;
+
+  for (int k = 0; k < rounds; ++k)
+  {
+    generate(&round_data, k == 0, k % 2 == 1);
+    check_batch(&round_data);
+    check_all(&round_data);
+    check_raster(&round_data);
+    check_parallel(&round_data);
+    check_mixed(&round_data);
+    check_categories(&round_data);
+    check_views(&round_data);
+    check_masked(&round_data);
+    check_series(&round_data);
+    check_nowcast(&round_data);
+    if (round_data.exact)
+    {
+      check_state(&round_data);
+      check_prefix(&round_data);
+      check_minute_state(&round_data);
+    }
+  }
+
+  check_raster_saturation();
+
+  printf("forms: %ld checks, %ld failures\n", checks, failures);
+  return failures == 0 ? 0 : 1;
+} // end main
@@ -0,0 +1,111 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks the library built with AQI_HEADER_ONLY: calc_aqi_const() with every
+ * scale as a constant, and the calc_* function of every scale called directly,
+ * against calc_aqi() over random stations with some pollutants missing. An
+ * unknown scale gives 0.
+ *
+ * Build and run from the repository root, without aqi.c:
+ *   cc -O2 -I. test/aqi_header_only_test.c -lm -o aqi_header_only_test
+ *   ./aqi_header_only_test
+ *
+ * Exits with 0 if every result matches.
+ */
+
+#define AQI_HEADER_ONLY
+#include "aqi.h"
+
+#include <stdio.h>
+
+// Random stations to check
+#define NUM_STATIONS 20000
+
+static unsigned long long rng_state = 0x9e3779b97f4a7c15ull;
+
+static float rand_unit(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (float)(rng_state >> 40) / (float)(1 << 24);
+} // end rand_unit
+
+static long failures = 0;
+
+static void check(const char *form, int scale, int station, int got, int want)
+{
+  if (got != want && failures++ < 20)
+  {
+    printf("%s, scale %d, station %d: %d, calc_aqi() %d\n", form, scale,
+           station, got, want);
+  }
+} // end check
+
+#define STATION c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8]
+
+/* Checks calc_aqi_const() of a constant scale and the calc_* function of the
+ * scale against calc_aqi().
+ */
+#define CHECK_SCALE(scale, calc_fn)                                          \
+  do                                                                         \
+  {                                                                          \
+    int want = calc_aqi(scale, STATION);                                     \
+    check("calc_aqi_const", scale, i, calc_aqi_const(scale, STATION), want); \
+    check(#calc_fn, scale, i, calc_fn(STATION), want);                       \
+  } while (0)
+
+int main(void)
+{
+  static float samples[NUM_AQI_POLLUTANTS][24];
+  const float *c[NUM_AQI_POLLUTANTS];
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      float range = rand_unit() < 0.5f ? 100 : 1000;
+      for (int h = 0; h < 24; ++h)
+      {
+        samples[p][h] = rand_unit() * range;
+      }
+      c[p] = rand_unit() < 0.8f ? samples[p] : NULL;
+    }
+
+    CHECK_SCALE(AUSTRALIA_AQI,       calc_australia_aqi);
+    CHECK_SCALE(CANADA_AQHI,         calc_canada_aqhi);
+    CHECK_SCALE(CHINA_AQI,           calc_china_aqi);
+    CHECK_SCALE(EUROPEAN_UNION_CAQI, calc_european_union_caqi);
+    CHECK_SCALE(HONG_KONG_AQHI,      calc_hong_kong_aqhi);
+    CHECK_SCALE(INDIA_AQI,           calc_india_aqi);
+    CHECK_SCALE(SINGAPORE_PSI,       calc_singapore_psi);
+    CHECK_SCALE(SOUTH_KOREA_CAI,     calc_south_korea_cai);
+    CHECK_SCALE(UNITED_KINGDOM_DAQI, calc_united_kingdom_daqi);
+    CHECK_SCALE(UNITED_STATES_AQI,   calc_united_states_aqi);
+
+    // scale not known at compile time
+    aqi_scale_t scale = (aqi_scale_t)(i % NUM_AQI_SCALES);
+    check("calc_aqi_const, variable scale", scale, i,
+          calc_aqi_const(scale, STATION), calc_aqi(scale, STATION));
+  }
+  check("calc_aqi_const, unknown scale", NUM_AQI_SCALES, 0,
+        calc_aqi_const((aqi_scale_t) NUM_AQI_SCALES, STATION), 0);
+
+  printf("header-only: %ld failures\n", failures);
+  return failures == 0 ? 0 : 1;
+} // end main
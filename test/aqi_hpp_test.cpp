@@ -0,0 +1,339 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks aqi.hpp against the C library: the compile-time properties of every
+ * scale, and evaluate() and desc() in all their forms against per-station
+ * calc_aqi() and aqi_desc(), over random stations with some pollutants
+ * missing. aqi::views::hourly is checked against calc_aqi() of every 24 hour
+ * window of a long series; its samples are multiples of 0.25, so that the
+ * running sums it keeps are exact.
+ *
+ * Build and run from the repository root:
+ *   cc -O2 -c aqi.c -o aqi.o
+ *   c++ -std=c++20 -O2 -I. test/aqi_hpp_test.cpp aqi.o -lm -o aqi_hpp_test
+ *   ./aqi_hpp_test
+ *
+ * Exits with 0 if every result matches.
+ */
+
+#include "aqi.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ranges>
+#include <vector>
+
+static_assert(aqi::max_index<aqi::scale::australia> == AUSTRALIA_AQI_MAX);
+static_assert(aqi::max_index<aqi::scale::us> == UNITED_STATES_AQI_MAX);
+static_assert(aqi::desc_type<aqi::scale::canada> == CANADA_AQHI_DESC_TYPE);
+static_assert(aqi::desc_type<aqi::scale::china> == CHINA_AQI_DESC_TYPE);
+static_assert(aqi::to_c(aqi::scale::uk) == UNITED_KINGDOM_DAQI);
+static_assert(aqi::scale_traits<aqi::scale::singapore>::c_scale
+              == SINGAPORE_PSI);
+
+// Random stations per check
+#define NUM_STATIONS 2000
+
+static unsigned long long rng_state = 0x9e3779b97f4a7c15ull;
+
+static float rand_unit()
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (float)(rng_state >> 40) / (float)(1 << 24);
+} // end rand_unit
+
+static long failures = 0;
+
+static void fail(const char *what, int scale, int station, int got, int want)
+{
+  if (failures++ < 20)
+  {
+    std::printf("%s, scale %d, station %d: %d, calc_aqi() %d\n", what, scale,
+                station, got, want);
+  }
+} // end fail
+
+template <aqi::scale S>
+static int evaluate_template(const aqi::hourly &in)
+{
+  return aqi::evaluate<S>(in);
+} // end evaluate_template
+
+/* evaluate<S>() of every scale, indexed by aqi_scale_t.
+ */
+static int (*const EVALUATE[NUM_AQI_SCALES])(const aqi::hourly &) = {
+  evaluate_template<aqi::scale::australia>,
+  evaluate_template<aqi::scale::canada>,
+  evaluate_template<aqi::scale::china>,
+  evaluate_template<aqi::scale::eu>,
+  evaluate_template<aqi::scale::hong_kong>,
+  evaluate_template<aqi::scale::india>,
+  evaluate_template<aqi::scale::singapore>,
+  evaluate_template<aqi::scale::south_korea>,
+  evaluate_template<aqi::scale::uk>,
+  evaluate_template<aqi::scale::us>,
+};
+
+template <aqi::scale S>
+static void evaluate_batch_template(const aqi::columns &in,
+                                    std::span<int> out)
+{
+  aqi::evaluate<S>(in, out);
+} // end evaluate_batch_template
+
+static void (*const EVALUATE_BATCH[NUM_AQI_SCALES])(const aqi::columns &,
+                                                    std::span<int>) = {
+  evaluate_batch_template<aqi::scale::australia>,
+  evaluate_batch_template<aqi::scale::canada>,
+  evaluate_batch_template<aqi::scale::china>,
+  evaluate_batch_template<aqi::scale::eu>,
+  evaluate_batch_template<aqi::scale::hong_kong>,
+  evaluate_batch_template<aqi::scale::india>,
+  evaluate_batch_template<aqi::scale::singapore>,
+  evaluate_batch_template<aqi::scale::south_korea>,
+  evaluate_batch_template<aqi::scale::uk>,
+  evaluate_batch_template<aqi::scale::us>,
+};
+
+/* Returns samples[p] as the member of a station, or nothing if missing.
+ */
+static std::optional<aqi::hours> member(const float (*samples)[24],
+                                        const bool *present, int p)
+{
+  if (!present[p])
+  {
+    return std::nullopt;
+  }
+  return aqi::hours(samples[p], 24);
+} // end member
+
+static void check_hourly()
+{
+  for (int i = 0; i < NUM_STATIONS; ++i)
+  {
+    float samples[NUM_AQI_POLLUTANTS][24];
+    bool present[NUM_AQI_POLLUTANTS];
+    const float *c[NUM_AQI_POLLUTANTS];
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      present[p] = rand_unit() < 0.8f;
+      for (int h = 0; h < 24; ++h)
+      {
+        samples[p][h] = rand_unit() * 400;
+      }
+      c[p] = present[p] ? samples[p] : nullptr;
+    }
+    const aqi::hourly in{
+      .co    = member(samples, present, POLLUTANT_CO),
+      .nh3   = member(samples, present, POLLUTANT_NH3),
+      .no    = member(samples, present, POLLUTANT_NO),
+      .no2   = member(samples, present, POLLUTANT_NO2),
+      .o3    = member(samples, present, POLLUTANT_O3),
+      .pb    = member(samples, present, POLLUTANT_PB),
+      .so2   = member(samples, present, POLLUTANT_SO2),
+      .pm10  = member(samples, present, POLLUTANT_PM10),
+      .pm2_5 = member(samples, present, POLLUTANT_PM2_5),
+    };
+
+    for (int s = 0; s < NUM_AQI_SCALES; ++s)
+    {
+      int want = calc_aqi((aqi_scale_t) s, c[0], c[1], c[2], c[3], c[4],
+                          c[5], c[6], c[7], c[8]);
+      int got = EVALUATE[s](in);
+      if (got != want)
+      {
+        fail("evaluate<S>(hourly)", s, i, got, want);
+      }
+      got = aqi::evaluate((aqi::scale) s, in);
+      if (got != want)
+      {
+        fail("evaluate(scale, hourly)", s, i, got, want);
+      }
+      if (std::strcmp(aqi::desc((aqi::scale) s, want).data(),
+                      aqi_desc((aqi_scale_t) s, want)) != 0)
+      {
+        fail("desc(scale, value)", s, i, 0, 0);
+      }
+      if (s == UNITED_STATES_AQI
+          && std::strcmp(aqi::desc<aqi::scale::us>(want).data(),
+                         united_states_aqi_desc(want)) != 0)
+      {
+        fail("desc<S>(value)", s, i, 0, 0);
+      }
+    }
+  }
+} // end check_hourly
+
+static void check_columns()
+{
+  std::vector<float> col[NUM_AQI_POLLUTANTS];
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    col[p].resize(24 * NUM_STATIONS);
+    for (float &v : col[p])
+    {
+      v = rand_unit() * 400;
+    }
+  }
+  // nh3, no and pb are not available anywhere
+  const aqi::columns in{
+    .co = col[POLLUTANT_CO], .no2 = col[POLLUTANT_NO2],
+    .o3 = col[POLLUTANT_O3], .so2 = col[POLLUTANT_SO2],
+    .pm10 = col[POLLUTANT_PM10], .pm2_5 = col[POLLUTANT_PM2_5],
+  };
+
+  std::vector<int> out[3];
+  for (std::vector<int> &o : out)
+  {
+    o.resize(NUM_STATIONS);
+  }
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
+  {
+    EVALUATE_BATCH[s](in, out[0]);
+    aqi::evaluate((aqi::scale) s, in, out[1]);
+    aqi::evaluate((aqi::scale) s, in, out[2], nullptr);
+    for (int i = 0; i < NUM_STATIONS; ++i)
+    {
+      float station[NUM_AQI_POLLUTANTS][24];
+      for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+      {
+        for (int h = 0; h < 24; ++h)
+        {
+          station[p][h] = col[p][h * NUM_STATIONS + i];
+        }
+      }
+      int want = calc_aqi((aqi_scale_t) s, station[POLLUTANT_CO], nullptr,
+                          nullptr, station[POLLUTANT_NO2],
+                          station[POLLUTANT_O3], nullptr,
+                          station[POLLUTANT_SO2], station[POLLUTANT_PM10],
+                          station[POLLUTANT_PM2_5]);
+      const char *what[3] = {
+        "evaluate<S>(columns)", "evaluate(scale, columns)",
+        "evaluate(scale, columns, executor)"
+      };
+      for (int k = 0; k < 3; ++k)
+      {
+        if (out[k][i] != want)
+        {
+          fail(what[k], s, i, out[k][i], want);
+        }
+      }
+    }
+  }
+} // end check_columns
+
+// Hours in the series of check_views()
+#define SERIES_HOURS 500
+
+/* Checks the elements of a view of the first 'hours' hours of a series
+ * against calc_aqi() of each window.
+ */
+template <class View>
+static void check_view(const char *what, View &&view, int s, int hours,
+                       const std::vector<float> (&col)[NUM_AQI_POLLUTANTS],
+                       const bool *present)
+{
+  int t = 23;
+  for (int got : view)
+  {
+    const float *c[NUM_AQI_POLLUTANTS];
+    for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+    {
+      c[p] = present[p] ? col[p].data() + (t - 23) : nullptr;
+    }
+    int want = calc_aqi((aqi_scale_t) s, c[0], c[1], c[2], c[3], c[4], c[5],
+                        c[6], c[7], c[8]);
+    if (got != want)
+    {
+      fail(what, s, t, got, want);
+    }
+    ++t;
+  }
+  int want = hours < 24 ? 23 : hours;
+  if (t != want)
+  {
+    fail(what, s, -1, t - 23, want - 23);
+  }
+} // end check_view
+
+static void check_views()
+{
+  std::vector<float> col[NUM_AQI_POLLUTANTS];
+  bool present[NUM_AQI_POLLUTANTS];
+  for (int p = 0; p < NUM_AQI_POLLUTANTS; ++p)
+  {
+    present[p] = rand_unit() < 0.8f;
+    col[p].resize(SERIES_HOURS);
+    for (float &v : col[p])
+    {
+      v = present[p] ? std::round(rand_unit() * 1600) / 4 : 0;
+    }
+  }
+  std::vector<aqi::sample> series(SERIES_HOURS);
+  for (int t = 0; t < SERIES_HOURS; ++t)
+  {
+    series[t] = {
+      col[0][t], col[1][t], col[2][t], col[3][t], col[4][t], col[5][t],
+      col[6][t], col[7][t], col[8][t]
+    };
+  }
+
+  for (int s = 0; s < NUM_AQI_SCALES; ++s)
+  {
+    const aqi::scale sc = (aqi::scale) s;
+    auto view = series | aqi::views::hourly(sc);
+    if (view.size() != SERIES_HOURS - 23)
+    {
+      fail("views::hourly size", s, -1, (int) view.size(), SERIES_HOURS - 23);
+    }
+    check_view("views::hourly", view, s, SERIES_HOURS, col, present);
+    check_view("views::hourly(range, scale)",
+               aqi::views::hourly(series, sc), s, SERIES_HOURS, col,
+               present);
+
+    // samples made on the fly, so the view has a sentinel for an end
+    auto made = std::views::iota(0, SERIES_HOURS)
+                | std::views::transform([&](int t) { return series[t]; })
+                | std::views::take_while([](const aqi::sample &) {
+                    return true;
+                  });
+    check_view("views::hourly of a transform", made | aqi::views::hourly(sc),
+               s, SERIES_HOURS, col, present);
+
+    // ranges of 23 and 24 hours hold no window and one window
+    for (int hours = 23; hours <= 24; ++hours)
+    {
+      check_view("views::hourly of a short range",
+                 std::views::take(series, hours) | aqi::views::hourly(sc), s,
+                 hours, col, present);
+    }
+  }
+} // end check_views
+
+int main()
+{
+  check_hourly();
+  check_columns();
+  check_views();
+  std::printf("aqi.hpp: %ld failures\n", failures);
+  return failures == 0 ? 0 : 1;
+} // end main
@@ -0,0 +1,184 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks the table-driven breakpoint engine on every breakpoint table:
+ *
+ * - breakpoint_band() picks the band an if/else ladder over c_max would pick,
+ *   on and next to every threshold, on a sweep past the top of the table, and
+ *   for negative, infinite and NaN concentrations.
+ * - breakpoint_aqi() gives i_lo and i_hi at the ends of each band, 'over' off
+ *   the scale and for NaN, and never decreases as the concentration grows.
+ *
+ * Includes aqi.c to reach its tables. Build and run from the repository root:
+ *   cc -O2 -I. test/breakpoint_table_test.c -lm -o breakpoint_table_test
+ *   ./breakpoint_table_test
+ *
+ * Exits with 0 if every check passes.
+ */
+
+#include "aqi.c"
+
+#include <stdio.h>
+
+#define SWEEP_POINTS 100000
+
+#define TABLE(t) { #t, &(t) }
+
+static const struct {
+  const char               *name;
+  const breakpoint_table_t *table;
+} TABLES[] = {
+  TABLE(CHINA_AQI_CO_1H),
+  TABLE(CHINA_AQI_CO_24H),
+  TABLE(CHINA_AQI_NO2_1H),
+  TABLE(CHINA_AQI_NO2_24H),
+  TABLE(CHINA_AQI_O3_1H),
+  TABLE(CHINA_AQI_O3_8H),
+  TABLE(CHINA_AQI_SO2_1H),
+  TABLE(CHINA_AQI_SO2_24H),
+  TABLE(CHINA_AQI_PM10_24H),
+  TABLE(CHINA_AQI_PM2_5_24H),
+  TABLE(EUROPEAN_UNION_CAQI_NO2_1H),
+  TABLE(EUROPEAN_UNION_CAQI_O3_1H),
+  TABLE(EUROPEAN_UNION_CAQI_PM10_1H),
+  TABLE(EUROPEAN_UNION_CAQI_PM2_5_1H),
+  TABLE(INDIA_AQI_CO_8H),
+  TABLE(INDIA_AQI_NH3_24H),
+  TABLE(INDIA_AQI_NO2_24H),
+  TABLE(INDIA_AQI_O3_8H),
+  TABLE(INDIA_AQI_PB_24H),
+  TABLE(INDIA_AQI_SO2_24H),
+  TABLE(INDIA_AQI_PM10_24H),
+  TABLE(INDIA_AQI_PM2_5_24H),
+  TABLE(SINGAPORE_PSI_CO_8H),
+  TABLE(SINGAPORE_PSI_NO2_1H),
+  TABLE(SINGAPORE_PSI_O3),
+  TABLE(SINGAPORE_PSI_SO2_24H),
+  TABLE(SINGAPORE_PSI_PM10_24H),
+  TABLE(SINGAPORE_PSI_PM2_5_24H),
+  TABLE(SOUTH_KOREA_CAI_CO_1H),
+  TABLE(SOUTH_KOREA_CAI_NO2_1H),
+  TABLE(SOUTH_KOREA_CAI_O3_1H),
+  TABLE(SOUTH_KOREA_CAI_SO2_1H),
+  TABLE(SOUTH_KOREA_CAI_PM10_24H),
+  TABLE(SOUTH_KOREA_CAI_PM2_5_24H),
+  TABLE(UNITED_STATES_AQI_CO_8H),
+  TABLE(UNITED_STATES_AQI_NO2_1H),
+  TABLE(UNITED_STATES_AQI_O3_1H),
+  TABLE(UNITED_STATES_AQI_O3_8H),
+  TABLE(UNITED_STATES_AQI_SO2),
+  TABLE(UNITED_STATES_AQI_PM10_24H),
+  TABLE(UNITED_STATES_AQI_PM2_5_24H),
+};
+
+#define NUM_TABLES ((int)(sizeof(TABLES) / sizeof(TABLES[0])))
+
+static long failures = 0;
+
+/* The band of c found by walking the bands in order, as the if/else ladders
+ * of the scale functions did.
+ */
+static int ladder_band(const breakpoint_table_t *t, float c)
+{
+  for (int b = 0; b < t->num_bands; ++b)
+  {
+    if (t->inclusive ? c <= t->c_max[b] : c < t->c_max[b])
+    {
+      return b;
+    }
+  }
+  return t->num_bands;
+} // end ladder_band
+
+static void check_band(const char *name, const breakpoint_table_t *t, float c)
+{
+  int got = breakpoint_band(t, c);
+  int want = ladder_band(t, c);
+  if (got != want && failures++ < 20)
+  {
+    printf("%s: band of %.9g is %d, ladder %d\n", name, c, got, want);
+  }
+} // end check_band
+
+static void check_table(const char *name, const breakpoint_table_t *t)
+{
+  const float special[] = { 0, -0.f, -1, -1e30f, INFINITY, -INFINITY, NAN };
+  for (int k = 0; k < (int)(sizeof(special) / sizeof(special[0])); ++k)
+  {
+    check_band(name, t, special[k]);
+  }
+
+  for (int b = 0; b < t->num_bands; ++b)
+  {
+    const float edges[] = { (float) t->c_max[b], t->c_lo[b], t->c_hi[b] };
+    for (int k = 0; k < 3; ++k)
+    {
+      check_band(name, t, edges[k]);
+      check_band(name, t, nextafterf(edges[k], -INFINITY));
+      check_band(name, t, nextafterf(edges[k], INFINITY));
+    }
+
+    // the ends of a band give its ends of the index
+    if (breakpoint_band(t, t->c_lo[b]) == b
+        && breakpoint_aqi(t, t->c_lo[b]) != (int) t->i_lo[b]
+        && failures++ < 20)
+    {
+      printf("%s: band %d starts at %d, i_lo %g\n", name, b,
+             breakpoint_aqi(t, t->c_lo[b]), t->i_lo[b]);
+    }
+    if (breakpoint_band(t, t->c_hi[b]) == b
+        && breakpoint_aqi(t, t->c_hi[b]) != (int) t->i_hi[b]
+        && failures++ < 20)
+    {
+      printf("%s: band %d ends at %d, i_hi %g\n", name, b,
+             breakpoint_aqi(t, t->c_hi[b]), t->i_hi[b]);
+    }
+  }
+
+  float top = (float) t->c_max[t->num_bands - 1];
+  if ((breakpoint_aqi(t, top * 2 + 1) != t->over
+       || breakpoint_aqi(t, INFINITY) != t->over
+       || breakpoint_aqi(t, NAN) != t->over) && failures++ < 20)
+  {
+    printf("%s: off the scale is not %d\n", name, t->over);
+  }
+
+  int prev = breakpoint_aqi(t, 0);
+  for (int k = 0; k <= SWEEP_POINTS; ++k)
+  {
+    float c = top * 1.25f * k / SWEEP_POINTS;
+    check_band(name, t, c);
+    int aqi = breakpoint_aqi(t, c);
+    if (aqi < prev && failures++ < 20)
+    {
+      printf("%s: %d at %.9g, below %d just before\n", name, aqi, c, prev);
+    }
+    prev = aqi;
+  }
+} // end check_table
+
+int main(void)
+{
+  for (int i = 0; i < NUM_TABLES; ++i)
+  {
+    check_table(TABLES[i].name, TABLES[i].table);
+  }
+  printf("%d breakpoint tables, %ld failures\n", NUM_TABLES, failures);
+  return failures == 0 ? 0 : 1;
+} // end main
@@ -0,0 +1,193 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks the United Kingdom DAQI lookup tables against the DAQI thresholds:
+ * every entry must be the band of its own index, and each table must end at
+ * the first concentration of DAQI 10. Also checks that united_kingdom_daqi()
+ * rounds concentrations to the nearest integer (halves up) on both sides of
+ * every half, and, when built with -DAQI_FIXED_POINT, that
+ * united_kingdom_daqi_fixed() agrees with the thresholds for every hundredth.
+ *
+ * With -g, prints the lookup tables instead, in the layout of aqi.c. Run it
+ * after changing a threshold and paste the output over the old tables.
+ *
+ * Includes aqi.c to reach its tables. Build and run from the repository root:
+ *   cc -O2 -I. test/uk_daqi_lut_test.c -lm -o uk_daqi_lut_test
+ *   ./uk_daqi_lut_test [-g]
+ *
+ * Exits with 0 if every check passes.
+ */
+
+#include "aqi.c"
+
+#include <stdio.h>
+#include <string.h>
+
+#define LUT(lut) (lut), (int)(sizeof(lut) / sizeof((lut)[0]))
+
+typedef struct {
+  const char    *comment;
+  const char    *name;
+  const uint8_t *lut;
+  int            len;
+  int            lowest[9];
+} uk_lut_t;
+
+/* Lookup tables with the lowest concentration (μg/m^3, rounded to the nearest
+ * integer) of DAQI 2 to 10, from
+ * https://uk-air.defra.gov.uk/air-pollution/daqi?view=more-info. Same order as
+ * the parameters of united_kingdom_daqi().
+ */
+static const uk_lut_t UK_LUTS[] = {
+  { "// no2 (μg/m^3)", "UNITED_KINGDOM_DAQI_NO2_1H_LUT",
+    LUT(UNITED_KINGDOM_DAQI_NO2_1H_LUT),
+    { 68, 135, 201, 268, 335, 401, 468, 535, 601 } },
+  { "// o3 (μg/m^3)", "UNITED_KINGDOM_DAQI_O3_8H_LUT",
+    LUT(UNITED_KINGDOM_DAQI_O3_8H_LUT),
+    { 34, 67, 101, 121, 141, 161, 188, 214, 241 } },
+  { "// so2 (μg/m^3)", "UNITED_KINGDOM_DAQI_SO2_15MIN_LUT",
+    LUT(UNITED_KINGDOM_DAQI_SO2_15MIN_LUT),
+    { 89, 178, 267, 355, 444, 533, 711, 888, 1065 } },
+  { "// pm10 (μg/m^3)", "UNITED_KINGDOM_DAQI_PM10_24H_LUT",
+    LUT(UNITED_KINGDOM_DAQI_PM10_24H_LUT),
+    { 17, 34, 51, 59, 67, 76, 84, 92, 101 } },
+  { "// pm2_5 (μg/m^3)", "UNITED_KINGDOM_DAQI_PM2_5_24H_LUT",
+    LUT(UNITED_KINGDOM_DAQI_PM2_5_24H_LUT),
+    { 12, 24, 36, 42, 48, 54, 59, 65, 71 } },
+};
+
+#define NUM_UK_LUTS ((int)(sizeof(UK_LUTS) / sizeof(UK_LUTS[0])))
+
+/* Returns the DAQI of rounded concentration c from the thresholds.
+ */
+static int band(const uk_lut_t *t, long c)
+{
+  int daqi = 1;
+  for (int b = 0; b < 9; ++b)
+  {
+    daqi += (c >= t->lowest[b]);
+  }
+  return daqi;
+} // end band
+
+/* Returns united_kingdom_daqi() with every other pollutant at 0.
+ */
+static int daqi_of(int p, float c)
+{
+  float v[NUM_UK_LUTS] = { 0 };
+  v[p] = c;
+  return united_kingdom_daqi(v[0], v[1], v[2], v[3], v[4]);
+} // end daqi_of
+
+static void print_lut(const uk_lut_t *t)
+{
+  int len = t->lowest[8] + 1;
+  printf("%s\nstatic const uint8_t %s[%d] = {\n", t->comment, t->name, len);
+  for (int k = 0; k < len; ++k)
+  {
+    printf("%s%2d,%s", k % 18 == 0 ? "  " : "", band(t, k),
+           k % 18 == 17 || k == len - 1 ? "\n" : " ");
+  }
+  printf("};\n");
+} // end print_lut
+
+static long check_lut(int p)
+{
+  const uk_lut_t *t = &UK_LUTS[p];
+  long failures = 0;
+
+  if (t->len != t->lowest[8] + 1)
+  {
+    printf("%s: %d entries, DAQI 10 starts at %d\n", t->name, t->len,
+           t->lowest[8]);
+    ++failures;
+  }
+  for (int k = 0; k < t->len; ++k)
+  {
+    if (t->lut[k] != band(t, k) && failures++ < 5)
+    {
+      printf("%s[%d] = %d, threshold DAQI %d\n", t->name, k, t->lut[k],
+             band(t, k));
+    }
+  }
+
+  // both sides of every half, e.g. 67.5 rounds to 68
+  for (int k = -2; k < 2 * t->len; ++k)
+  {
+    float half = k + 0.5f;
+    float below = nextafterf(half, -INFINITY);
+    if (daqi_of(p, half) != band(t, k + 1) && failures++ < 5)
+    {
+      printf("%s: DAQI of %.9g is %d, threshold DAQI %d\n", t->name, half,
+             daqi_of(p, half), band(t, k + 1));
+    }
+    if (daqi_of(p, below) != band(t, k) && failures++ < 5)
+    {
+      printf("%s: DAQI of %.9g is %d, threshold DAQI %d\n", t->name, below,
+             daqi_of(p, below), band(t, k));
+    }
+  }
+  if (daqi_of(p, 1e30f) != 10 || daqi_of(p, INFINITY) != 10
+      || daqi_of(p, NAN) != 1)
+  {
+    printf("%s: wrong DAQI of 1e30, inf or NaN\n", t->name);
+    ++failures;
+  }
+
+#ifdef AQI_FIXED_POINT
+  for (aqi_fixed_t c = -200; c < 200 * t->len; ++c)
+  {
+    aqi_fixed_t v[NUM_UK_LUTS] = { 0 };
+    v[p] = c;
+    int daqi = united_kingdom_daqi_fixed(v[0], v[1], v[2], v[3], v[4]);
+    int want = band(t, c >= 0 ? (c + 50) / 100 : 0);
+    if (daqi != want && failures++ < 5)
+    {
+      printf("%s: fixed DAQI of %ld is %d, threshold DAQI %d\n", t->name,
+             (long) c, daqi, want);
+    }
+  }
+#endif
+
+  printf("%s: %d entries, %ld failures\n", t->name, t->len, failures);
+  return failures;
+} // end check_lut
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && strcmp(argv[1], "-g") == 0)
+  {
+    for (int p = 0; p < NUM_UK_LUTS; ++p)
+    {
+      if (p > 0)
+      {
+        printf("\n");
+      }
+      print_lut(&UK_LUTS[p]);
+    }
+    return 0;
+  }
+
+  long failures = 0;
+  for (int p = 0; p < NUM_UK_LUTS; ++p)
+  {
+    failures += check_lut(p);
+  }
+  return failures == 0 ? 0 : 1;
+} // end main
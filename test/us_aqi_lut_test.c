@@ -0,0 +1,140 @@
+/* Tests for pollutant-concentration-to-aqi.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/* Checks the United States AQI lookup tables against the breakpoint tables
+ * they were generated from: every entry must equal the table-driven sub-index
+ * of its own index (united_states_aqi_*_sub()), and where the last entry
+ * covers everything above, the sub-index of every index past the table must
+ * equal it.
+ *
+ * With -g, prints the lookup tables instead, in the layout of aqi.c. Run it
+ * after changing a breakpoint table and paste the output over the old tables.
+ *
+ * Includes aqi.c to reach its tables. Build and run from the repository root:
+ *   cc -O2 -I. test/us_aqi_lut_test.c -lm -o us_aqi_lut_test
+ *   ./us_aqi_lut_test [-g]
+ *
+ * Exits with 0 if every entry matches.
+ */
+
+#include "aqi.c"
+
+#include <stdio.h>
+#include <string.h>
+
+#define LUT(lut) (lut), (int)(sizeof(lut) / sizeof((lut)[0]))
+
+/* How far past the end of a table to check that its last entry covers
+ * everything above, as a multiple of its length.
+ */
+#define TAIL_FACTOR 4
+
+typedef struct {
+  const char     *comment;
+  const char     *name;
+  const uint16_t *lut;
+  int             len;
+  int           (*sub)(float);
+  int             covers_above;
+} us_lut_t;
+
+static const us_lut_t US_LUTS[] = {
+  { "// co (0.1 ppm), the last entry covers everything above",
+    "UNITED_STATES_AQI_CO_8H_LUT", LUT(UNITED_STATES_AQI_CO_8H_LUT),
+    united_states_aqi_co_sub, 1 },
+  { "// no2 (ppb), the last entry covers everything above",
+    "UNITED_STATES_AQI_NO2_1H_LUT", LUT(UNITED_STATES_AQI_NO2_1H_LUT),
+    united_states_aqi_no2_sub, 1 },
+  { "// o3 1 hour (0.001 ppm), 0 below 0.125 ppm",
+    "UNITED_STATES_AQI_O3_1H_LUT", LUT(UNITED_STATES_AQI_O3_1H_LUT),
+    united_states_aqi_o3_1h_sub, 0 },
+  { "// o3 8 hour (0.001 ppm), 0 above 0.200 ppm",
+    "UNITED_STATES_AQI_O3_8H_LUT", LUT(UNITED_STATES_AQI_O3_8H_LUT),
+    united_states_aqi_o3_8h_sub, 1 },
+  { "// so2 1 hour (ppb), only used up to 185 ppb",
+    "UNITED_STATES_AQI_SO2_1H_LUT", LUT(UNITED_STATES_AQI_SO2_1H_LUT),
+    united_states_aqi_so2_1h_sub, 0 },
+  { "// pm10 (μg/m^3), the last entry covers everything above",
+    "UNITED_STATES_AQI_PM10_24H_LUT", LUT(UNITED_STATES_AQI_PM10_24H_LUT),
+    united_states_aqi_pm10_sub, 1 },
+  { "// pm2_5 (0.1 μg/m^3), the last entry covers everything above",
+    "UNITED_STATES_AQI_PM2_5_24H_LUT", LUT(UNITED_STATES_AQI_PM2_5_24H_LUT),
+    united_states_aqi_pm2_5_sub, 1 },
+};
+
+#define NUM_US_LUTS ((int)(sizeof(US_LUTS) / sizeof(US_LUTS[0])))
+
+static void print_lut(const us_lut_t *t)
+{
+  printf("%s\nstatic const uint16_t %s[%d] = {\n", t->comment, t->name,
+         t->len);
+  for (int k = 0; k < t->len; ++k)
+  {
+    printf("%s%3d,%s", k % 16 == 0 ? "  " : "", t->sub((float) k),
+           k % 16 == 15 || k == t->len - 1 ? "\n" : " ");
+  }
+  printf("};\n");
+} // end print_lut
+
+static long check_lut(const us_lut_t *t)
+{
+  long failures = 0;
+  for (int k = 0; k < t->len; ++k)
+  {
+    int sub = t->sub((float) k);
+    if (t->lut[k] != sub && failures++ < 5)
+    {
+      printf("%s[%d] = %d, sub-index %d\n", t->name, k, t->lut[k], sub);
+    }
+  }
+  for (int k = t->len; t->covers_above && k < TAIL_FACTOR * t->len; ++k)
+  {
+    int sub = t->sub((float) k);
+    if (t->lut[t->len - 1] != sub && failures++ < 5)
+    {
+      printf("%s: last entry %d, sub-index of %d is %d\n", t->name,
+             t->lut[t->len - 1], k, sub);
+    }
+  }
+  printf("%s: %d entries, %ld failures\n", t->name, t->len, failures);
+  return failures;
+} // end check_lut
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && strcmp(argv[1], "-g") == 0)
+  {
+    for (int i = 0; i < NUM_US_LUTS; ++i)
+    {
+      if (i > 0)
+      {
+        printf("\n");
+      }
+      print_lut(&US_LUTS[i]);
+    }
+    return 0;
+  }
+
+  long failures = 0;
+  for (int i = 0; i < NUM_US_LUTS; ++i)
+  {
+    failures += check_lut(&US_LUTS[i]);
+  }
+  return failures == 0 ? 0 : 1;
+} // end main